@@ -0,0 +1,43 @@
+#include <stddef.h>
+#include "bench_alloc.h"
+
+// Implementaciones internas de glibc; no dependen de dlsym
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static BenchAllocStats stats;
+
+void* malloc(size_t size) {
+    stats.reservas++;
+    stats.bytes += size;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+    stats.reservas++;
+    stats.bytes += n * size;
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    stats.reservas++;
+    stats.bytes += size;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    if (ptr) stats.liberaciones++;
+    __libc_free(ptr);
+}
+
+void bench_alloc_reset(void) {
+    stats.reservas = 0;
+    stats.liberaciones = 0;
+    stats.bytes = 0;
+}
+
+BenchAllocStats bench_alloc_stats(void) {
+    return stats;
+}
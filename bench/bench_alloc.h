@@ -0,0 +1,19 @@
+#ifndef BENCH_ALLOC_H
+#define BENCH_ALLOC_H
+
+#include <stddef.h>
+
+// Contador de reservas para los benchmarks
+// bench_alloc.c reemplaza malloc/calloc/realloc/free del proceso y delega en
+// las versiones de glibc, así que cuenta también las reservas de src/.
+
+typedef struct {
+    size_t reservas;        // malloc + calloc + realloc
+    size_t liberaciones;
+    size_t bytes;           // Bytes pedidos
+} BenchAllocStats;
+
+void bench_alloc_reset(void);
+BenchAllocStats bench_alloc_stats(void);
+
+#endif // BENCH_ALLOC_H
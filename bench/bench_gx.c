@@ -0,0 +1,362 @@
+// Suite de microbenchmarks de GLX
+// Uso: bench_gx [filtro] [max_lineas]
+// Mide lexer, parser, intérprete (con el backend de knobs nulo), carga de
+// modelo.txt, fuzzy matching, el colector de estado y los sensores de .gx
+// (con y sin caché) sobre entradas
+// sintéticas de 10 a 100 000 líneas. Con GLX_SIM también mide "run mode"
+// y status de punta a punta contra el hardware simulado, con y sin la
+// sesión de "gx shell", y un lote de knobs de cpufreq. Imprime un objeto JSON por caso en
+// stdout para poder comparar commits:
+//   {"bench":"parser","lineas":1000,"ops":..,"ns_op":..,"reservas_op":..,"rss_pico_kib":..}
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../include/lexer.h"
+#include "../include/parser.h"
+#include "../include/arena.h"
+#include "../include/interpreter.h"
+#include "../include/knobs.h"
+#include "../include/status.h"
+#include "../include/salida.h"
+#include "../include/utils.h"
+#include "../include/sim.h"
+#include "../include/sensores.h"
+#include "../include/cpufreq.h"
+#include "bench_alloc.h"
+
+// Cada caso se repite hasta juntar al menos este tiempo
+#define BENCH_TIEMPO_MIN_S 0.2
+
+static const int tamanos[] = {10, 100, 1000, 10000, 100000};
+#define NUM_TAMANOS (int)(sizeof(tamanos) / sizeof(tamanos[0]))
+
+static const char* filtro = NULL;
+static int max_lineas = 100000;
+
+static double ahora_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Reiniciar el pico de RSS del proceso (VmHWM); 0 si el kernel no lo permite
+static int reiniciar_rss_pico(void) {
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+    if (!f) return 0;
+    int ok = fputs("5", f) >= 0;
+    return (fclose(f) == 0) && ok;
+}
+
+static long rss_pico_kib(void) {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (f) {
+        char linea[128];
+        while (fgets(linea, sizeof(linea), f)) {
+            if (strncmp(linea, "VmHWM:", 6) == 0) {
+                fclose(f);
+                return atol(linea + 6);
+            }
+        }
+        fclose(f);
+    }
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+typedef void (*BenchFn)(void* ctx);
+
+// Repetir fn hasta BENCH_TIEMPO_MIN_S y emitir el resultado del caso
+static void medir(const char* nombre, int lineas, BenchFn fn, void* ctx) {
+    if (filtro && !strstr(nombre, filtro)) return;
+
+    reiniciar_rss_pico();
+    fn(ctx);    // Calentamiento (cachés, índices que se arman una vez)
+
+    long ops = 0;
+    bench_alloc_reset();
+    double inicio = ahora_s();
+    double transcurrido;
+    do {
+        fn(ctx);
+        ops++;
+        transcurrido = ahora_s() - inicio;
+    } while (transcurrido < BENCH_TIEMPO_MIN_S);
+    BenchAllocStats reservas = bench_alloc_stats();
+
+    printf("{\"bench\":\"%s\",\"lineas\":%d,\"ops\":%ld,\"ns_op\":%.1f,\"reservas_op\":%.2f,\"rss_pico_kib\":%ld}\n",
+           nombre, lineas, ops, transcurrido * 1e9 / ops, (double)reservas.reservas / ops, rss_pico_kib());
+    fflush(stdout);
+}
+
+// Script .gx sintético: variables únicas (el intérprete no pregunta por
+// redefiniciones), declaraciones, comentarios y un "run" cada 64 líneas
+static char* generar_script(int lineas, size_t* len) {
+    size_t capacidad = (size_t)lineas * 40 + 1;
+    char* script = malloc(capacidad);
+    char* p = script;
+    char* fin = script + capacidad;
+    for (int i = 0; i < lineas; i++) {
+        int k = i / 8;
+        if (i % 64 == 63) {
+            p += snprintf(p, fin - p, "run mode: balanced\n");
+            continue;
+        }
+        switch (i % 8) {
+            case 0: p += snprintf(p, fin - p, "v%d = %d\n", k, k % 101); break;
+            case 1: p += snprintf(p, fin - p, "cpu_max_perf: v%d\n", k); break;
+            case 2: p += snprintf(p, fin - p, "cpu_min_perf: %d\n", k % 101); break;
+            case 3: p += snprintf(p, fin - p, "nombre_%d = \"perfil %d\"\n", k, k); break;
+            case 4: p += snprintf(p, fin - p, "turbo_boost: %d\n", k % 2); break;
+            case 5: p += snprintf(p, fin - p, "dynamic_boost: %d\n", k % 2); break;
+            case 6: p += snprintf(p, fin - p, "# comentario %d\n", k); break;
+            default: p += snprintf(p, fin - p, "rgb_brightness: %d\n", k % 101); break;
+        }
+    }
+    *len = p - script;
+    return script;
+}
+
+// modelo.txt sintético: 10 modos (el máximo que carga GLX) con las líneas
+// de parámetros repartidas entre ellos
+static char* generar_modelo(int lineas) {
+    static const char* params[] = {
+        "dynamic_boost: 1", "cpu_max_perf: 80", "cpu_min_perf: 40",
+        "turbo_boost: 0", "persist_mode: 1", "battery_conservation: 0",
+        "fnlock: 1", "rgb_color: white", "rgb_brightness: 60",
+    };
+    char* ruta = strdup("/tmp/glx_bench_modelo_XXXXXX");
+    int fd = mkstemp(ruta);
+    FILE* f = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!f) {
+        free(ruta);
+        return NULL;
+    }
+    int por_modo = lineas / 10 > 1 ? lineas / 10 : 1;
+    for (int i = 0; i < lineas; i++) {
+        if (i % por_modo == 0) fprintf(f, "mode: modo_%d\n", i / por_modo);
+        else fprintf(f, "- %s\n", params[i % 9]);
+    }
+    fclose(f);
+    return ruta;
+}
+
+typedef struct {
+    const char* script;
+    size_t len;
+    Token* tokens;
+    int num_tokens;
+    AST* ast;
+    Arena arena;
+} CasoScript;
+
+static void bench_lexer(void* ctx) {
+    CasoScript* c = ctx;
+    Arena arena;
+    arena_init(&arena);
+    int n;
+    Token* tokens = lexer_tokenize(c->script, c->len, &n, &arena);
+    liberar_tokens(tokens, n);
+    arena_liberar(&arena);
+}
+
+static void bench_parser(void* ctx) {
+    CasoScript* c = ctx;
+    Arena arena;
+    arena_init(&arena);
+    parser_parse(c->tokens, c->num_tokens, &arena);
+    arena_liberar(&arena);
+}
+
+static void bench_interprete(void* ctx) {
+    CasoScript* c = ctx;
+    interpret_reiniciar();
+    interpret_ast(c->ast);
+}
+
+typedef struct {
+    const char* ruta;
+} CasoModelo;
+
+static void bench_modelo(void* ctx) {
+    CasoModelo* c = ctx;
+    int n;
+    free(load_gpu_modes_ex(c->ruta, &n, 0));
+}
+
+typedef struct {
+    const char** vocabulario;
+    int cantidad;
+    const char** consultas;
+    int num_consultas;
+} CasoFuzzy;
+
+static void bench_levenshtein(void* ctx) {
+    CasoFuzzy* c = ctx;
+    static volatile int sumidero;
+    for (int i = 0; i < c->num_consultas; i++) {
+        sumidero += levenshtein(c->consultas[i], c->vocabulario[i % c->cantidad]);
+    }
+}
+
+static void bench_sugerir(void* ctx) {
+    CasoFuzzy* c = ctx;
+    static volatile int sumidero;
+    for (int i = 0; i < c->num_consultas; i++) {
+        sumidero += sugerir_palabra(c->consultas[i], c->vocabulario, c->cantidad, 2) != NULL;
+    }
+}
+
+static void bench_status(void* ctx) {
+    (void)ctx;
+    SystemStatus status;
+    status_recolectar(&status);
+}
+
+static void bench_sampler(void* ctx) {
+    SystemStatus status;
+    status_sampler_leer(ctx, &status);
+}
+
+// Un uso de sensor:mem_available_kb (con TTL 0 cada uso relee /proc/meminfo)
+static void bench_sensor(void* ctx) {
+    (void)ctx;
+    static volatile int sumidero;
+    sumidero += sensor_leer(sensor_buscar("mem_available_kb"), NULL) != NULL;
+}
+
+// Alternar entre dos modos para que cada aplicación cambie todos los knobs
+static void bench_run_modo(void* ctx) {
+    (void)ctx;
+    static int vuelta = 0;
+    ejecutar_modo(vuelta++ % 2 ? "quiet" : "performance");
+}
+
+// Lote con los ocho knobs de cpufreq; cada uno escribe todas las policies de
+// su clase (sim/glx-sim crear DIR --cpus=P:E para probar con muchas)
+static void bench_cpufreq(void* ctx) {
+    (void)ctx;
+    static int vuelta = 0;
+    int alto = vuelta++ % 2;
+    KnobWrite writes[8];
+    knob_write_init(&writes[0], KNOB_CPU_GOVERNOR_P, alto ? "performance" : "powersave");
+    knob_write_init(&writes[1], KNOB_CPU_GOVERNOR_E, alto ? "performance" : "powersave");
+    knob_write_init(&writes[2], KNOB_CPU_EPP_P, alto ? "performance" : "balance_power");
+    knob_write_init(&writes[3], KNOB_CPU_EPP_E, alto ? "performance" : "power");
+    knob_write_init_int(&writes[4], KNOB_CPU_MAX_FREQ_P, alto ? 4500 : 3000);
+    knob_write_init_int(&writes[5], KNOB_CPU_MAX_FREQ_E, alto ? 3300 : 2000);
+    knob_write_init_int(&writes[6], KNOB_CPU_MIN_FREQ_P, alto ? 2000 : 800);
+    knob_write_init_int(&writes[7], KNOB_CPU_MIN_FREQ_E, alto ? 1200 : 400);
+    knobs_aplicar(writes, 8);
+}
+
+// Vocabulario sintético de n palabras; queda vivo todo el proceso porque
+// sugerir_palabra indexa cada lista una sola vez
+static const char** generar_vocabulario(int n) {
+    static const char* raices[] = {"cpu", "gpu", "perf", "boost", "turbo", "modo", "fan", "rgb"};
+    const char** lista = malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        char palabra[48];
+        snprintf(palabra, sizeof(palabra), "%s_%s_%d", raices[i % 8], raices[(i / 8) % 8], i);
+        lista[i] = strdup(palabra);
+    }
+    return lista;
+}
+
+// Consultas con un error de tipeo (se cambia una letra)
+static const char** generar_consultas(const char** vocabulario, int cantidad, int n) {
+    const char** consultas = malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        char* q = strdup(vocabulario[(i * 7919) % cantidad]);
+        q[i % strlen(q)] = 'x';
+        consultas[i] = q;
+    }
+    return consultas;
+}
+
+int main(int argc, char* argv[]) {
+    filtro = argc > 1 && strcmp(argv[1], "all") != 0 ? argv[1] : NULL;
+    max_lineas = argc > 2 ? atoi(argv[2]) : 100000;
+
+    // El intérprete corre en silencio y sin tocar el hardware
+    salida_opcion("-q");
+    knobs_set_nulo(1);
+
+    for (int t = 0; t < NUM_TAMANOS && tamanos[t] <= max_lineas; t++) {
+        int lineas = tamanos[t];
+        CasoScript c;
+        c.script = generar_script(lineas, &c.len);
+        arena_init(&c.arena);
+        c.tokens = lexer_tokenize(c.script, c.len, &c.num_tokens, &c.arena);
+        c.ast = parser_parse(c.tokens, c.num_tokens, &c.arena);
+
+        medir("lexer", lineas, bench_lexer, &c);
+        medir("parser", lineas, bench_parser, &c);
+        medir("interprete", lineas, bench_interprete, &c);
+
+        liberar_tokens(c.tokens, c.num_tokens);
+        arena_liberar(&c.arena);
+        free((char*)c.script);
+
+        CasoModelo m = { generar_modelo(lineas) };
+        if (m.ruta) {
+            medir("load_gpu_modes", lineas, bench_modelo, &m);
+            unlink(m.ruta);
+            free((char*)m.ruta);
+        }
+
+        CasoFuzzy f;
+        f.cantidad = lineas;
+        f.vocabulario = generar_vocabulario(lineas);
+        f.num_consultas = 100;
+        f.consultas = generar_consultas(f.vocabulario, f.cantidad, f.num_consultas);
+        medir("levenshtein", lineas, bench_levenshtein, &f);
+        medir("sugerir_palabra", lineas, bench_sugerir, &f);
+    }
+
+    // El colector de estado no depende del tamaño de la entrada
+    medir("status_recolectar", 0, bench_status, NULL);
+    StatusSampler sampler;
+    status_sampler_abrir(&sampler);
+    medir("status_sampler", 0, bench_sampler, &sampler);
+    status_sampler_cerrar(&sampler);
+    medir("sensor_cache", 0, bench_sensor, NULL);
+    sensores_set_ttl(0);
+    medir("sensor_sin_cache", 0, bench_sensor, NULL);
+    sensores_reiniciar();
+
+    // De punta a punta contra el hardware simulado (GLX_SIM=DIR, ver sim/glx-sim)
+    const char* sim_dir = getenv("GLX_SIM");
+    if (sim_dir && *sim_dir && sim_activar(sim_dir) == 0) {
+        knobs_set_nulo(0);
+        medir("run_modo_sim", 0, bench_run_modo, NULL);
+        medir("status_sim", 0, bench_status, NULL);
+        if (cpufreq_num_policies(CPUFREQ_CLASE_P) > 0) {
+            medir("cpufreq_sim", 0, bench_cpufreq, NULL);
+        }
+
+        // Lo mismo dentro de una sesión de "gx shell": caché de modos mapeada
+        // y atributos de los knobs y fuentes de status abiertos
+        StatusSampler sampler_sesion;
+        status_sampler_abrir(&sampler_sesion);
+        jmp_buf recuperacion;
+        if (setjmp(recuperacion) == 0) {
+            interpret_set_sesion(&recuperacion);
+            knobs_sesion_abrir();
+            status_usar_sampler(&sampler_sesion);
+            medir("run_modo_sim_sesion", 0, bench_run_modo, NULL);
+            medir("status_sim_sesion", 0, bench_status, NULL);
+        }
+        interpret_set_sesion(NULL);
+        knobs_sesion_cerrar();
+        status_usar_sampler(NULL);
+        status_sampler_cerrar(&sampler_sesion);
+    }
+
+    return 0;
+}
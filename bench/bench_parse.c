@@ -0,0 +1,109 @@
+// Benchmark del lexer y el parser sobre un .gx grande
+// Uso: bench_parse [lineas] [repeticiones] [archivo.gx]
+// Sin archivo genera un script sintético con una mezcla de sentencias.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/lexer.h"
+#include "../include/parser.h"
+#include "../include/arena.h"
+#include "bench_alloc.h"
+
+static char* generar_script(int lineas, size_t* len) {
+    static const char* plantillas[] = {
+        "perf_%d = %d\n",
+        "cpu_max_perf: perf_%d # %d\n",
+        "cpu_min_perf: %d%.0d\n",
+        "descripcion_%d = \"perfil generado %d\"\n",
+        "turbo_boost: %d%.0d\n",
+        "- dynamic_boost: %d%.0d\n",
+        "run mode: balanced%.0d%.0d\n",
+        "# comentario %d %d\n",
+    };
+    size_t capacidad = (size_t)lineas * 48 + 1;
+    char* script = malloc(capacidad);
+    size_t usado = 0;
+    for (int i = 0; i < lineas; i++) {
+        const char* p = plantillas[i % (sizeof(plantillas) / sizeof(plantillas[0]))];
+        usado += snprintf(script + usado, capacidad - usado, p, i % 101, i % 2);
+    }
+    *len = usado;
+    return script;
+}
+
+static char* leer_archivo(const char* ruta, size_t* len) {
+    FILE* f = fopen(ruta, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long tam = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* datos = malloc(tam + 1);
+    *len = fread(datos, 1, tam, f);
+    fclose(f);
+    return datos;
+}
+
+static double ahora_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int comparar(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char* argv[]) {
+    int lineas = argc > 1 ? atoi(argv[1]) : 100000;
+    int repeticiones = argc > 2 ? atoi(argv[2]) : 10;
+    if (repeticiones < 1) repeticiones = 1;
+
+    size_t len;
+    char* script = argc > 3 ? leer_archivo(argv[3], &len) : generar_script(lineas, &len);
+    if (!script) {
+        fprintf(stderr, "No se pudo leer %s\n", argv[3]);
+        return 1;
+    }
+
+    // Las advertencias del parser no interesan aquí
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+
+    double* tiempos = malloc(repeticiones * sizeof(double));
+    BenchAllocStats reservas = {0};
+    int num_tokens = 0;
+    uint32_t num_nodos = 0;
+    size_t bytes_arena = 0;
+
+    for (int r = 0; r < repeticiones; r++) {
+        bench_alloc_reset();
+        double inicio = ahora_s();
+
+        Arena arena;
+        arena_init(&arena);
+        Token* tokens = lexer_tokenize(script, len, &num_tokens, &arena);
+        AST* ast = parser_parse(tokens, num_tokens, &arena);
+        num_nodos = ast->num_nodos;
+        bytes_arena = arena.reservado;
+        liberar_tokens(tokens, num_tokens);
+        arena_liberar(&arena);
+
+        tiempos[r] = ahora_s() - inicio;
+        reservas = bench_alloc_stats();
+    }
+
+    qsort(tiempos, repeticiones, sizeof(double), comparar);
+    double mediana = tiempos[repeticiones / 2];
+
+    fprintf(stderr, "bench_parse: %zu bytes, %d tokens, %u nodos\n", len, num_tokens, num_nodos);
+    fprintf(stderr, "  tiempo (mediana de %d): %.3f ms  (%.1f ns/token)\n",
+            repeticiones, mediana * 1e3, mediana * 1e9 / (num_tokens ? num_tokens : 1));
+    fprintf(stderr, "  reservas por parse: %zu (liberaciones: %zu), arena: %zu KiB\n",
+            reservas.reservas, reservas.liberaciones, bytes_arena / 1024);
+
+    free(tiempos);
+    free(script);
+    return 0;
+}
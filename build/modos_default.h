@@ -0,0 +1,40 @@
+// Generado por tools/gen_modos.c desde modelo.txt. No editar.
+#ifndef MODOS_DEFAULT_H
+#define MODOS_DEFAULT_H
+
+#define NUM_MODOS_DEFAULT 3
+
+static const GPU_Mode modos_default[NUM_MODOS_DEFAULT] = {
+    { "quiet", {
+        [PARAM_dynamic_boost] = 0,
+        [PARAM_cpu_max_perf] = 60,
+        [PARAM_cpu_min_perf] = 20,
+        [PARAM_turbo_boost] = 1,
+        [PARAM_persist_mode] = 1,
+        [PARAM_battery_conservation] = 1,
+        [PARAM_fnlock] = 0,
+        [PARAM_rgb_brightness] = 30
+    }, "blue", 0x1ffull },
+    { "balanced", {
+        [PARAM_dynamic_boost] = 1,
+        [PARAM_cpu_max_perf] = 80,
+        [PARAM_cpu_min_perf] = 40,
+        [PARAM_turbo_boost] = 0,
+        [PARAM_persist_mode] = 1,
+        [PARAM_battery_conservation] = 0,
+        [PARAM_fnlock] = 1,
+        [PARAM_rgb_brightness] = 60
+    }, "white", 0x1ffull },
+    { "performance", {
+        [PARAM_dynamic_boost] = 1,
+        [PARAM_cpu_max_perf] = 100,
+        [PARAM_cpu_min_perf] = 60,
+        [PARAM_turbo_boost] = 0,
+        [PARAM_persist_mode] = 1,
+        [PARAM_battery_conservation] = 0,
+        [PARAM_fnlock] = 1,
+        [PARAM_rgb_brightness] = 100
+    }, "red", 0x1ffull },
+};
+
+#endif // MODOS_DEFAULT_H
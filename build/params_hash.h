@@ -0,0 +1,14 @@
+// Generado por tools/gen_params_hash.c desde include/params.def. No editar.
+#ifndef PARAMS_HASH_H
+#define PARAMS_HASH_H
+
+#define PARAM_HASH_SEMILLA 65u
+#define PARAM_HASH_MASCARA 31u
+#define PARAM_TABLA_HUELLA 0x6a223863b71f820eull
+
+static const int16_t param_hash_slots[32] = {
+    3, 1, 8, 16, -1, 19, -1, 18, 10, 12, -1, -1, 7, 14, -1, 17,
+    -1, -1, 2, 0, 9, 6, 15, -1, -1, -1, 11, -1, 13, 5, 4, -1
+};
+
+#endif // PARAMS_HASH_H
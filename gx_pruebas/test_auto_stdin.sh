@@ -0,0 +1,70 @@
+#!/bin/bash
+# Prueba de las reglas de gx auto con eventos escritos a mano (--stdin)
+# Uso: gx_pruebas/test_auto_stdin.sh   (después de make; no necesita root)
+#
+# Verifica que un modo mal escrito se rechaza al cargar auto.conf y que cada
+# regla de proceso cuenta sus PIDs: con varios procesos de la misma regla o
+# de reglas distintas vivos a la vez, el modo solo cambia cuando termina el
+# último de la regla que manda.
+
+cd "$(dirname "$0")/.." || exit 1
+DIR="$(mktemp -d)"
+trap 'rm -rf "$DIR"' EXIT
+fallas=0
+
+falla() {
+    echo "❌ $1"
+    fallas=$((fallas + 1))
+}
+
+sim/glx-sim crear "$DIR/sim" >/dev/null || exit 1
+export XDG_CACHE_HOME="$DIR/cache"
+unset GLX_SOCKET GLX_NVIDIA_SMI
+
+# Un modo que no existe se rechaza con archivo:línea
+cat > "$DIR/malo.conf" <<'CONF'
+cuando: POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=0 -> quiet
+proceso: steam -> perfomance
+CONF
+salida="$(./build/gx --sim="$DIR/sim" auto --stdin --config "$DIR/malo.conf" </dev/null 2>&1)"
+[ $? -ne 0 ] || falla "auto arrancó con un modo inexistente"
+echo "$salida" | grep -q "malo.conf:2: modo desconocido 'perfomance'" || falla "no se informó archivo:línea del modo inexistente"
+
+cat > "$DIR/auto.conf" <<'CONF'
+debounce_ms: 50
+cuando: POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=0 -> quiet
+proceso: steam -> performance
+proceso: cc1* -> balanced
+CONF
+
+# Cada paso espera a que pase el debounce para que se aplique por separado
+eventos() {
+    for evento in \
+        "SUBSYSTEM=power_supply POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=0" \
+        "PROC_EVENT=exec PID=100 COMM=steam" \
+        "PROC_EVENT=exec PID=101 COMM=steam" \
+        "PROC_EVENT=exit PID=100" \
+        "PROC_EVENT=exec PID=200 COMM=cc1plus" \
+        "PROC_EVENT=exit PID=101" \
+        "PROC_EVENT=exec PID=201 COMM=cc1" \
+        "PROC_EVENT=exit PID=200" \
+        "PROC_EVENT=exit PID=999" \
+        "PROC_EVENT=exit PID=201"; do
+        echo "$evento"
+        sleep 0.2
+    done
+}
+
+salida="$(eventos | ./build/gx --sim="$DIR/sim" auto --stdin --config "$DIR/auto.conf" 2>&1)"
+aplicados="$(echo "$salida" | grep -a "auto: aplicando modo" | sed 's/.*aplicando modo \([a-z]*\).*/\1/' | tr '\n' ' ')"
+[ "$aplicados" = "quiet performance balanced quiet " ] || falla "secuencia de modos: '$aplicados' (se esperaba 'quiet performance balanced quiet ')"
+[ "$(echo "$salida" | grep -ac 'terminó el último proceso de "steam"')" = 1 ] || falla "steam debería terminar una sola vez, con el segundo exit"
+[ "$(echo "$salida" | grep -ac 'terminó el último proceso de "cc1\*"')" = 1 ] || falla "cc1* debería terminar una sola vez, con el último exit"
+echo "$salida" | grep -aq "Modo de ejecución desconocido\|Quisiste decir" && falla "auto corrigió o no encontró un modo"
+
+if [ "$fallas" -eq 0 ]; then
+    echo "✅ gx auto --stdin: todo bien"
+    exit 0
+fi
+echo "$salida"
+exit 1
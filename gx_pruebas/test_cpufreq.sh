@@ -0,0 +1,90 @@
+#!/bin/bash
+# Prueba de los knobs de cpufreq por tipo de núcleo sobre el hardware simulado
+# Uso: gx_pruebas/test_cpufreq.sh   (después de make; no necesita root)
+#
+# Verifica que un modo con frecuencias, governor y EPP de núcleos P y E deja
+# cada policy*/ de su clase con el valor correcto (las frecuencias en kHz),
+# sin tocar las de la otra clase, y que en una CPU sin cpu_atom los knobs de
+# núcleos E fallan con un error y sin escribir nada.
+
+cd "$(dirname "$0")/.." || exit 1
+DIR="$(mktemp -d)"
+trap 'rm -rf "$DIR"' EXIT
+fallas=0
+
+falla() {
+    echo "❌ $1"
+    fallas=$((fallas + 1))
+}
+
+if [ -e /usr/local/share/glx/modelo.txt ]; then
+    echo "⚠️  Hay un modelo.txt instalado en /usr/local/share/glx; gx no usaría el de la prueba"
+    exit 0
+fi
+
+# gx busca modelo.txt junto a su ejecutable: una copia con sus propios modos
+mkdir -p "$DIR/glx/bin"
+cp build/gx "$DIR/glx/bin/gx" || exit 1
+cat > "$DIR/glx/modelo.txt" <<'MODOS'
+mode: frecuencias
+- cpu_governor_p: performance
+- cpu_governor_e: powersave
+- cpu_epp_p: performance
+- cpu_epp_e: power
+- cpu_max_freq_p: 3000
+- cpu_max_freq_e: 2000
+- cpu_min_freq_p: 800
+- cpu_min_freq_e: 600
+
+mode: solo_e
+- cpu_max_freq_e: 2000
+- cpu_governor_e: performance
+- cpu_epp_e: balance_power
+MODOS
+
+export XDG_CACHE_HOME="$DIR/cache"
+unset GLX_SOCKET GLX_NVIDIA_SMI
+sim/glx-sim crear "$DIR/hibrida" --cpus=16:32 >/dev/null || exit 1
+sim/glx-sim crear "$DIR/plana" --cpus=16:0 >/dev/null || exit 1
+
+# Cada archivo de las policies [desde, hasta) tiene que valer lo esperado
+revisar() {
+    local arbol="$1" desde="$2" hasta="$3" archivo="$4" esperado="$5" cpu valor
+    for ((cpu = desde; cpu < hasta; cpu++)); do
+        valor="$(cat "$arbol/sys/devices/system/cpu/cpufreq/policy$cpu/$archivo")"
+        if [ "$valor" != "$esperado" ]; then
+            falla "policy$cpu/$archivo vale '$valor' (se esperaba '$esperado')"
+            return
+        fi
+    done
+}
+
+salida="$("$DIR/glx/bin/gx" --sim="$DIR/hibrida" run mode:frecuencias 2>&1)"
+echo "$salida" | grep -q "Modo 'frecuencias' aplicado exitosamente" || falla "el modo frecuencias no se aplicó: $salida"
+
+# Núcleos P: policy0-15, núcleos E: policy16-47
+revisar "$DIR/hibrida" 0 16 scaling_max_freq 3000000
+revisar "$DIR/hibrida" 16 48 scaling_max_freq 2000000
+revisar "$DIR/hibrida" 0 16 scaling_min_freq 800000
+revisar "$DIR/hibrida" 16 48 scaling_min_freq 600000
+revisar "$DIR/hibrida" 0 16 scaling_governor performance
+revisar "$DIR/hibrida" 16 48 scaling_governor powersave
+revisar "$DIR/hibrida" 0 16 energy_performance_preference performance
+revisar "$DIR/hibrida" 16 48 energy_performance_preference power
+
+# Sin cpu_atom todas las policies son núcleos P: los knobs E no tienen dónde escribir
+[ ! -e "$DIR/plana/sys/devices/cpu_atom" ] || falla "el árbol plano tiene cpu_atom"
+salida="$("$DIR/glx/bin/gx" --sim="$DIR/plana" run mode:solo_e 2>&1)"
+[ $? -eq 0 ] || falla "gx terminó con error al aplicar knobs E sin núcleos E"
+errores="$(echo "$salida" | grep -c "núcleos E: Error al aplicar (No such file or directory)")"
+[ "$errores" -eq 3 ] || falla "se esperaban 3 errores de knobs E, hubo $errores: $salida"
+echo "$salida" | grep -q "aplicado parcialmente" || falla "el modo solo_e no se informó como parcial"
+revisar "$DIR/plana" 0 16 scaling_max_freq 4500000
+revisar "$DIR/plana" 0 16 scaling_governor powersave
+revisar "$DIR/plana" 0 16 energy_performance_preference balance_performance
+
+if [ "$fallas" -eq 0 ]; then
+    echo "✅ cpufreq por tipo de núcleo: todo bien"
+    exit 0
+fi
+exit 1
@@ -0,0 +1,82 @@
+#!/bin/bash
+# Prueba de las dos vías de escritura de los knobs de sysfs sobre el hardware simulado
+# Uso: gx_pruebas/test_escritura_sudo.sh   (después de make; como root baja a nobody con setpriv)
+#
+# Deja max_perf_pct de solo lectura y aplica mode:quiet: cpu_min_perf tiene
+# que escribirse directo y cpu_max_perf, al recibir EACCES, por "sudo tee"
+# con la ruta como argumento propio (el árbol tiene un "$(...)" en el nombre
+# para que se note si pasara por un shell). El sudo falso anota sus
+# argumentos y devuelve el permiso de escritura antes de ejecutar tee.
+
+cd "$(dirname "$0")/.." || exit 1
+DIR="$(mktemp -d)"
+trap 'rm -rf "$DIR"' EXIT
+fallas=0
+
+falla() {
+    echo "❌ $1"
+    fallas=$((fallas + 1))
+}
+
+# Como root no hay EACCES: la prueba corre como nobody
+COMO=()
+if [ "$(id -u)" -eq 0 ]; then
+    if ! command -v setpriv >/dev/null; then
+        echo "⚠️  Corriendo como root sin setpriv: no se puede provocar EACCES"
+        exit 0
+    fi
+    COMO=(setpriv --reuid=nobody --regid="$(id -gn nobody)" --clear-groups)
+fi
+
+SIM="$DIR/sim \$(touch inyectado)"
+sim/glx-sim crear "$SIM" >/dev/null || exit 1
+mkdir -p "$DIR/bin"
+cp build/gx "$DIR/bin/gx" || exit 1
+
+cat > "$SIM/bin/sudo" <<'SUDO'
+#!/bin/bash
+# sudo falso: anota cada argumento en una línea y da permiso de escritura a lo que toque tee
+printf '%s\n' "$@" "--" >> "$(dirname "$0")/../sudo.log"
+while [ "$#" -gt 0 ] && [ "${1#-}" != "$1" ]; do shift; done
+[ "$#" -eq 0 ] && exit 0
+if [ "$1" = tee ]; then
+    for arg in "${@:2}"; do
+        [ "${arg#-}" = "$arg" ] && chmod u+w "$arg"
+    done
+fi
+exec "$@"
+SUDO
+chmod +x "$SIM/bin/sudo"
+
+CPU="$SIM/sys/devices/system/cpu/intel_pstate"
+chmod 0444 "$CPU/max_perf_pct"
+[ ${#COMO[@]} -gt 0 ] && chown -R nobody "$DIR"
+
+salida="$(cd "$DIR" && env XDG_CACHE_HOME="$DIR/cache" GLX_SOCKET= GLX_NVIDIA_SMI= \
+    "${COMO[@]}" "$DIR/bin/gx" --sim="$SIM" --format=json run mode:quiet 2>&1)"
+
+knob() {
+    echo "$salida" | grep "\"knob\":\"$1\""
+}
+knob cpu_max_perf | grep -q '"valor":"60","resultado":"sudo"' ||
+    falla "cpu_max_perf no se escribió con sudo: $(knob cpu_max_perf)"
+knob cpu_min_perf | grep -q '"valor":"20","resultado":"directo"' ||
+    falla "cpu_min_perf no se escribió directo: $(knob cpu_min_perf)"
+# persist_mode es un comando (nvidia-smi -pm): sin root siempre va con sudo
+otros="$(echo "$salida" | grep '"resultado":"sudo"' | grep -v '"knob":"cpu_max_perf"\|"knob":"persist_mode"')"
+[ -z "$otros" ] || falla "otro knob de sysfs pasó por sudo: $otros"
+[ "$(cat "$CPU/max_perf_pct")" = 60 ] || falla "max_perf_pct vale $(cat "$CPU/max_perf_pct") (se esperaba 60)"
+[ "$(cat "$CPU/min_perf_pct")" = 20 ] || falla "min_perf_pct vale $(cat "$CPU/min_perf_pct") (se esperaba 20)"
+
+# La ruta llega a tee tal cual, como un argumento, sin pasar por un shell
+grep -qxF "$CPU/max_perf_pct" "$SIM/sudo.log" || falla "sudo no recibió la ruta de max_perf_pct como argumento: $(cat "$SIM/sudo.log" 2>/dev/null)"
+grep -B1 -xF "$CPU/max_perf_pct" "$SIM/sudo.log" | head -n 1 | grep -qx tee || falla "la ruta de max_perf_pct no va después de tee"
+grep -qxF "$CPU/min_perf_pct" "$SIM/sudo.log" && falla "min_perf_pct pasó por sudo aunque se podía escribir"
+[ -e "$DIR/inyectado" ] || [ -e "$DIR/bin/inyectado" ] && falla "el \$(...) del nombre del árbol se ejecutó en un shell"
+
+if [ "$fallas" -eq 0 ]; then
+    echo "✅ escritura directa y con sudo tee: todo bien"
+    exit 0
+fi
+echo "$salida"
+exit 1
@@ -0,0 +1,108 @@
+#!/bin/bash
+# Prueba de glxd --mock de punta a punta sobre el hardware simulado
+# Uso: gx_pruebas/test_glxd_mock.sh   (después de make; no necesita root)
+#
+# Verifica que gx aplica el modo por el daemon, que los knobs de comandos
+# quedan en DIR/glxd sin ejecutar nvidia-smi ni legion_cli, que el socket no
+# queda abierto a otros usuarios, que un cliente ocioso no frena a los demás
+# y que un apply corre sus backends en paralelo sin bloquear a otros clientes.
+
+cd "$(dirname "$0")/.." || exit 1
+DIR="$(mktemp -d)"
+fallas=0
+
+falla() {
+    echo "❌ $1"
+    fallas=$((fallas + 1))
+}
+
+terminar() {
+    [ -n "$OCIOSO" ] && kill "$OCIOSO" 2>/dev/null
+    [ -n "$GLXD" ] && kill "$GLXD" 2>/dev/null && wait "$GLXD" 2>/dev/null
+    rm -rf "$DIR"
+}
+trap terminar EXIT
+
+sim/glx-sim crear "$DIR" >/dev/null || exit 1
+# Sin bin/ falso: si glxd ejecutara un comando, fallaría
+rm -rf "$DIR/bin"
+export XDG_CACHE_HOME="$DIR/cache"
+unset GLX_SOCKET GLX_NVIDIA_SMI
+
+# Cada comando simulado tarda 400 ms: en serie, quiet pasaría de un segundo
+GLX_SIM="$DIR" GLX_SIM_LATENCIA="nvidia-smi=400,legion_cli=400" \
+    ./build/glxd --mock "$DIR" --socket "$DIR/glxd.sock" 2>"$DIR/glxd.log" &
+GLXD=$!
+for _ in $(seq 50); do
+    grep -q escuchando "$DIR/glxd.log" && break
+    sleep 0.05
+done
+grep -q escuchando "$DIR/glxd.log" || { echo "❌ glxd no arrancó"; cat "$DIR/glxd.log"; exit 1; }
+
+permisos="$(stat -c %a "$DIR/glxd.sock")"
+[ "$permisos" = 600 ] || falla "el socket quedó con permisos $permisos (se esperaba 600)"
+
+# Un cliente que se conecta y no manda nada
+if command -v python3 >/dev/null 2>&1; then
+    python3 -c 'import socket, sys, time
+s = socket.socket(socket.AF_UNIX); s.connect(sys.argv[1]); time.sleep(10)' "$DIR/glxd.sock" &
+    OCIOSO=$!
+    sleep 0.2
+fi
+
+inicio=$(date +%s%N)
+./build/gx --sim="$DIR" run mode:quiet >"$DIR/run.log" 2>&1 &
+RUN=$!
+# Mientras se aplica el lote, otro cliente recibe respuesta enseguida
+if command -v python3 >/dev/null 2>&1; then
+    sleep 0.15
+    ping_ms="$(python3 -c 'import socket, sys, time
+s = socket.socket(socket.AF_UNIX); s.connect(sys.argv[1]); t = time.time()
+s.sendall(b"ping\n"); s.recv(16); print(int((time.time() - t) * 1000))' "$DIR/glxd.sock")"
+    [ "$ping_ms" -lt 200 ] || falla "ping tardó ${ping_ms} ms durante un apply"
+fi
+wait "$RUN"
+ms=$(( ($(date +%s%N) - inicio) / 1000000 ))
+salida="$(cat "$DIR/run.log")"
+[ "$ms" -lt 1000 ] || falla "run mode:quiet tardó ${ms} ms (los backends no corrieron en paralelo o un cliente ocioso lo frenó)"
+
+echo "$salida" | grep -q "Persistence Mode: ON (glxd)" || falla "persist_mode no pasó por glxd"
+echo "$salida" | grep -q "CPU Max Performance: 60% (glxd)" || falla "cpu_max_perf no pasó por glxd"
+echo "$salida" | grep -q "aplicado exitosamente" || falla "el modo no se aplicó completo"
+[ "$(cat "$DIR/glxd/persist_mode" 2>/dev/null)" = 1 ] || falla "persist_mode no quedó en $DIR/glxd"
+[ "$(cat "$DIR/sys/devices/system/cpu/intel_pstate/max_perf_pct")" = 60 ] || falla "max_perf_pct no quedó en 60"
+grep -q "not found\|no se encontró" "$DIR/glxd.log" && falla "glxd intentó ejecutar un comando"
+
+# Segunda vez: el estado lo consulta el daemon y no hay nada que cambiar
+./build/gx --sim="$DIR" run mode:quiet 2>&1 | grep -q "ya está en modo 'quiet'" || falla "query por glxd no vio el modo aplicado"
+
+# Un daemon que responde "err" o no responde a tiempo pudo haber recibido el
+# lote: gx informa el error y no lo vuelve a aplicar por su cuenta
+if command -v python3 >/dev/null 2>&1; then
+    kill "$GLXD" 2>/dev/null && wait "$GLXD" 2>/dev/null
+    GLXD=""
+    for respuesta in err silencio; do
+        python3 -c 'import socket, sys, time
+s = socket.socket(socket.AF_UNIX); s.bind(sys.argv[1]); s.listen(4)
+while True:
+    c, _ = s.accept(); pedido = c.recv(2048)
+    if pedido.startswith(b"query") or sys.argv[2] == "err": c.sendall(b"err ocupado\n")
+    else: time.sleep(7)
+    c.close()' "$DIR/glxd.sock" "$respuesta" &
+        GLXD=$!
+        sleep 0.3
+        salida="$(./build/gx --sim="$DIR" run mode:balanced 2>&1)"
+        [ "$(cat "$DIR/sys/devices/system/cpu/intel_pstate/max_perf_pct")" = 60 ] || falla "con un daemon que da '$respuesta' gx aplicó el modo localmente"
+        echo "$salida" | grep -q "Error al aplicar" || falla "con un daemon que da '$respuesta' no se informó el error"
+        kill "$GLXD" 2>/dev/null && wait "$GLXD" 2>/dev/null
+        GLXD=""
+        rm -f "$DIR/glxd.sock"
+    done
+fi
+
+if [ "$fallas" -eq 0 ]; then
+    echo "✅ glxd --mock: todo bien"
+    exit 0
+fi
+echo "glxd.log:"; cat "$DIR/glxd.log"
+exit 1
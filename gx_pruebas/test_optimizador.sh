@@ -0,0 +1,106 @@
+#!/bin/bash
+# Prueba del optimizador estático (src/optimizador.c) sobre el hardware simulado
+# Uso: gx_pruebas/test_optimizador.sh   (después de make; no necesita root)
+#
+# Verifica con --debug-ast que las declaraciones repetidas del mismo parámetro
+# se reducen a la última y que "run" corta la secuencia, que los errores de
+# todo el archivo se informan antes de aplicar nada (el "run" previo no toca
+# el sysfs simulado) y que una cadena de variables llega como constante a las
+# declaraciones y al "run".
+
+cd "$(dirname "$0")/.." || exit 1
+DIR="$(mktemp -d)"
+trap 'rm -rf "$DIR"' EXIT
+fallas=0
+
+falla() {
+    echo "❌ $1"
+    fallas=$((fallas + 1))
+}
+
+sim/glx-sim crear "$DIR/sim" >/dev/null || exit 1
+export XDG_CACHE_HOME="$DIR/cache"
+unset GLX_SOCKET GLX_NVIDIA_SMI
+MAX_PERF="$DIR/sim/sys/devices/system/cpu/intel_pstate/max_perf_pct"
+
+# AST optimizado: una línea "tipo valor" por nodo, sin la ubicación
+ast_optimizado() {
+    sed -n '/^Optimizador:/,/^$/p' "$1" | sed -n 's/^ *- Type: \([A-Z_]*\)\(, Value: \(.*\) ([0-9]*:[0-9]*)\)\{0,1\}$/\1 \3/p' | sed 's/ $//'
+}
+
+# Declaraciones repetidas: quedan 70 (antes del run) y 90 (al final)
+cat > "$DIR/repetidas.gx" <<'GX'
+cpu_max_perf: 50
+cpu_max_perf: 60
+cpu_max_perf: 70
+run mode:quiet
+cpu_max_perf: 80
+cpu_max_perf: 90
+GX
+./build/gx --sim="$DIR/sim" --debug-ast "$DIR/repetidas.gx" > "$DIR/repetidas.log" 2>&1 || falla "repetidas.gx terminó con error"
+grep -q "3 declaraciones redundantes eliminadas" "$DIR/repetidas.log" || falla "no se eliminaron las 3 declaraciones redundantes"
+esperado="PROGRAM
+DECLARATION cpu_max_perf
+NUMBER 70
+RUN_COMMAND run
+IDENTIFIER quiet
+DECLARATION cpu_max_perf
+NUMBER 90"
+[ "$(ast_optimizado "$DIR/repetidas.log")" = "$esperado" ] || falla "el AST de repetidas.gx no quedó con 70, run y 90: $(ast_optimizado "$DIR/repetidas.log")"
+grep -q "establecido a: 50%\|establecido a: 60%\|establecido a: 80%" "$DIR/repetidas.log" && falla "se ejecutó una declaración redundante"
+[ "$(grep -c "CPU Max Performance establecido a:" "$DIR/repetidas.log")" -eq 2 ] || falla "repetidas.gx no ejecutó exactamente dos declaraciones"
+
+# Errores por adelantado: el run del principio no llega a aplicarse
+echo 100 > "$MAX_PERF"
+cat > "$DIR/errores.gx" <<'GX'
+run mode:quiet
+cpu_max_perf: 150
+cpu_min_perf: no_definida
+GX
+./build/gx --sim="$DIR/sim" "$DIR/errores.gx" > "$DIR/errores.log" 2>&1 && falla "errores.gx no terminó con error"
+grep -q "errores.gx:2:1: .*'cpu_max_perf' fuera de rango" "$DIR/errores.log" || falla "no se informó el rango de la línea 2"
+grep -q "errores.gx:3:1: .*La variable 'no_definida' no está definida" "$DIR/errores.log" || falla "no se informó la variable de la línea 3"
+grep -q "2 error(es) en .*Ejecución abortada antes de aplicar cambios" "$DIR/errores.log" || falla "no se informaron los 2 errores juntos"
+grep -q "Cargando configuración" "$DIR/errores.log" && falla "se empezó a aplicar un modo con errores en el archivo"
+[ "$(cat "$MAX_PERF")" = 100 ] || falla "max_perf_pct cambió a $(cat "$MAX_PERF") aunque el archivo tenía errores"
+
+# El mismo run sin los errores sí cambia el sysfs (la comprobación de arriba no es vacía)
+echo "run mode:quiet" > "$DIR/sin_errores.gx"
+./build/gx --sim="$DIR/sim" "$DIR/sin_errores.gx" > /dev/null 2>&1
+[ "$(cat "$MAX_PERF")" = 60 ] || falla "run mode:quiet no dejó max_perf_pct en 60"
+
+# Cadenas de variables: cada uso queda como la constante del origen
+cat > "$DIR/cadenas.gx" <<'GX'
+a = 40
+b = a
+c = b
+cpu_min_perf: c
+m = "balanced"
+n = m
+run mode: n
+GX
+./build/gx --sim="$DIR/sim" --debug-ast "$DIR/cadenas.gx" > "$DIR/cadenas.log" 2>&1 || falla "cadenas.gx terminó con error"
+grep -q "Optimizador: 5 variables reemplazadas por constantes" "$DIR/cadenas.log" || falla "no se reemplazaron las 5 variables"
+esperado="PROGRAM
+ASSIGNMENT a
+NUMBER 40
+ASSIGNMENT b
+NUMBER 40
+ASSIGNMENT c
+NUMBER 40
+DECLARATION cpu_min_perf
+NUMBER 40
+ASSIGNMENT m
+STRING balanced
+ASSIGNMENT n
+STRING balanced
+RUN_COMMAND run
+STRING balanced"
+[ "$(ast_optimizado "$DIR/cadenas.log")" = "$esperado" ] || falla "el AST de cadenas.gx no quedó con constantes: $(ast_optimizado "$DIR/cadenas.log")"
+grep -q "Modo 'balanced' aplicado" "$DIR/cadenas.log" || falla "run mode: n no aplicó balanced"
+
+if [ "$fallas" -eq 0 ]; then
+    echo "✅ optimizador: todo bien"
+    exit 0
+fi
+exit 1
@@ -0,0 +1,98 @@
+#!/bin/bash
+# Prueba de ida y vuelta de gx record y gx export sobre el hardware simulado
+# Uso: gx_pruebas/test_record_export.sh   (después de make; no necesita root)
+#
+# Graba dos segundos con un nvidia-smi cuya potencia salta entre 10 W y 400 W
+# (un delta de 39000 centésimas, que no entra en 16 bits) y verifica con el
+# CSV exportado que cada salto abrió un bloque nuevo, que un bloque final
+# truncado se ignora sin perder los anteriores y que --from/--to devuelven
+# exactamente las muestras del rango aunque caigan en medio de un bloque.
+
+cd "$(dirname "$0")/.." || exit 1
+DIR="$(mktemp -d)"
+trap 'rm -rf "$DIR"' EXIT
+fallas=0
+
+falla() {
+    echo "❌ $1"
+    fallas=$((fallas + 1))
+}
+
+sim/glx-sim crear "$DIR/sim" >/dev/null || exit 1
+export XDG_CACHE_HOME="$DIR/cache"
+unset GLX_SOCKET GLX_NVIDIA_SMI
+
+cat > "$DIR/sim/bin/nvidia-smi" <<'NVIDIA'
+#!/bin/bash
+# Potencia que cambia entre 10 W y 400 W cada tres líneas
+intervalo_ms=100 prev=""
+for arg in "$@"; do
+    [ "$prev" = -lms ] && intervalo_ms="$arg"
+    prev="$arg"
+done
+espera="$(awk -v ms="$intervalo_ms" 'BEGIN { print ms / 1000 }')"
+n=0
+while true; do
+    potencia=10
+    [ $((n / 3 % 2)) = 1 ] && potencia=400
+    echo "GPU de prueba, $potencia.00, 50, 1500, Enabled" || exit 0
+    n=$((n + 1))
+    sleep "$espera"
+done
+NVIDIA
+chmod +x "$DIR/sim/bin/nvidia-smi"
+
+ARCHIVO="$DIR/t.glxr"
+salida="$(./build/gx --sim="$DIR/sim" record "$ARCHIVO" --hz 20 --duration 2 2>&1)"
+bloques="$(echo "$salida" | sed -n 's/.*✅ \([0-9]*\) bloques escritos.*/\1/p')"
+[ -n "$bloques" ] || { echo "❌ gx record falló: $salida"; exit 1; }
+
+./build/gx export "$ARCHIVO" --format csv > "$DIR/completo.csv" || falla "gx export falló"
+tail -n +2 "$DIR/completo.csv" > "$DIR/muestras.csv"
+muestras="$(wc -l < "$DIR/muestras.csv")"
+[ "$muestras" -ge 20 ] || falla "solo se exportaron $muestras muestras"
+
+# Índice (desde 1) de la muestra que abre cada bloque: la primera y cada una
+# cuyo delta con la anterior no entra en int16 en algún campo (-1 = vacío)
+awk -F, '
+    function guardado(v, escala) { return v == "" ? -1 : int(v * escala + (v < 0 ? -0.5 : 0.5)) }
+    {
+        for (i = 2; i <= NF; i++) actual[i] = guardado($i, i == 5 ? 100 : 1)
+        nuevo = NR == 1
+        for (i = 2; i <= NF && !nuevo; i++) {
+            d = actual[i] - previo[i]
+            if (d > 32767 || d < -32768) nuevo = 1
+        }
+        if (nuevo) print NR
+        for (i = 2; i <= NF; i++) previo[i] = actual[i]
+    }' "$DIR/muestras.csv" > "$DIR/inicios.txt"
+esperados="$(wc -l < "$DIR/inicios.txt")"
+[ "$esperados" -ge 3 ] || falla "la potencia no saltó: $esperados bloques esperados"
+[ "$bloques" -eq "$esperados" ] || falla "gx record escribió $bloques bloques, los saltos de potencia piden $esperados"
+grep -q ",400.00," "$DIR/muestras.csv" && grep -q ",10.00," "$DIR/muestras.csv" ||
+    falla "el CSV no tiene las dos potencias"
+
+# Grabación cortada a mitad del último bloque: se exporta todo lo anterior
+ultimo="$(tail -n 1 "$DIR/inicios.txt")"
+head -n $((ultimo - 1)) "$DIR/muestras.csv" > "$DIR/esperado_truncado.csv"
+cp "$ARCHIVO" "$DIR/truncado.glxr"
+truncate -s -1000 "$DIR/truncado.glxr"
+./build/gx export "$DIR/truncado.glxr" --format csv > "$DIR/truncado.csv" || falla "gx export falló con un bloque truncado"
+tail -n +2 "$DIR/truncado.csv" | cmp -s - "$DIR/esperado_truncado.csv" ||
+    falla "con el último bloque truncado no salieron exactamente las $((ultimo - 1)) muestras anteriores"
+
+# --from/--to a mitad de camino entre dos muestras, lejos de los bordes de bloque
+desde="$(awk -F, 'NR == 8 { t = $1 } NR == 9 { printf "%.4f", (t + $1) / 2 }' "$DIR/muestras.csv")"
+hasta="$(awk -F, -v n=$((muestras - 5)) 'NR == n { t = $1 } NR == n + 1 { printf "%.4f", (t + $1) / 2 }' "$DIR/muestras.csv")"
+awk -F, -v d="$desde" -v h="$hasta" '$1 + 0 >= d + 0 && $1 + 0 <= h + 0' "$DIR/muestras.csv" > "$DIR/esperado_rango.csv"
+./build/gx export "$ARCHIVO" --format csv --from "$desde" --to "$hasta" > "$DIR/rango.csv" || falla "gx export --from/--to falló"
+tail -n +2 "$DIR/rango.csv" | cmp -s - "$DIR/esperado_rango.csv" ||
+    falla "--from $desde --to $hasta no devolvió las $(wc -l < "$DIR/esperado_rango.csv") muestras del rango"
+[ "$(wc -l < "$DIR/esperado_rango.csv")" -eq $((muestras - 13)) ] || falla "el rango de prueba quedó mal armado"
+
+if [ "$fallas" -eq 0 ]; then
+    echo "✅ gx record/export: todo bien"
+    exit 0
+fi
+echo "$salida"
+exit 1
@@ -0,0 +1,150 @@
+// Prueba de sugerir_palabra contra una búsqueda lineal con la programación
+// dinámica de siempre (matriz completa). Arma listas fijas de palabras al
+// azar, algunas de más de 64 caracteres para pasar por distancia_dp, y
+// compara la sugerencia (con y sin índice) para palabras al azar y para
+// variantes con 1 a 3 ediciones de las de la lista.
+// Se compila con make build/test_sugerir (ver test_sugerir.sh)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define NUM_LISTAS 8
+#define PALABRAS_POR_LISTA 16
+#define CONSULTAS 20000        // 320000 pares palabra-lista
+#define LARGO_MAX 300
+
+static char palabras[NUM_LISTAS][PALABRAS_POR_LISTA][LARGO_MAX + 1];
+static const char* listas[NUM_LISTAS][PALABRAS_POR_LISTA];
+static unsigned long long semilla = 0x9e3779b97f4a7c15ull;
+
+static unsigned azar(unsigned n) {
+    semilla ^= semilla << 13;
+    semilla ^= semilla >> 7;
+    semilla ^= semilla << 17;
+    return (unsigned)(semilla % n);
+}
+
+// Alfabeto chico para que haya muchas palabras cerca unas de otras
+static char letra(void) {
+    return "abcd_"[azar(5)];
+}
+
+static int largo_azar(void) {
+    switch (azar(4)) {
+        case 0: return 1 + azar(12);
+        case 1: return 1 + azar(64);
+        case 2: return 60 + azar(20);       // alrededor del corte de 64
+        default: return 65 + azar(LARGO_MAX - 64);
+    }
+}
+
+static void palabra_azar(char* destino, int largo) {
+    for (int i = 0; i < largo; i++) destino[i] = letra();
+    destino[largo] = '\0';
+}
+
+// Copiar origen con 1 a 3 ediciones (sustituir, insertar o borrar)
+static void variante(char* destino, const char* origen) {
+    strcpy(destino, origen);
+    int ediciones = 1 + azar(3);
+    for (int e = 0; e < ediciones; e++) {
+        int largo = strlen(destino);
+        int pos = azar(largo + 1);
+        int tipo = azar(3);
+        if (tipo == 0 && pos < largo) {
+            destino[pos] = letra();
+        } else if (tipo == 1 && largo < LARGO_MAX) {
+            memmove(destino + pos + 1, destino + pos, largo - pos + 1);
+            destino[pos] = letra();
+        } else if (pos < largo) {
+            memmove(destino + pos, destino + pos + 1, largo - pos);
+        }
+    }
+}
+
+static int distancia_referencia(const char* a, const char* b) {
+    int la = strlen(a), lb = strlen(b);
+    int* matriz = malloc((la + 1) * (lb + 1) * sizeof(int));
+    if (!matriz) {
+        perror("malloc");
+        exit(2);
+    }
+    for (int i = 0; i <= la; i++) {
+        for (int j = 0; j <= lb; j++) {
+            int* celda = &matriz[i * (lb + 1) + j];
+            if (i == 0 || j == 0) {
+                *celda = i + j;
+                continue;
+            }
+            int borrar = matriz[(i - 1) * (lb + 1) + j] + 1;
+            int insertar = matriz[i * (lb + 1) + j - 1] + 1;
+            int cambiar = matriz[(i - 1) * (lb + 1) + j - 1] + (a[i - 1] != b[j - 1]);
+            *celda = borrar < insertar ? borrar : insertar;
+            if (cambiar < *celda) *celda = cambiar;
+        }
+    }
+    int d = matriz[la * (lb + 1) + lb];
+    free(matriz);
+    return d;
+}
+
+// Lo que tiene que devolver sugerir_palabra según su contrato en utils.h
+static const char* sugerir_referencia(const char* palabra, const char** lista, int cantidad, int max_distancia) {
+    if ((int)strlen(palabra) > 256) return NULL;
+    int mejor = max_distancia + 1;
+    const char* sugerida = NULL;
+    for (int i = 0; i < cantidad; i++) {
+        int d = distancia_referencia(palabra, lista[i]);
+        if (d < mejor) {
+            mejor = d;
+            sugerida = lista[i];
+        }
+    }
+    return mejor == 0 ? NULL : sugerida;
+}
+
+int main(void) {
+    for (int l = 0; l < NUM_LISTAS; l++) {
+        for (int p = 0; p < PALABRAS_POR_LISTA; p++) {
+            palabra_azar(palabras[l][p], largo_azar());
+            listas[l][p] = palabras[l][p];
+        }
+    }
+
+    int fallas = 0;
+    char palabra[LARGO_MAX + 4];
+    for (int c = 0; c < CONSULTAS && fallas < 10; c++) {
+        int l = azar(NUM_LISTAS);
+        if (azar(2)) variante(palabra, listas[l][azar(PALABRAS_POR_LISTA)]);
+        else palabra_azar(palabra, largo_azar());
+        int max_distancia = azar(4);
+
+        // Con índice (distancias exactas) y sin índice (distancias acotadas)
+        const char* esperada = sugerir_referencia(palabra, listas[l], PALABRAS_POR_LISTA, max_distancia);
+        const char* obtenidas[2] = {
+            sugerir_palabra(palabra, listas[l], PALABRAS_POR_LISTA, max_distancia),
+            sugerir_palabra_variable(palabra, listas[l], PALABRAS_POR_LISTA, max_distancia),
+        };
+        for (int v = 0; v < 2; v++) {
+            if (obtenidas[v] == esperada) continue;
+            printf("❌ '%s' (max %d, %s): se sugirió '%s', se esperaba '%s'\n", palabra, max_distancia,
+                   v ? "sin índice" : "con índice", obtenidas[v] ? obtenidas[v] : "(nada)",
+                   esperada ? esperada : "(nada)");
+            fallas++;
+        }
+    }
+
+    // Los nombres de parámetros reales con la lista indexada de verdad
+    for (int i = 0; i < num_parametros; i++) {
+        variante(palabra, parametros_validos[i]);
+        const char* obtenida = sugerir_palabra(palabra, parametros_validos, num_parametros, 2);
+        if (obtenida != sugerir_referencia(palabra, parametros_validos, num_parametros, 2)) {
+            printf("❌ '%s': sugerencia distinta para los parámetros\n", palabra);
+            fallas++;
+        }
+    }
+
+    if (fallas == 0) printf("✅ sugerir_palabra: %d consultas (%d pares) iguales a la búsqueda lineal\n", CONSULTAS, CONSULTAS * PALABRAS_POR_LISTA);
+    return fallas == 0 ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#!/bin/bash
+# Prueba de sugerir_palabra contra una búsqueda lineal con programación dinámica
+# Uso: gx_pruebas/test_sugerir.sh
+#
+# Compila gx_pruebas/test_sugerir.c con el resto de gx y compara la sugerencia
+# del índice (BK-tree, Myers y la banda de distancia_dp) con la de recorrer la
+# lista midiendo cada distancia con la matriz completa.
+
+cd "$(dirname "$0")/.." || exit 1
+make -s build/test_sugerir || exit 1
+./build/test_sugerir
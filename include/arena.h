@@ -0,0 +1,36 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Arena de memoria por programa
+// Las reservas se toman de bloques grandes y se liberan todas juntas con
+// arena_liberar; no hay free individual. La usan el lexer y el parser para
+// que un archivo completo se tokenice y parsee con pocas reservas.
+
+#define ARENA_BLOQUE_MIN (64 * 1024)
+
+typedef struct ArenaBloque {
+    struct ArenaBloque* anterior;
+    size_t tamano;
+    size_t usado;
+    // Los datos siguen al encabezado
+} ArenaBloque;
+
+typedef struct {
+    ArenaBloque* actual;
+    size_t reservado;           // Bytes pedidos al sistema (estadística)
+} Arena;
+
+void arena_init(Arena* arena);
+
+// Reservar size bytes alineados a 16; nunca retorna NULL salvo sin memoria
+void* arena_alloc(Arena* arena, size_t size);
+
+// Copiar len bytes y terminar en '\0'
+char* arena_strndup(Arena* arena, const char* texto, size_t len);
+
+// Liberar todos los bloques de una vez
+void arena_liberar(Arena* arena);
+
+#endif // ARENA_H
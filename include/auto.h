@@ -0,0 +1,83 @@
+#ifndef AUTO_H
+#define AUTO_H
+
+#include <stddef.h>
+
+// Cambio automático de modo por eventos ("gx auto")
+// Escucha los uevents del kernel (NETLINK_KOBJECT_UEVENT) en vez de releer
+// /sys/class/power_supply/AC/online: al desenchufar el cargador llega un
+// evento de power_supply y se aplica el modo de la regla que coincida, con
+// el mismo camino que "run mode:". Las reglas salen de auto.conf:
+//
+//   debounce_ms: 300
+//   cuando: SUBSYSTEM=power_supply POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=0 -> quiet
+//   cuando: SUBSYSTEM=power_supply POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=1 -> balanced
+//
+// Una regla coincide si el evento trae todas sus CLAVE=VALOR; gana la
+// primera. POWER_SUPPLY_TYPE=Mains deja afuera los puertos USB-C, que
+// también son power_supply y reportan ONLINE=0 con el cargador enchufado. Las reglas de proceso mandan sobre las de energía mientras haya
+// algún proceso vivo que coincida (comm o ejecutable, patrón de fnmatch):
+//
+//   proceso: steam -> performance
+//   proceso: /usr/bin/blender -> performance
+//
+// Cada regla cuenta sus procesos; al terminar el último se vuelve al modo de
+// energía. Con --stdin los eventos se leen de la entrada estándar (uno por
+// línea, CLAVE=VALOR separados por espacios) para probar sin hardware; los de
+// procesos son "PROC_EVENT=exec PID=n COMM=nombre [EXE=ruta]" y
+// "PROC_EVENT=exit PID=n".
+
+#define AUTO_MAX_REGLAS 32
+#define AUTO_MAX_CONDICIONES 4
+#define AUTO_DEBOUNCE_MS 300
+#define AUTO_MAX_PROCESOS 32
+
+typedef struct {
+    char clave[48];
+    char valor[64];
+} AutoCondicion;
+
+typedef struct {
+    AutoCondicion condiciones[AUTO_MAX_CONDICIONES];
+    int num_condiciones;
+    char modo[50];
+    int linea;
+} AutoRegla;
+
+typedef struct {
+    char patron[128];           // Con '/' se compara con la ruta del ejecutable
+    char modo[50];
+    int linea;
+} AutoProceso;
+
+typedef struct {
+    AutoRegla reglas[AUTO_MAX_REGLAS];
+    int num_reglas;
+    AutoProceso procesos[AUTO_MAX_PROCESOS];   // En orden de prioridad
+    int num_procesos;
+    int debounce_ms;
+    char origen[512];           // Archivo del que salieron las reglas ("" = por defecto)
+} AutoConfig;
+
+// Cargar las reglas de ruta, o de $XDG_CONFIG_HOME/glx/auto.conf
+// (~/.config/glx/auto.conf) si ruta es NULL; sin archivo quedan las reglas
+// por defecto (Mains ONLINE=0 -> quiet, ONLINE=1 -> balanced)
+// Una regla cuyo modo no está entre los disponibles (integrados o de
+// modelo.txt) se rechaza con archivo:línea
+// Retorna 0 si se cargó, -1 si el archivo pedido no existe o tiene errores
+int auto_cargar_config(const char* ruta, AutoConfig* config);
+
+// Modo de la primera regla que coincide con un uevent; NULL si ninguna
+// El evento son pares CLAVE=VALOR separados por '\0', espacios o saltos de
+// línea (el formato del kernel empieza con "ACTION@DEVPATH", que se ignora)
+const char* auto_modo_para_evento(const AutoConfig* config, const char* evento, size_t len);
+
+// Índice de la primera regla de proceso que coincide; -1 si ninguna
+int auto_regla_proceso(const AutoConfig* config, const char* comm, const char* exe);
+
+// Bucle de eventos hasta Ctrl+C (o fin de stdin con desde_stdin)
+// Con reglas de proceso usa el conector de procesos o, sin él, escanea /proc
+// Retorna 0 si terminó bien, 1 si no se pudo abrir el socket de uevents
+int auto_ejecutar(const AutoConfig* config, int desde_stdin);
+
+#endif // AUTO_H
@@ -0,0 +1,48 @@
+#ifndef CPUFREQ_H
+#define CPUFREQ_H
+
+#include <stddef.h>
+#include "utils.h"
+
+// Control de cpufreq por policy (/sys/devices/system/cpu/cpufreq/policy*)
+// Las policies se enumeran una sola vez por proceso y se clasifican en
+// núcleos P o E según /sys/devices/cpu_atom/cpus (CPUs híbridas de Intel);
+// sin ese archivo todas cuentan como P. Cada escritura va a todas las
+// policies de una clase como un solo lote.
+
+#define CPUFREQ_DIR "/sys/devices/system/cpu/cpufreq"
+#define CPUFREQ_ATOM_CPUS "/sys/devices/cpu_atom/cpus"
+
+typedef enum {
+    CPUFREQ_CLASE_P,        // Núcleos de rendimiento (o todos si no es híbrida)
+    CPUFREQ_CLASE_E,        // Núcleos eficientes
+    CPUFREQ_NUM_CLASES
+} CpufreqClase;
+
+typedef enum {
+    CPUFREQ_ATTR_EPP,           // energy_performance_preference
+    CPUFREQ_ATTR_GOBERNADOR,    // scaling_governor
+    CPUFREQ_ATTR_MAX_FREQ,      // scaling_max_freq (MHz para GLX, kHz en sysfs)
+    CPUFREQ_ATTR_MIN_FREQ       // scaling_min_freq
+} CpufreqAtributo;
+
+// Cantidad de policies de una clase (enumera en la primera llamada)
+int cpufreq_num_policies(CpufreqClase clase);
+
+// Verificar un valor de texto (EPP o governor) contra lo que anuncia la
+// primera policy de la clase; sin esa lista solo se controla que sea una palabra
+int cpufreq_validar(CpufreqClase clase, CpufreqAtributo atributo, const char* valor);
+
+// Escribir el valor en todas las policies de la clase. Las que dan EACCES se
+// escriben juntas con un solo "sudo tee"
+// Retorna el resultado del lote; con KNOB_ERROR, errno es el primer error
+KnobResult cpufreq_escribir(CpufreqClase clase, CpufreqAtributo atributo, const char* valor);
+
+// Leer el valor de la clase; solo cuenta si todas sus policies coinciden
+// Retorna 1 si se pudo leer
+int cpufreq_leer(CpufreqClase clase, CpufreqAtributo atributo, char* valor, size_t size);
+
+// Olvidar la enumeración (la raíz de sysfs cambió)
+void cpufreq_reiniciar(void);
+
+#endif // CPUFREQ_H
@@ -0,0 +1,32 @@
+#ifndef EJECUTOR_H
+#define EJECUTOR_H
+
+#include "knobs.h"
+
+// Ejecutor paralelo de escrituras de knobs
+// Cada escritura del lote es una tarea; las restricciones de orden entre
+// knobs (por ejemplo cpu_min_perf <= cpu_max_perf en intel_pstate) se
+// declaran en una tabla y se convierten en dependencias. Las tareas
+// independientes corren a la vez en un pool chico de hilos, así que un
+// cambio de modo tarda lo que el backend más lento (nvidia-smi, legion_cli)
+// y no la suma de todos.
+
+#define EJECUTOR_MAX_HILOS 4
+#define EJECUTOR_PLAZO_MS 10000
+
+// Aplicar el lote localmente y esperar como máximo plazo_ms
+// Las tareas que no terminan a tiempo quedan en KNOB_ERROR con ETIMEDOUT
+// (sus hilos terminan solos y sin tocar writes). Un lote no arranca mientras
+// siga escribiendo alguna tarea de uno anterior: si no terminan dentro del
+// plazo, todo el lote queda en KNOB_ERROR con EBUSY sin escribir nada.
+// Retorna la cantidad de escrituras aplicadas
+int ejecutor_aplicar(KnobWrite* writes, int cantidad, int plazo_ms);
+
+// Cómo se aplica cada escritura: completa resultado, error y via_comando
+typedef void (*EjecutorEscribir)(KnobWrite* write);
+
+// Igual que ejecutor_aplicar con otra forma de escribir (glxd usa sus
+// descriptores ya abiertos)
+int ejecutor_aplicar_con(KnobWrite* writes, int cantidad, int plazo_ms, EjecutorEscribir escribir);
+
+#endif // EJECUTOR_H
@@ -0,0 +1,53 @@
+#ifndef GLXD_H
+#define GLXD_H
+
+#include "knobs.h"
+
+// Socket por defecto del daemon privilegiado (se puede cambiar con GLX_SOCKET)
+#define GLXD_SOCKET_PATH "/run/glxd.sock"
+
+// Grupo que puede usar el socket (root:glx, 0660)
+#define GLXD_GRUPO "glx"
+
+// Largo máximo de una línea del protocolo
+#define GLXD_MAX_LINE 1024
+
+// Conexiones atendidas a la vez y tiempo tras el cual se corta una ociosa
+#define GLXD_MAX_CLIENTES 32
+#define GLXD_OCIOSO_MS 2000
+
+// Plazo para aplicar un lote y espera de gx por la respuesta: el daemon
+// responde antes de que gx se canse aunque algún backend siga colgado
+#define GLXD_PLAZO_MS 4000
+#define GLXD_ESPERA_MS 5000
+
+// Telemetría de GPU del daemon (de ahí sale persistence_mode para "query")
+#define GLXD_GPU_INTERVALO_MS 1000
+#define GLXD_GPU_ESPERA_MS 3000
+
+// Resultados de glxd_aplicar además de 0 (el daemon respondió)
+#define GLXD_AUSENTE -1         // El daemon no recibió el lote: aplicar localmente
+#define GLXD_FALLO -2           // Pudo haberlo recibido: no hay que aplicarlo de nuevo
+
+// Protocolo (una línea de texto por mensaje):
+//   apply <knob>=<valor> [<knob>=<valor> ...]  ->  ok <knob>=<res> ...
+//   query                                      ->  ok <knob>=<valor> ...
+//   ping                                       ->  ok
+// donde <res> es "ok", "eN" (errno N) o "xN" (el comando salió con código N).
+// Cualquier error de protocolo se responde con "err <motivo>".
+
+// Ruta del socket a usar (GLX_SOCKET o la ruta por defecto)
+const char* glxd_socket_path(void);
+
+// Enviar un lote de escrituras al daemon y completar el resultado de cada una
+// Retorna 0 si el daemon respondió, GLXD_AUSENTE si no hay daemon (no tiene
+// socket, nadie escucha o el usuario no tiene permiso) y GLXD_FALLO con errno
+// si no respondió a tiempo o respondió con un error
+int glxd_aplicar(KnobWrite* writes, int cantidad);
+
+// Pedir al daemon los valores actuales de todos los knobs legibles
+// valores[i] queda vacío si el knob no se pudo leer
+// Retorna 0 si el daemon respondió, distinto de 0 si no
+int glxd_consultar(char valores[KNOB_COUNT][32]);
+
+#endif // GLXD_H
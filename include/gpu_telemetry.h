@@ -0,0 +1,47 @@
+#ifndef GPU_TELEMETRY_H
+#define GPU_TELEMETRY_H
+
+// Telemetría de GPU con un único proceso nvidia-smi persistente
+// (nvidia-smi --query-gpu=... --format=csv -lms N) cuya salida se parsea
+// de forma incremental. Los consumidores solo copian la última muestra.
+// GLX_NVIDIA_SMI permite usar otro ejecutable (por ejemplo uno falso para pruebas).
+
+// Última muestra recibida
+typedef struct {
+    int valida;                 // 1 si ya llegó al menos una línea
+    char linea[256];            // Línea CSV tal cual la imprimió nvidia-smi
+    char nombre[96];
+    double potencia_w;          // -1 si nvidia-smi reporta [N/A]
+    int temperatura_c;          // -1 si no está disponible
+    int reloj_mhz;              // -1 si no está disponible
+    int persistencia;           // persistence_mode: 1, 0 o -1 si no vino
+    long long timestamp_ms;     // CLOCK_MONOTONIC al recibir la muestra
+} GpuSample;
+
+// Lanzar el proceso productor con el intervalo indicado (ms)
+// Retorna 0 si se lanzó, -1 si no se pudo crear el proceso
+int gpu_telemetry_iniciar(int intervalo_ms);
+
+// Descriptor del pipe del productor (para usar en poll); -1 si no hay productor
+int gpu_telemetry_fd(void);
+
+// 1 si hay un productor iniciado (aunque esté esperando para relanzarse)
+int gpu_telemetry_activa(void);
+
+// Consumir sin bloquear lo que haya en el pipe y relanzar el proceso si murió
+void gpu_telemetry_actualizar(void);
+
+// Copiar la última muestra; retorna 1 si hay una muestra válida
+int gpu_telemetry_ultima(GpuSample* sample);
+
+// Esperar hasta timeout_ms por la primera muestra (corta antes si el proceso muere)
+// Retorna 1 si hay una muestra válida
+int gpu_telemetry_esperar(GpuSample* sample, int timeout_ms);
+
+// Terminar el proceso productor
+void gpu_telemetry_detener(void);
+
+// Parsear una línea CSV de nvidia-smi (expuesto para pruebas)
+int gpu_telemetry_parsear_linea(const char* linea, GpuSample* sample);
+
+#endif // GPU_TELEMETRY_H
@@ -0,0 +1,80 @@
+#ifndef GXC_H
+#define GXC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "parser.h"
+
+// Bytecode de programas .gx
+// El AST se compila a instrucciones de ancho fijo con los operandos ya
+// resueltos (parámetros como ParamId de params.def, literales en un
+// pool de constantes). El resultado se guarda junto a la fuente como
+// archivo.gxc y se valida con mtime/tamaño/hash de la fuente, igual que la
+// caché de modos; con una caché válida "gx archivo.gx" no tokeniza ni parsea.
+
+#define GXC_MAGIC 0x31435847u      // "GXC1"
+// Subir la versión si cambian los opcodes o el formato; un cambio en
+// params.def lo detecta la huella del header
+#define GXC_VERSION 5
+
+typedef enum {
+    GXC_OP_DECLARE,         // a = ParamId, b = valor
+    GXC_OP_DECLARE_NOMBRE,  // a = nombre de parámetro desconocido (para sugerencias), b = valor
+    GXC_OP_ASSIGN,          // a = variable, b = valor
+    GXC_OP_RUN_MODE,        // b = modo
+    GXC_OP_STATUS,
+    GXC_OP_COMMAND,         // a = comando
+    GXC_OP_LITERAL          // b = valor suelto
+} GxcOpcode;
+
+typedef struct {
+    uint8_t op;
+    uint8_t tipo;           // NodeType del operando b
+    uint16_t columna;
+    uint32_t linea;
+    uint32_t a;             // Índice de parámetro u offset en el pool de constantes
+    uint32_t b;             // Offset en el pool de constantes
+} GxcInstr;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t tam_instr;
+    uint32_t num_instr;
+    uint32_t tam_constantes;
+    uint32_t reservado;
+    int64_t fuente_mtime_ns;
+    int64_t fuente_tamano;
+    uint64_t fuente_hash;
+    uint64_t params_huella;     // param_tabla_huella() al compilar
+} GxcHeader;
+
+// Programa compilado: mapeado desde el .gxc o construido en memoria
+typedef struct {
+    void* mapa;             // Archivo mapeado (NULL si está en memoria)
+    size_t tamano;
+    void* memoria;          // Buffer propio cuando no viene de un archivo
+    const GxcInstr* codigo;
+    uint32_t num_instr;
+    const char* constantes;
+    uint32_t tam_constantes;
+} GxcPrograma;
+
+// Ruta del bytecode de una fuente ("perfil.gx" -> "perfil.gxc")
+void gxc_ruta(const char* fuente, char* buffer, size_t size);
+
+// Abrir el bytecode de una fuente si existe y sigue siendo válido
+// Retorna 0 si quedó listo para ejecutar, -1 si hay que compilar
+int gxc_abrir(const char* fuente, GxcPrograma* prog);
+
+// Compilar un AST y guardarlo junto a la fuente (si se puede escribir)
+// El programa queda en memoria aunque no se haya podido guardar
+// Retorna 1 si se guardó, 0 si solo quedó en memoria
+int gxc_compilar(const AST* ast, const char* fuente, GxcPrograma* prog);
+
+// Ejecutar el bytecode
+void gxc_ejecutar(const GxcPrograma* prog);
+
+void gxc_cerrar(GxcPrograma* prog);
+
+#endif // GXC_H
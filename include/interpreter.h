@@ -1,11 +1,28 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include <setjmp.h>
 #include "parser.h"
 
 // Función principal del interpreter
-// Recibe un nodo del AST y lo ejecuta
-void interpret_ast(ASTNode* node);
+// Recibe el AST de un programa y lo ejecuta desde la raíz
+void interpret_ast(const AST* ast);
+
+// Ejecutar un nodo del AST que se está ejecutando
+void interpret_node(ASTNode* node);
+
+// Nombre del archivo que se está ejecutando (para ubicar los diagnósticos)
+// NULL para comandos sueltos como "gx run"
+void interpret_set_fuente(const char* archivo);
+
+// Olvidar las variables y el modo GPU para ejecutar otro programa desde cero
+void interpret_reiniciar(void);
+
+// Sesión interactiva (gx shell): con un punto de recuperación, un error
+// crítico vuelve a él con longjmp en vez de terminar el proceso, la caché de
+// modos queda mapeada entre sentencias y no se anuncia cada programa.
+// NULL cierra la sesión
+void interpret_set_sesion(jmp_buf* recuperacion);
 
 // Funciones específicas para cada tipo de nodo
 void interpret_program(ASTNode* node);
@@ -17,4 +34,28 @@ void interpret_string(ASTNode* node);
 void interpret_gpu_command(ASTNode* node);
 void interpret_run_command(ASTNode* node);
 
+// Ejecución de sentencias sin depender del AST
+// Las usan interpret_* y la VM de bytecode (gxc.c); tipo_fuente es el tipo del
+// literal tal como lo dejó el parser (NODE_IDENTIFIER si hay que resolver una variable)
+void ejecutar_declaracion(const char* parametro, const char* valor_fuente, NodeType tipo_fuente);
+void ejecutar_parametro(int id, const char* valor_fuente, NodeType tipo_fuente);  // id = ParamId
+void ejecutar_asignacion(const char* nombre, const char* valor_fuente, NodeType tipo_fuente);
+int ejecutar_run(const char* valor_fuente, NodeType tipo_fuente);  // 1 si quedó aplicado
+void ejecutar_comando(const char* comando);
+void ejecutar_literal(const char* valor, NodeType tipo);
+
+// Marcar el inicio de una sentencia de archivo (imprime archivo:línea:columna)
+void interpret_marcar_sentencia(int linea, int columna);
+
+// Aplicar un modo de modelo.txt (ya validado) usando la caché compilada
+// Retorna 1 si todos los parámetros quedaron aplicados, 0 si hubo errores
+int ejecutar_modo(const char* modo);
+
+// ¿Hay un modo con este nombre? Los integrados en gx más los de modelo.txt
+int modo_disponible(const char* nombre);
+
+// Modo disponible más parecido (para "¿Quisiste decir?"); NULL si no hay.
+// Vale hasta la próxima consulta de modos
+const char* sugerir_modo(const char* palabra);
+
 #endif // INTERPRETER_H
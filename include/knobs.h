@@ -0,0 +1,96 @@
+#ifndef KNOBS_H
+#define KNOBS_H
+
+#include <stddef.h>
+#include "utils.h"
+
+// Parámetros de hardware que GLX sabe escribir
+typedef enum {
+    KNOB_DYNAMIC_BOOST,
+    KNOB_CPU_MAX_PERF,
+    KNOB_CPU_MIN_PERF,
+    KNOB_NO_TURBO,
+    KNOB_PERSIST_MODE,
+    KNOB_BATTERY_CONSERVATION,
+    KNOB_FNLOCK,
+    KNOB_PLATFORM_PROFILE,
+    KNOB_KBD_BACKLIGHT,
+    // cpufreq por clase de núcleo: cada uno escribe todas las policies de la clase
+    KNOB_CPU_EPP_P,
+    KNOB_CPU_EPP_E,
+    KNOB_CPU_GOVERNOR_P,
+    KNOB_CPU_GOVERNOR_E,
+    KNOB_CPU_MAX_FREQ_P,
+    KNOB_CPU_MAX_FREQ_E,
+    KNOB_CPU_MIN_FREQ_P,
+    KNOB_CPU_MIN_FREQ_E,
+    KNOB_COUNT
+} KnobId;
+
+// Una escritura pendiente y su resultado
+typedef struct {
+    KnobId id;
+    char valor[32];
+    KnobResult resultado;
+    int error;          // errno o código de salida cuando resultado == KNOB_ERROR
+    int via_comando;    // 1 si error es el código de salida de un comando externo
+    int duracion_us;    // Lo que tardó la escritura local (0 si no se hizo)
+} KnobWrite;
+
+// Raíz de sysfs (vacía = "/"); permite trabajar contra un árbol falso
+void knobs_set_root(const char* root);
+const char* knobs_get_root(void);
+
+// Backend nulo: las escrituras se dan por aplicadas sin tocar el sistema y
+// el estado actual se lee vacío (benchmarks del intérprete)
+void knobs_set_nulo(int activo);
+
+// Información de la tabla de knobs
+const char* knob_nombre(KnobId id);
+int knob_buscar(const char* nombre);
+int knob_validar(KnobId id, const char* valor);
+
+// Ruta absoluta del atributo sysfs del knob (ya con la raíz aplicada)
+// Retorna 0 si el knob no tiene atributo sysfs o no existe en este sistema
+// (los de cpufreq tienen uno por policy y no cuentan)
+int knob_ruta(KnobId id, char* buffer, size_t size);
+
+// Comando externo que aplica el knob cuando no hay atributo sysfs
+// Retorna 0 si el knob no tiene comando
+int knob_comando(KnobId id, const char* valor, char* buffer, size_t size);
+
+// Aplicar una escritura en este proceso (sysfs directo, sudo o comando)
+void knob_aplicar_local(KnobWrite* write);
+
+// Aplicar un lote de escrituras: usa glxd si está corriendo, si no las aplica localmente
+// Retorna la cantidad de knobs aplicados correctamente
+int knobs_aplicar(KnobWrite* writes, int cantidad);
+
+// Sesión (gx shell): abrir una vez el atributo sysfs de cada knob y usar
+// esos descriptores en knob_aplicar_local y knob_leer_local hasta cerrarla.
+// Los que no se pueden abrir sin privilegios siguen por el camino normal.
+// Retorna la cantidad de descriptores abiertos
+int knobs_sesion_abrir(void);
+void knobs_sesion_cerrar(void);
+
+// Leer el valor actual de un knob en este proceso (sysfs o comando de lectura)
+// Retorna 1 si se pudo leer
+int knob_leer_local(KnobId id, char* valor, size_t size);
+
+// Leer de una pasada el valor actual de todos los knobs (vía glxd si está corriendo)
+// valores[i] queda vacío si el knob no se pudo leer. Retorna la cantidad leída
+int knobs_leer_estado(char valores[KNOB_COUNT][32]);
+
+// Aplicar solo las escrituras cuyo valor difiere del estado actual del hardware
+// Las que ya coinciden quedan con resultado KNOB_UNCHANGED
+// Retorna la cantidad de knobs que hubo que escribir
+int knobs_aplicar_cambios(KnobWrite* writes, int cantidad);
+
+// Describir el error de una escritura fallida ("Permission denied", "código de salida 1"...)
+const char* knob_error_str(const KnobWrite* write, char* buffer, size_t size);
+
+// Preparar una escritura numérica o de texto
+void knob_write_init(KnobWrite* write, KnobId id, const char* valor);
+void knob_write_init_int(KnobWrite* write, KnobId id, int valor);
+
+#endif // KNOBS_H
@@ -1,13 +1,31 @@
 #ifndef LEXER_H
 #define LEXER_H
 
-// Función para tokenizar una línea de texto
-// Recibe: una línea de texto y un puntero donde guardar la cantidad de tokens
-// Retorna: un array de strings (tokens)
-char** lexer_tokenize(const char* linea, int* cantidad);
+#include <stddef.h>
+#include "arena.h"
 
-// Función para liberar la memoria de los tokens
+// Tipos de token: el fin de línea es un token propio porque separa sentencias
+typedef enum {
+    TOKEN_TEXTO,
+    TOKEN_FIN_LINEA
+} TokenType;
+
+// Token con su posición en la fuente (línea y columna empiezan en 1)
+typedef struct {
+    TokenType tipo;
+    char* texto;       // "\n" para TOKEN_FIN_LINEA; vive en la arena
+    int linea;
+    int columna;
+} Token;
+
+// Función para tokenizar un texto completo (una línea o un archivo entero)
+// Recibe: el texto, su longitud, un puntero donde guardar la cantidad de tokens
+// y la arena donde quedan los textos (debe vivir tanto como el AST)
+// Retorna: un array de tokens con una entrada TOKEN_FIN_LINEA al final de cada línea
+Token* lexer_tokenize(const char* texto, size_t len, int* cantidad, Arena* arena);
+
+// Función para liberar el array de tokens (los textos se van con la arena)
 // Recibe: el array de tokens y la cantidad de tokens
-void liberar_tokens(char** tokens, int cantidad);
+void liberar_tokens(Token* tokens, int cantidad);
 
-#endif // LEXER_H 
\ No newline at end of file
+#endif // LEXER_H 
@@ -0,0 +1,63 @@
+#ifndef MODE_CACHE_H
+#define MODE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "utils.h"
+
+// Caché binaria de modelo.txt
+// Se guarda en $XDG_CACHE_HOME/glx (o ~/.cache/glx) y se abre con mmap; la
+// búsqueda de un modo no parsea texto ni reserva memoria. La caché es válida
+// mientras coincidan mtime y tamaño de la fuente; si solo cambió el mtime se
+// compara el hash del contenido antes de recompilar.
+
+#define MODE_CACHE_MAGIC 0x43584c47u   // "GLXC"
+#define MODE_CACHE_VERSION 3
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t tam_modo;          // sizeof(GPU_Mode) al compilar
+    uint32_t num_modos;
+    int64_t fuente_mtime_ns;
+    int64_t fuente_tamano;
+    uint64_t fuente_hash;       // FNV-1a de 64 bits del contenido
+} ModeCacheHeader;
+
+typedef struct {
+    void* mapa;
+    size_t tamano;
+    const GPU_Mode* modos;
+    int num_modos;
+} ModeCache;
+
+// Abrir la caché de una fuente, compilándola si falta o quedó vieja
+// Retorna 0 si la caché quedó lista, -1 si hay que usar load_gpu_modes
+int mode_cache_abrir(const char* fuente, ModeCache* cache);
+
+// Buscar un modo por nombre dentro de la caché abierta
+const GPU_Mode* mode_cache_buscar(const ModeCache* cache, const char* nombre);
+
+void mode_cache_cerrar(ModeCache* cache);
+
+// 1 si la caché abierta sigue correspondiendo a la fuente (mismo mtime y
+// tamaño); para quien la deja mapeada entre usos, como "gx shell"
+int mode_cache_vigente(const ModeCache* cache, const char* fuente);
+
+// Compilar explícitamente la caché de una fuente ("gx modes compile")
+// Guarda en ruta_cache dónde quedó. Retorna la cantidad de modos o -1 si falló
+int mode_cache_compilar(const char* fuente, char* ruta_cache, size_t size);
+
+// Utilidades compartidas con otras cachés de GLX (bytecode .gxc)
+struct stat;
+
+// Hash FNV-1a de 64 bits
+uint64_t fnv1a64(const void* datos, size_t len);
+
+// Hash del contenido completo de un archivo; 0 si se pudo leer
+int cache_hash_archivo(const char* ruta, uint64_t* hash);
+
+// mtime de un stat en nanosegundos
+int64_t cache_mtime_ns(const struct stat* st);
+
+#endif // MODE_CACHE_H
@@ -0,0 +1,29 @@
+#ifndef OPTIMIZADOR_H
+#define OPTIMIZADOR_H
+
+#include "parser.h"
+#include "arena.h"
+
+// Pasada estática sobre el AST, entre el parser y el bytecode
+// Recorre el programa en orden con una tabla de símbolos propia y:
+//   - reemplaza cada variable usada como valor por su constante (o por su
+//     sensor, si está ligada a uno)
+//   - reporta antes de ejecutar nada los errores que en ejecución abortan a
+//     mitad de camino (variable no definida, conflicto de tipos, parámetro
+//     desconocido, sensor desconocido, valor fuera de rango)
+//   - deja solo la última de varias declaraciones válidas del mismo
+//     parámetro; "mode:", "run", "status" y otros comandos cortan la secuencia
+// Las asignaciones no se eliminan: "vars" y la advertencia de
+// sobrescritura las muestran.
+
+typedef struct {
+    int errores;            // Errores fatales; si hay alguno no se ejecuta
+    int constantes;         // Variables reemplazadas por su valor
+    int eliminadas;         // Declaraciones redundantes quitadas
+} OptInforme;
+
+// Optimizar el programa en el lugar; los valores nuevos van a la arena del AST
+// Retorna 0 si se puede ejecutar, -1 si se encontraron errores
+int optimizar_ast(AST* ast, Arena* arena, const char* archivo, OptInforme* informe);
+
+#endif // OPTIMIZADOR_H
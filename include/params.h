@@ -0,0 +1,80 @@
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Registro de parámetros generado desde params.def
+// param_buscar resuelve un nombre con un hash perfecto calculado al compilar
+// (tools/gen_params_hash.c) y una sola comparación de strings.
+
+typedef enum {
+#define PARAM(nombre, tipo, min, max, formato, etiqueta, knob) PARAM_##nombre,
+#include "params.def"
+#undef PARAM
+    PARAM_COUNT
+} ParamId;
+
+typedef enum {
+    PARAM_TIPO_ENTERO,
+    PARAM_TIPO_COLOR,
+    PARAM_TIPO_MODO,
+    PARAM_TIPO_OPCION       // El valor es el índice de la palabra en su lista
+} ParamTipo;
+
+typedef enum {
+    PARAM_FMT_NUMERO,       // "1"
+    PARAM_FMT_PORCENTAJE,   // "85%"
+    PARAM_FMT_ON_OFF,       // 1 = "ON"
+    PARAM_FMT_OFF_ON,       // 1 = "OFF" (turbo_boost se escribe en no_turbo)
+    PARAM_FMT_MHZ,          // "2400 MHz"
+    PARAM_FMT_EPP,          // Opciones de energy_performance_preference
+    PARAM_FMT_GOBERNADOR    // Opciones de scaling_governor
+} ParamFormato;
+
+#define PARAM_SIN_KNOB -1
+
+typedef struct {
+    const char* nombre;
+    ParamTipo tipo;
+    int min;
+    int max;
+    ParamFormato formato;
+    const char* etiqueta;
+    int knob;               // KnobId o PARAM_SIN_KNOB
+} ParamInfo;
+
+extern const ParamInfo param_tabla[PARAM_COUNT];
+
+// Buscar un parámetro por nombre; retorna su ParamId o -1
+int param_buscar(const char* nombre);
+
+// Huella de params.def (orden, tipos, rangos, formatos y knobs); la guarda
+// el bytecode para no ejecutar ParamId de otra versión de la tabla
+uint64_t param_tabla_huella(void);
+
+// Texto de un valor entero según el formato del parámetro ("85%", "ON"...)
+const char* param_formatear(const ParamInfo* param, int valor, char* buffer, size_t size);
+
+// Palabras válidas de un parámetro OPCION (NULL si no es OPCION)
+const char** param_opciones(const ParamInfo* param, int* cantidad);
+
+// Índice de una palabra en la lista del parámetro; -1 si no está
+int param_opcion_buscar(const ParamInfo* param, const char* texto);
+
+// Hash de los nombres (FNV-1a de 32 bits con semilla); lo comparten el
+// generador y param_buscar
+static inline uint32_t param_hash(const char* nombre, uint32_t semilla) {
+    uint32_t hash = 2166136261u ^ semilla;
+    for (const unsigned char* p = (const unsigned char*)nombre; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    // Mezclar los bits altos: el slot se toma de los bits bajos
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+#endif // PARAMS_H
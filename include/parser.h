@@ -1,6 +1,10 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <stdint.h>
+#include "lexer.h"
+#include "arena.h"
+
 // Tipos de nodos del AST
 typedef enum {
     NODE_PROGRAM,      // Programa completo
@@ -10,30 +14,53 @@ typedef enum {
     NODE_NUMBER,       // Número literal
     NODE_STRING,       // String literal
     NODE_GPU_COMMAND,  // Comando especifico para la GPU
-    NODE_RUN_COMMAND   // Comando run mode:X
+    NODE_RUN_COMMAND,  // Comando run mode:X
+    NODE_SENSOR        // Valor en vivo "sensor:nombre" (value = nombre del sensor)
 } NodeType;
 
+// Índice de un nodo dentro de AST.nodos
+typedef uint32_t NodeId;
+
 // Estructura para un nodo del AST
+// Los hijos no son punteros: ocupan el rango [primer_hijo, primer_hijo + num_children)
+// del array AST.hijos, que guarda índices de nodos
 typedef struct ASTNode {
     NodeType type;
-    char* value;       // Valor del nodo (si aplica)
-    struct ASTNode** children;  // Array de nodos hijos
+    char* value;       // Valor del nodo (si aplica); vive en la arena
+    uint32_t primer_hijo;
     int num_children;  // Cantidad de nodos hijos
+    int linea;         // Posición en la fuente (0 si no viene de un token)
+    int columna;
 } ASTNode;
 
+// AST plano de un programa: nodos contiguos y rangos de hijos
+// Todo se reserva en la arena del programa; la raíz es siempre nodos[0]
+typedef struct {
+    ASTNode* nodos;
+    uint32_t num_nodos;
+    NodeId* hijos;
+    uint32_t num_hijos;
+} AST;
+
 // Estructura para el parser
 typedef struct {
-    char** tokens;     // Array de tokens
+    Token* tokens;     // Array de tokens
     int num_tokens;    // Cantidad de tokens
     int current_pos;   // Posición actual en el array de tokens
+    AST* ast;
+    Arena* arena;
+    NodeId* pila;      // Hijos pendientes de los nodos en construcción
+    uint32_t tope;
 } Parser;
 
 // Funciones principales del parser
-ASTNode* parser_parse(char** tokens, int num_tokens);
-void parser_free_ast(ASTNode* node);
+// Arma un único NODE_PROGRAM con una sentencia por línea; todo queda en la arena
+AST* parser_parse(Token* tokens, int num_tokens, Arena* arena);
+
+// Raíz del programa
+ASTNode* ast_raiz(const AST* ast);
 
-// Funciones auxiliares para crear y manipular nodos
-ASTNode* create_node(NodeType type, const char* value);
-void add_child(ASTNode* parent, ASTNode* child);
+// Hijo i de un nodo (NULL si no existe)
+ASTNode* ast_hijo(const AST* ast, const ASTNode* node, int i);
 
 #endif
@@ -0,0 +1,53 @@
+#ifndef PROCESOS_H
+#define PROCESOS_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// Fuentes de eventos de procesos para "gx auto"
+// El conector de procesos del kernel (NETLINK_CONNECTOR, CN_IDX_PROC) avisa
+// de cada exec/exit sin leer /proc; necesita CAP_NET_ADMIN. Sin él queda un
+// escaneo incremental de /proc que solo inspecciona los PIDs nuevos desde la
+// pasada anterior y reporta como terminados los que desaparecieron.
+
+#define PROCESOS_ESCANEO_MS 1000
+
+typedef enum {
+    PROCESO_EXEC,
+    PROCESO_EXIT
+} ProcesoTipo;
+
+typedef struct {
+    ProcesoTipo tipo;
+    pid_t pid;
+} ProcesoEvento;
+
+typedef void (*ProcesoCallback)(const ProcesoEvento* evento, void* ctx);
+
+// Suscribirse al conector; -1 si no está disponible (sin permisos o sin soporte)
+int procesos_conector_abrir(void);
+
+// Leer los eventos pendientes del socket (solo líderes de grupo: un hilo
+// nuevo no es un proceso nuevo). Retorna la cantidad entregada al callback,
+// o -1 si el kernel descartó eventos y hay que resincronizar con /proc
+int procesos_conector_leer(int fd, ProcesoCallback cb, void* ctx);
+
+typedef struct {
+    pid_t* vistos;              // PIDs de la pasada anterior, ordenados
+    size_t num_vistos;
+    pid_t* actuales;            // Buffer de la pasada en curso
+    size_t capacidad;
+} ProcesoEscaneo;
+
+// Recorrer /proc: PROCESO_EXEC por cada PID que no estaba y PROCESO_EXIT por
+// cada uno que ya no está. La primera pasada reporta todos como nuevos
+// Retorna 0 si se pudo leer /proc, -1 si no
+int procesos_escanear(ProcesoEscaneo* escaneo, ProcesoCallback cb, void* ctx);
+
+void procesos_escaneo_liberar(ProcesoEscaneo* escaneo);
+
+// Nombre (comm) y ejecutable (/proc/PID/exe) de un proceso; exe queda vacío
+// si no hay permiso para leerlo. Retorna 0 si el proceso existe, -1 si no
+int procesos_identificar(pid_t pid, char* comm, size_t comm_size, char* exe, size_t exe_size);
+
+#endif // PROCESOS_H
@@ -0,0 +1,78 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <stdint.h>
+
+// Grabación binaria de telemetría ("gx record", "gx replay", "gx export")
+//
+// Formato (.glxr, little-endian, solo se agrega al final):
+//   RecordHeader                        descripción de los campos
+//   RecordBlock, RecordBlock, ...       bloques de tamaño fijo
+//
+// Cada bloque lleva el tiempo y los valores absolutos de su primera muestra y
+// luego hasta RECORD_MUESTRAS_POR_BLOQUE muestras de ancho fijo con el delta
+// de tiempo (ms) y el delta de cada campo respecto de la anterior. Como todos
+// los bloques miden lo mismo, los encabezados de bloque hacen de índice: para
+// ir a un instante se busca el bloque por búsqueda binaria sobre t0_ms.
+
+#define RECORD_MAGIC "GLXREC1"
+#define RECORD_VERSION 1
+#define RECORD_BLOQUE_MAGIC 0x4b4c4247u    // "GBLK"
+#define RECORD_MUESTRAS_POR_BLOQUE 256
+
+typedef enum {
+    RECORD_CAMPO_CPU_MAX_PERF,
+    RECORD_CAMPO_NO_TURBO,
+    RECORD_CAMPO_AC_ONLINE,
+    RECORD_CAMPO_GPU_POTENCIA,      // centésimas de watt
+    RECORD_CAMPO_GPU_TEMPERATURA,
+    RECORD_CAMPO_GPU_RELOJ,
+    RECORD_NUM_CAMPOS
+} RecordCampo;
+
+typedef struct {
+    char nombre[16];
+    uint32_t escala;                // valor real = valor guardado / escala
+    uint32_t reservado;
+} RecordCampoInfo;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t tam_header;
+    uint32_t intervalo_ms;
+    uint32_t num_campos;
+    uint32_t muestras_por_bloque;
+    uint32_t tam_bloque;
+    int64_t inicio_unix_ms;         // Hora real de la primera muestra
+    RecordCampoInfo campos[RECORD_NUM_CAMPOS];
+} RecordHeader;
+
+typedef struct {
+    uint16_t dt_ms;                 // Tiempo desde la muestra anterior
+    int16_t delta[RECORD_NUM_CAMPOS];
+} RecordMuestra;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t num_muestras;          // Muestras válidas (el último bloque puede ir incompleto)
+    int64_t t0_ms;                  // Tiempo de la primera muestra desde el inicio
+    int32_t base[RECORD_NUM_CAMPOS];
+    RecordMuestra muestras[RECORD_MUESTRAS_POR_BLOQUE];   // muestras[0] es la base (deltas en 0)
+} RecordBlock;
+
+typedef enum {
+    RECORD_FORMATO_TABLA,
+    RECORD_FORMATO_CSV,
+    RECORD_FORMATO_JSON
+} RecordFormato;
+
+// Grabar a hz muestras por segundo durante duracion_s (<= 0: hasta Ctrl+C)
+// Retorna 0 si la grabación quedó escrita, 1 si hubo un error
+int record_grabar(const char* archivo, int hz, double duracion_s);
+
+// Emitir las muestras con tiempo en [desde_ms, hasta_ms] (hasta_ms < 0: hasta el final)
+// Retorna 0 si el archivo es válido, 1 si no
+int record_exportar(const char* archivo, RecordFormato formato, long long desde_ms, long long hasta_ms);
+
+#endif // RECORD_H
@@ -0,0 +1,59 @@
+#ifndef SALIDA_H
+#define SALIDA_H
+
+// Capa de salida de gx al ejecutar programas
+// Todo pasa por stdout con un buffer completo (un solo writer); el nivel
+// decide qué se muestra y --format=json reemplaza el texto para humanos por
+// un registro JSON por línea (sentencias ejecutadas, knobs aplicados, errores).
+
+typedef enum {
+    SALIDA_SILENCIOSA,      // Solo errores
+    SALIDA_NORMAL,          // Resultado de cada sentencia
+    SALIDA_DEBUG_TOKENS,    // Además los tokens del lexer
+    SALIDA_DEBUG_AST        // Además el AST
+} SalidaNivel;
+
+typedef enum {
+    SALIDA_TEXTO,
+    SALIDA_JSON
+} SalidaFormato;
+
+// Interpretar una opción global (-q, --quiet, --debug-tokens, --debug-ast,
+// --format=text|json). Retorna 1 si la reconoció, 0 si no es una opción de
+// salida y -1 si el valor es inválido
+int salida_opcion(const char* arg);
+
+SalidaNivel salida_nivel(void);
+int salida_json(void);
+
+// 1 si corresponde mostrar texto de ese nivel (siempre 0 en modo JSON)
+int salida_muestra(SalidaNivel nivel);
+
+// Pasar stdout a buffer completo; llamar antes de escribir nada
+void salida_buffer_completo(void);
+
+// Vaciar el buffer (antes de leer stdin o lanzar procesos que escriben)
+void salida_vaciar(void);
+
+// Texto para humanos de nivel normal
+void salida_printf(const char* formato, ...) __attribute__((format(printf, 1, 2)));
+
+// Texto de depuración (tokens, AST)
+void salida_debug(SalidaNivel nivel, const char* formato, ...) __attribute__((format(printf, 2, 3)));
+
+// Errores: se muestran en todos los niveles; en JSON salen como registro "error"
+void salida_error(const char* formato, ...) __attribute__((format(printf, 1, 2)));
+
+// Pregunta interactiva: va a stderr si stdout no es texto para humanos
+void salida_pregunta(const char* formato, ...) __attribute__((format(printf, 1, 2)));
+
+// Sentencia en ejecución; se agrega a cada registro JSON
+void salida_ubicacion(const char* archivo, int linea, int columna);
+
+// Registros JSON: inicio, campos y fin (no hacen nada en modo texto)
+void salida_json_inicio(const char* evento);
+void salida_json_texto(const char* clave, const char* valor);
+void salida_json_entero(const char* clave, long long valor);
+void salida_json_fin(void);
+
+#endif // SALIDA_H
@@ -0,0 +1,39 @@
+#ifndef SENSORES_H
+#define SENSORES_H
+
+// Sensores del lenguaje .gx ("t = sensor:gpu_temp")
+// Registro de fuentes en vivo armado sobre los lectores de status y la
+// telemetría de GPU. Una variable ligada a un sensor no se lee al asignarla:
+// la primera vez que se usa se lee la fuente y el valor queda en caché
+// durante sensor_ttl_ms (por defecto SENSORES_TTL_DEFECTO_MS), así que un
+// script que consulta el mismo sensor muchas veces hace una sola lectura.
+
+#define SENSORES_TTL_DEFECTO_MS 1000
+
+// Nombres de los sensores (para sugerencias)
+extern const char* sensores_validos[];
+extern const int num_sensores;
+
+// Buscar un sensor por nombre; retorna su índice o -1
+int sensor_buscar(const char* nombre);
+
+const char* sensor_nombre(int id);
+
+// 1 si el sensor da un número, 0 si da texto (platform_profile)
+int sensor_es_numero(int id);
+
+// Valor actual del sensor como texto (y como número si aplica), desde la
+// caché mientras no venza el TTL. Retorna NULL si la fuente no está disponible
+const char* sensor_leer(int id, long long* numero);
+
+// Última lectura guardada del sensor, sin leer la fuente aunque haya vencido
+// el TTL (para mostrarla, como en "vars"). NULL si todavía no se leyó
+const char* sensor_cacheado(int id);
+
+// Cambiar el TTL de la caché (0 = leer en cada uso)
+void sensores_set_ttl(int ttl_ms);
+
+// Olvidar la caché y volver al TTL por defecto (otro programa desde cero)
+void sensores_reiniciar(void);
+
+#endif // SENSORES_H
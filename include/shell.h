@@ -0,0 +1,25 @@
+#ifndef SHELL_H
+#define SHELL_H
+
+// REPL de .gx ("gx shell")
+// Cada línea pasa por lexer_tokenize, parser_parse e interpret_ast como un
+// programa de una sentencia, pero el proceso no se reinicia entre líneas:
+// las variables siguen definidas, la caché de modos queda mapeada, las
+// fuentes de status y los atributos de los knobs quedan abiertos y el
+// productor de nvidia-smi sigue corriendo. Un error crítico corta solo la
+// línea en curso.
+
+// Intervalo del productor de GPU mientras dura la sesión
+#define SHELL_GPU_INTERVALO_MS 500
+
+// Cada cuánto se revisa el productor si no llega nada (para relanzarlo)
+#define SHELL_ESPERA_MS 1000
+
+// Largo máximo de una línea con su salto; una más larga se rechaza entera
+#define SHELL_LINEA_MAX 1024
+
+// Leer y ejecutar líneas de stdin hasta EOF, "salir" o SIGTERM
+// Retorna 0
+int shell_ejecutar(void);
+
+#endif // SHELL_H
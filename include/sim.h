@@ -0,0 +1,27 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Simulador de hardware para pruebas y benchmarks sin laptop Legion ni GPU
+// El árbol lo arma "sim/glx-sim crear DIR": un sysfs falso (intel_pstate,
+// policies de cpufreq, platform_profile, power_supply, kbd_backlight) y un
+// DIR/bin con nvidia-smi, legion_cli y sudo falsos.
+//
+// Latencia y fallas por operación se configuran con variables de entorno
+// que leen tanto gx como los ejecutables falsos:
+//   GLX_SIM_LATENCIA="sysfs=2,nvidia-smi=40,legion_cli=25"   (milisegundos)
+//   GLX_SIM_FALLAS="fnlock=1,nvidia-smi=0.2"                  (probabilidad)
+//   GLX_SIM_SEMILLA=N                                         (fallas reproducibles)
+// Una operación se busca primero por nombre (knob o fuente de status), luego
+// por su clase ("sysfs") y por último en la regla "*".
+
+// Activar el simulador sobre el árbol dir: redirige sysfs, antepone DIR/bin
+// al PATH y exporta GLX_SIM para los procesos hijos. 0 si el árbol existe
+int sim_activar(const char* dir);
+
+int sim_activo(void);
+
+// Aplicar la latencia y la falla configuradas para una operación
+// Retorna 0 si la operación debe seguir, -1 con errno = EIO si falla
+int sim_operacion(const char* nombre, const char* clase);
+
+#endif // SIM_H
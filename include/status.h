@@ -0,0 +1,73 @@
+#ifndef STATUS_H
+#define STATUS_H
+
+#include <stddef.h>
+
+// Fuentes de sysfs/procfs que lee el colector de estado
+// (la misma lista la usan los demás consumidores de telemetría)
+typedef enum {
+    STATUS_SRC_CPUINFO,
+    STATUS_SRC_MEMINFO,
+    STATUS_SRC_MAX_PERF,
+    STATUS_SRC_MIN_PERF,
+    STATUS_SRC_DYNAMIC_BOOST,
+    STATUS_SRC_NO_TURBO,
+    STATUS_SRC_AC_ONLINE,
+    STATUS_SRC_PLATFORM_PROFILE,
+    STATUS_SRC_COUNT
+} StatusSourceId;
+
+// Estado del sistema recolectado en una pasada (-1 = no disponible)
+typedef struct {
+    char cpu_modelo[128];
+    long mem_total_kb;
+    long mem_libre_kb;
+    long mem_disponible_kb;
+    int cpu_max_perf;
+    int cpu_min_perf;
+    int dynamic_boost;
+    int no_turbo;
+    int ac_online;
+    char platform_profile[32];
+} SystemStatus;
+
+// Nombre corto de una fuente ("max_perf", "ac_online"...)
+const char* status_fuente_nombre(StatusSourceId id);
+
+// Ruta de la fuente con la raíz de sysfs aplicada (GLX_SYSFS_ROOT)
+// Retorna 0 si ninguna de las rutas candidatas existe
+int status_fuente_ruta(StatusSourceId id, char* buffer, size_t size);
+
+// Leer todas las fuentes directamente, sin lanzar procesos
+void status_recolectar(SystemStatus* status);
+
+// Leer una sola fuente (los sensores de .gx); el resto de status queda en -1
+// Retorna 0 si la fuente no está disponible
+int status_leer_fuente(StatusSourceId id, SystemStatus* status);
+
+// Interpretar el contenido de una fuente ya leída y guardarlo en status
+void status_parsear_fuente(SystemStatus* status, StatusSourceId id, const char* contenido);
+
+// Muestreador continuo: abre cada fuente una sola vez y la relee con pread
+// (lo usan watch y record; /proc/cpuinfo se lee una vez al abrir)
+typedef struct {
+    int fds[STATUS_SRC_COUNT];      // -1 si la fuente no existe
+    char cpu_modelo[128];
+} StatusSampler;
+
+// Abrir las fuentes; retorna la cantidad de fuentes abiertas
+int status_sampler_abrir(StatusSampler* sampler);
+
+// Releer todas las fuentes abiertas sin volver a abrirlas
+void status_sampler_leer(StatusSampler* sampler, SystemStatus* status);
+
+void status_sampler_cerrar(StatusSampler* sampler);
+
+// Muestreador abierto que usan status_recolectar y status_leer_fuente en vez
+// de abrir cada fuente (gx shell); NULL vuelve a abrirlas en cada lectura
+void status_usar_sampler(StatusSampler* sampler);
+
+// Recolectar e imprimir el estado completo (comando "status")
+void status_mostrar(void);
+
+#endif // STATUS_H
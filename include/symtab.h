@@ -0,0 +1,60 @@
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+// Tabla de símbolos de las variables de un programa .gx
+// Hash con direccionamiento abierto (sondeo lineal) sobre un arreglo de
+// símbolos en orden de definición, que es el orden en que "vars" los lista.
+// Los nombres se internan en una arena: cada nombre se copia una sola vez y
+// un símbolo se identifica por su puntero. Los números se guardan como
+// enteros al asignarlos; el texto crece según haga falta. Una tabla en cero
+// es una tabla vacía válida.
+
+typedef enum {
+    SYM_NUMERO,
+    SYM_TEXTO
+} SymTipo;
+
+typedef struct {
+    const char* nombre;         // Internado en la arena de la tabla
+    uint32_t hash;
+    SymTipo tipo;
+    long long numero;           // Valor si tipo == SYM_NUMERO
+    char* texto;                // Valor como texto (también para números)
+    size_t cap_texto;
+    int sensor;                 // Sensor + 1 si la variable está ligada a uno (0 = valor fijo)
+} Simbolo;
+
+typedef struct {
+    Simbolo* simbolos;          // En orden de definición
+    uint32_t cantidad;
+    uint32_t cap_simbolos;
+    uint32_t* indice;           // Slot -> posición + 1 en simbolos (0 = libre)
+    uint32_t cap_indice;        // Potencia de 2
+    Arena nombres;
+} SymTab;
+
+// Buscar un símbolo por nombre; NULL si no está definido
+Simbolo* symtab_buscar(SymTab* tabla, const char* nombre);
+
+// Definir un símbolo nuevo (el nombre no debe existir) sin valor asignado
+Simbolo* symtab_definir(SymTab* tabla, const char* nombre);
+
+// Guardar un valor en un símbolo (texto es el literal tal como se escribió)
+// Un valor fijo reemplaza la ligadura a un sensor
+void symtab_asignar_numero(Simbolo* simbolo, long long numero, const char* texto);
+void symtab_asignar_texto(Simbolo* simbolo, const char* texto);
+
+// Ligar un símbolo a un sensor; el valor se completa al leerlo
+// (texto queda como "sensor:nombre" hasta la primera lectura)
+void symtab_ligar_sensor(Simbolo* simbolo, int sensor, SymTipo tipo, const char* nombre_sensor);
+
+// Actualizar el valor leído de un sensor sin perder la ligadura
+void symtab_refrescar(Simbolo* simbolo, long long numero, const char* texto);
+
+void symtab_liberar(SymTab* tabla);
+
+#endif // SYMTAB_H
@@ -1,40 +1,101 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "params.h"
+
 
 // Listas de palabras válidas para fuzzy match
-extern const char* modos_validos[];
-extern const int num_modos;
 extern const char* parametros_validos[];
 extern const int num_parametros;
 extern const char* comandos_gpu_validos[];
 extern const int num_comandos_gpu;
 
 int levenshtein(const char* s1, const char* s2);
+
+// Sugerir la palabra de la lista más cercana (a igual distancia, la primera)
+// Retorna NULL si la palabra ya está en la lista, nada queda a max_distancia
+// o la palabra pasa de 256 caracteres.
+// La primera llamada con cada lista arma su índice, así que la lista debe ser
+// fija durante todo el proceso (las listas de arriba)
 const char* sugerir_palabra(const char* palabra, const char** lista, int cantidad, int max_distancia);
 
+// Igual, para listas que cambian durante el proceso (los nombres de modos,
+// que dependen de modelo.txt): no arma índice y recorre la lista entera
+const char* sugerir_palabra_variable(const char* palabra, const char** lista, int cantidad, int max_distancia);
+
 // Función para ejecutar comandos del sistema y capturar su salida
 char* execute_system_command(const char* command);
 
+// Ejecutar un comando del sistema y devolver su código de salida (0 = éxito)
+int execute_system_command_status(const char* command);
+
+// Rutas de sysfs de los parámetros que se escriben directamente
+#define INTEL_PSTATE_DIR "/sys/devices/system/cpu/intel_pstate"
+#define PLATFORM_PROFILE_PATH "/sys/firmware/acpi/platform_profile"
+#define PLATFORM_PROFILE_LEGACY_PATH "/sys/devices/pci0000:00/0000:00:1f.0/PNP0C09:00/platform-profile/platform-profile-0/profile"
+#define KBD_BACKLIGHT_PATH "/sys/devices/pci0000:00/0000:00:1f.0/PNP0C09:00/VPC2004:00/leds/platform::kbd_backlight/brightness"
+
+// Resultado de escribir un parámetro (knob) del sistema
+typedef enum {
+    KNOB_OK = 0,        // Escrito directamente con open/write/close
+    KNOB_OK_PRIVILEGED, // El acceso directo dio EACCES y se escribió con sudo
+    KNOB_OK_DAEMON,     // Lo escribió el daemon privilegiado glxd
+    KNOB_UNCHANGED,     // El hardware ya tenía ese valor, no se escribió
+    KNOB_ERROR          // No se pudo escribir (errno indica la causa)
+} KnobResult;
+
+// Escribir un atributo de sysfs sin lanzar procesos cuando hay permisos
+KnobResult write_sysfs_knob(const char* path, const char* value);
+// Igual pero sin recurrir a sudo: un EACCES queda en errno para el llamador
+KnobResult write_sysfs_knob_directo(const char* path, const char* value);
+// Escribir el mismo valor en varias rutas con un solo "sudo tee" (sin shell)
+// Con KNOB_ERROR, errno es EACCES si sudo o tee fallaron
+KnobResult write_sysfs_knob_sudo(const char* const* paths, int cantidad, const char* value);
+KnobResult write_sysfs_knob_int(const char* path, int value);
+const char* knob_result_str(KnobResult result);
+
 typedef struct {
     char name[50];
-    int dynamic_boost;
-    int cpu_max_perf;
-    int cpu_min_perf;
-    int turbo_boost;
-    int persist_mode;
-    int battery_conservation;
-    int fnlock;
-    char rgb_color[20];      // Color RGB: "blue", "white", "red"
-    int rgb_brightness;      // Brillo RGB: 0-100
+    int valores[PARAM_COUNT];   // Parámetros enteros (y el índice de los OPCION), indexados por ParamId
+    char rgb_color[20];         // Color RGB: "blue", "white", "red"
+    uint64_t definidos;         // Bit (1 << ParamId) de cada parámetro que el modo define
 } GPU_Mode;
 
+_Static_assert(PARAM_COUNT <= 64, "GPU_Mode.definidos tiene un bit por parámetro");
+
+// ¿El modo define el parámetro? Los que no define no se aplican
+static inline int modo_define(const GPU_Mode* modo, int id) {
+    return (modo->definidos >> id) & 1;
+}
+
 GPU_Mode* load_gpu_modes(const char* filename, int* num_modes);
+GPU_Mode* load_gpu_modes_ex(const char* filename, int* num_modes, int verbose);
+
+// Ruta de modelo.txt (instalación del sistema o junto al ejecutable)
+int find_modelo_path(char* buffer, size_t size);
+
+// Modo integrado en gx al compilar (build/modos_default.h, desde el
+// modelo.txt del build); se usa cuando no hay un modelo.txt que lo reemplace
+// Retorna NULL si no existe
+const GPU_Mode* buscar_modo_integrado(const char* nombre);
+
+// Recorrer los modos integrados (en el orden del modelo.txt del build)
+int num_modos_integrados(void);
+const GPU_Mode* modo_integrado(int indice);
 
 // Función para controlar RGB del teclado
 int set_rgb_color(const char* color, int brightness);
 
+// Perfil de platform_profile que produce cada color del botón de encendido
+// Retorna NULL si el color no es reconocido
+const char* rgb_color_to_profile(const char* color);
+
 // Función para obtener el color actual del botón de encendido
 const char* get_current_power_button_color(void);
 
+// Nombre del color ("azul", "blanco", "rojo") asociado a un platform-profile
+const char* profile_to_color_name(const char* profile);
+
 #endif // UTILS_H
\ No newline at end of file
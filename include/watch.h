@@ -0,0 +1,36 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+// Muestreo continuo del estado del sistema ("gx watch")
+// Las fuentes de sysfs/procfs se abren una vez y se releen con pread; la GPU
+// sale del productor persistente de gpu_telemetry. Imprime una fila compacta
+// por muestra hasta Ctrl+C o hasta completar la cantidad pedida.
+
+#define WATCH_HZ_DEFECTO 1
+#define WATCH_HZ_MAX 100
+
+#include "status.h"
+#include "gpu_telemetry.h"
+
+// Se llama una vez por muestra con el tiempo desde el inicio (ms)
+// Retornar distinto de 0 corta el muestreo
+typedef int (*WatchCallback)(long long t_ms, const SystemStatus* status, const GpuSample* gpu, void* ctx);
+
+typedef struct {
+    long tomadas;
+    long saltadas;              // Plazos perdidos por atraso
+    double transcurrido_s;
+    double cpu_s;               // CPU consumida por gx durante el muestreo
+} WatchResumen;
+
+// Bucle de muestreo compartido por watch y record
+// Retorna 0 si terminó bien (cantidad o Ctrl+C), 1 si falló la apertura o el callback
+int watch_muestrear(int hz, long muestras, WatchCallback cb, void* ctx, WatchResumen* resumen);
+
+void watch_imprimir_resumen(const WatchResumen* resumen);
+
+// Muestrear a hz muestras por segundo; muestras <= 0 significa sin límite
+// Retorna 0 si terminó bien, 1 si no se pudo abrir ninguna fuente
+int watch_ejecutar(int hz, long muestras);
+
+#endif // WATCH_H
@@ -219,9 +219,34 @@ sudo mkdir -p /usr/local/share/glx
 echo "Instalando ejecutable en /usr/local/bin/gx..."
 sudo cp build/gx /usr/local/bin/gx
 
-# Copiar modelo.txt a /usr/local/share/glx
-echo "Instalando configuración en /usr/local/share/glx/modelo.txt..."
-sudo cp modelo.txt /usr/local/share/glx/modelo.txt
+# Copiar el daemon privilegiado glxd
+echo "Instalando daemon en /usr/local/bin/glxd..."
+sudo cp build/glxd /usr/local/bin/glxd
+sudo chmod +x /usr/local/bin/glxd
+
+# Solo root y el grupo glx pueden usar el socket de glxd
+sudo groupadd -f glx
+if [ -n "$SUDO_USER" ] || [ "$(id -u)" -ne 0 ]; then
+    sudo usermod -aG glx "${SUDO_USER:-$USER}"
+    echo "Usuario ${SUDO_USER:-$USER} agregado al grupo glx (vale desde el próximo inicio de sesión)"
+fi
+
+# Registrar el servicio de systemd (no se activa automáticamente)
+if command -v systemctl >/dev/null 2>&1; then
+    sudo cp glxd.service /etc/systemd/system/glxd.service
+    sudo systemctl daemon-reload
+fi
+
+# Los modos de modelo.txt van compilados dentro de gx; un
+# /usr/local/share/glx/modelo.txt solo hace falta para reemplazarlos. Una
+# copia idéntica de una instalación anterior se quita, una personalizada se conserva
+if [ -f /usr/local/share/glx/modelo.txt ]; then
+    if cmp -s modelo.txt /usr/local/share/glx/modelo.txt; then
+        sudo rm -f /usr/local/share/glx/modelo.txt
+    else
+        echo "Se conserva /usr/local/share/glx/modelo.txt (reemplaza a los modos integrados)"
+    fi
+fi
 
 # Dar permisos de ejecución
 sudo chmod +x /usr/local/bin/gx
@@ -242,6 +267,7 @@ if command -v gx >/dev/null 2>&1; then
     echo "Ejemplo: gx run mode:quiet"
     echo ""
     echo "Nota: Algunas funciones pueden requerir permisos sudo"
+    echo "Para aplicar modos sin sudo activa el daemon: sudo systemctl enable --now glxd"
     echo ""
     echo "Si instalaste drivers NVIDIA, considera reiniciar el sistema"
 else
@@ -0,0 +1,36 @@
+# Funciones comunes de los ejecutables falsos del simulador de GLX
+# Leen las mismas variables que gx (ver include/sim.h):
+#   GLX_SIM_LATENCIA="nvidia-smi=40,legion_cli=25"   (milisegundos)
+#   GLX_SIM_FALLAS="legion_cli=0.5"                  (probabilidad)
+
+# Directorio del árbol simulado: GLX_SIM o el padre de bin/
+SIM_DIR="${GLX_SIM:-$(cd "$(dirname "$0")/.." && pwd)}"
+
+# Valor de una regla "nombre=valor" en una lista; "*" es el valor por defecto
+sim_valor() {
+    local lista="$1" nombre="$2" item valor=""
+    local IFS=','
+    for item in $lista; do
+        case "$item" in
+            "$nombre") echo 1; return ;;
+            "$nombre="*) echo "${item#*=}"; return ;;
+            "*="*) valor="${item#*=}" ;;
+        esac
+    done
+    echo "$valor"
+}
+
+# Esperar la latencia de la operación y decidir si falla (retorna 1)
+sim_operacion() {
+    local latencia falla
+    latencia="$(sim_valor "$GLX_SIM_LATENCIA" "$1")"
+    if [ -n "$latencia" ]; then
+        sleep "$(awk -v ms="$latencia" 'BEGIN { print ms / 1000 }')"
+    fi
+    falla="$(sim_valor "$GLX_SIM_FALLAS" "$1")"
+    if [ -n "$falla" ] && awk -v p="$falla" -v r="$RANDOM" 'BEGIN { exit !(p >= 1 || r / 32768 < p) }'; then
+        echo "$1: falla simulada" >&2
+        return 1
+    fi
+    return 0
+}
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/arena.h"
+
+#define ARENA_ALINEACION 16
+
+static size_t alinear(size_t n) {
+    return (n + ARENA_ALINEACION - 1) & ~(size_t)(ARENA_ALINEACION - 1);
+}
+
+void arena_init(Arena* arena) {
+    arena->actual = NULL;
+    arena->reservado = 0;
+}
+
+static ArenaBloque* nuevo_bloque(Arena* arena, size_t tamano) {
+    ArenaBloque* bloque = malloc(alinear(sizeof(ArenaBloque)) + tamano);
+    if (!bloque) return NULL;
+    bloque->tamano = tamano;
+    bloque->usado = 0;
+    arena->reservado += alinear(sizeof(ArenaBloque)) + tamano;
+    return bloque;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size = alinear(size ? size : 1);
+    size_t encabezado = alinear(sizeof(ArenaBloque));
+    ArenaBloque* bloque = arena->actual;
+
+    // Un pedido grande recibe un bloque a medida que se encadena debajo del
+    // actual, así el espacio libre del bloque actual se sigue usando
+    if (size > ARENA_BLOQUE_MIN / 4) {
+        ArenaBloque* grande = nuevo_bloque(arena, size);
+        if (!grande) return NULL;
+        grande->usado = size;
+        if (bloque) {
+            grande->anterior = bloque->anterior;
+            bloque->anterior = grande;
+        } else {
+            grande->anterior = NULL;
+            arena->actual = grande;
+        }
+        return (char*)grande + encabezado;
+    }
+
+    if (!bloque || bloque->usado + size > bloque->tamano) {
+        bloque = nuevo_bloque(arena, ARENA_BLOQUE_MIN);
+        if (!bloque) return NULL;
+        bloque->anterior = arena->actual;
+        arena->actual = bloque;
+    }
+
+    void* ptr = (char*)bloque + encabezado + bloque->usado;
+    bloque->usado += size;
+    return ptr;
+}
+
+char* arena_strndup(Arena* arena, const char* texto, size_t len) {
+    char* copia = arena_alloc(arena, len + 1);
+    if (!copia) return NULL;
+    memcpy(copia, texto, len);
+    copia[len] = '\0';
+    return copia;
+}
+
+void arena_liberar(Arena* arena) {
+    ArenaBloque* bloque = arena->actual;
+    while (bloque) {
+        ArenaBloque* anterior = bloque->anterior;
+        free(bloque);
+        bloque = anterior;
+    }
+    arena->actual = NULL;
+    arena->reservado = 0;
+}
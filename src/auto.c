@@ -0,0 +1,565 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include "../include/auto.h"
+#include "../include/procesos.h"
+#include "../include/interpreter.h"
+#include "../include/status.h"
+#include "../include/salida.h"
+
+static volatile sig_atomic_t detener = 0;
+
+static void manejar_senal(int senal) {
+    (void)senal;
+    detener = 1;
+}
+
+static long long ahora_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// "CLAVE=VALOR [CLAVE=VALOR...] -> modo"
+static int parsear_regla(char* texto, AutoRegla* regla) {
+    memset(regla, 0, sizeof(*regla));
+    char* flecha = strstr(texto, "->");
+    if (!flecha) return -1;
+    *flecha = '\0';
+
+    char* modo = flecha + 2;
+    modo += strspn(modo, " \t");
+    modo[strcspn(modo, " \t")] = '\0';
+    if (!*modo) return -1;
+    snprintf(regla->modo, sizeof(regla->modo), "%s", modo);
+
+    char* guardado;
+    for (char* par = strtok_r(texto, " \t", &guardado); par; par = strtok_r(NULL, " \t", &guardado)) {
+        char* igual = strchr(par, '=');
+        if (!igual || igual == par || regla->num_condiciones >= AUTO_MAX_CONDICIONES) return -1;
+        *igual = '\0';
+        AutoCondicion* cond = &regla->condiciones[regla->num_condiciones++];
+        snprintf(cond->clave, sizeof(cond->clave), "%s", par);
+        snprintf(cond->valor, sizeof(cond->valor), "%s", igual + 1);
+    }
+    return regla->num_condiciones > 0 ? 0 : -1;
+}
+
+// Solo el adaptador de corriente (TYPE=Mains): los puertos USB-C/UCSI también
+// son power_supply y reportan ONLINE=0 aunque el cargador esté enchufado
+static void reglas_por_defecto(AutoConfig* config) {
+    static const char* reglas[] = {
+        "POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=0 -> quiet",
+        "POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=1 -> balanced",
+    };
+    memset(config, 0, sizeof(*config));
+    config->debounce_ms = AUTO_DEBOUNCE_MS;
+    for (size_t i = 0; i < sizeof(reglas) / sizeof(reglas[0]); i++) {
+        char texto[128];
+        snprintf(texto, sizeof(texto), "%s", reglas[i]);
+        if (parsear_regla(texto, &config->reglas[config->num_reglas]) == 0) config->num_reglas++;
+    }
+}
+
+// "patron -> modo"
+static int parsear_proceso(char* texto, AutoProceso* proceso) {
+    memset(proceso, 0, sizeof(*proceso));
+    char* flecha = strstr(texto, "->");
+    if (!flecha) return -1;
+    *flecha = '\0';
+
+    char* modo = flecha + 2;
+    modo += strspn(modo, " \t");
+    modo[strcspn(modo, " \t")] = '\0';
+    char* patron = texto + strspn(texto, " \t");
+    size_t largo = strcspn(patron, " \t");
+    if (!*modo || largo == 0 || patron[largo + strspn(patron + largo, " \t")] != '\0') return -1;
+    patron[largo] = '\0';
+    snprintf(proceso->patron, sizeof(proceso->patron), "%s", patron);
+    snprintf(proceso->modo, sizeof(proceso->modo), "%s", modo);
+    return 0;
+}
+
+// El modo de una regla tiene que existir al cargarla: en ejecución un nombre
+// mal escrito terminaría corregido a otro modo o sin aplicar nada
+static int validar_modo(const char* ruta, int numero, const char* modo) {
+    if (modo_disponible(modo)) return 1;
+    const char* sugerido = sugerir_modo(modo);
+    if (sugerido) {
+        printf("\033[31m❌ Error: %s:%d: modo desconocido '%s' (¿quisiste decir: %s?)\033[0m\n", ruta, numero, modo, sugerido);
+    } else {
+        printf("\033[31m❌ Error: %s:%d: modo desconocido '%s'\033[0m\n", ruta, numero, modo);
+    }
+    return 0;
+}
+
+static int ruta_config_defecto(char* buffer, size_t size) {
+    const char* xdg = getenv("XDG_CONFIG_HOME");
+    if (xdg && *xdg) {
+        snprintf(buffer, size, "%s/glx/auto.conf", xdg);
+        return 1;
+    }
+    const char* home = getenv("HOME");
+    if (home && *home) {
+        snprintf(buffer, size, "%s/.config/glx/auto.conf", home);
+        return 1;
+    }
+    return 0;
+}
+
+int auto_cargar_config(const char* ruta, AutoConfig* config) {
+    reglas_por_defecto(config);
+
+    char ruta_defecto[512];
+    if (!ruta) {
+        if (!ruta_config_defecto(ruta_defecto, sizeof(ruta_defecto)) || access(ruta_defecto, R_OK) != 0) return 0;
+        ruta = ruta_defecto;
+    }
+
+    FILE* archivo = fopen(ruta, "r");
+    if (!archivo) {
+        printf("\033[31m❌ Error: No se pudo abrir %s\033[0m\n", ruta);
+        return -1;
+    }
+
+    // Un archivo propio reemplaza las reglas por defecto
+    config->num_reglas = 0;
+    snprintf(config->origen, sizeof(config->origen), "%s", ruta);
+
+    char linea[512];
+    int numero = 0;
+    int errores = 0;
+    while (fgets(linea, sizeof(linea), archivo)) {
+        numero++;
+        linea[strcspn(linea, "#\n")] = '\0';
+        char* texto = linea + strspn(linea, " \t");
+        if (!*texto) continue;
+
+        if (strncmp(texto, "debounce_ms:", 12) == 0) {
+            config->debounce_ms = atoi(texto + 12);
+        } else if (strncmp(texto, "cuando:", 7) == 0 && config->num_reglas < AUTO_MAX_REGLAS &&
+                   parsear_regla(texto + 7, &config->reglas[config->num_reglas]) == 0) {
+            if (!validar_modo(ruta, numero, config->reglas[config->num_reglas].modo)) {
+                errores++;
+                continue;
+            }
+            config->reglas[config->num_reglas++].linea = numero;
+        } else if (strncmp(texto, "proceso:", 8) == 0 && config->num_procesos < AUTO_MAX_PROCESOS &&
+                   parsear_proceso(texto + 8, &config->procesos[config->num_procesos]) == 0) {
+            if (!validar_modo(ruta, numero, config->procesos[config->num_procesos].modo)) {
+                errores++;
+                continue;
+            }
+            config->procesos[config->num_procesos++].linea = numero;
+        } else {
+            printf("\033[31m❌ Error: %s:%d: regla inválida (usar \"cuando: CLAVE=VALOR -> modo\" o \"proceso: patrón -> modo\")\033[0m\n", ruta, numero);
+            errores++;
+        }
+    }
+    fclose(archivo);
+    if (config->debounce_ms < 0) config->debounce_ms = 0;
+    return errores == 0 ? 0 : -1;
+}
+
+// Buscar el par CLAVE=VALOR exacto entre los campos del evento
+static int evento_tiene(const char* evento, size_t len, const AutoCondicion* cond) {
+    size_t largo_clave = strlen(cond->clave);
+    size_t largo_valor = strlen(cond->valor);
+    size_t i = 0;
+    while (i < len) {
+        size_t fin = i;
+        while (fin < len && evento[fin] != '\0' && evento[fin] != ' ' && evento[fin] != '\n' && evento[fin] != '\t') fin++;
+        if (fin - i == largo_clave + 1 + largo_valor &&
+            memcmp(evento + i, cond->clave, largo_clave) == 0 &&
+            evento[i + largo_clave] == '=' &&
+            memcmp(evento + i + largo_clave + 1, cond->valor, largo_valor) == 0) {
+            return 1;
+        }
+        i = fin + 1;
+    }
+    return 0;
+}
+
+const char* auto_modo_para_evento(const AutoConfig* config, const char* evento, size_t len) {
+    for (int r = 0; r < config->num_reglas; r++) {
+        const AutoRegla* regla = &config->reglas[r];
+        int coincide = 1;
+        for (int c = 0; c < regla->num_condiciones && coincide; c++) {
+            coincide = evento_tiene(evento, len, &regla->condiciones[c]);
+        }
+        if (coincide) return regla->modo;
+    }
+    return NULL;
+}
+
+int auto_regla_proceso(const AutoConfig* config, const char* comm, const char* exe) {
+    const char* base = strrchr(exe, '/');
+    base = base ? base + 1 : exe;
+    for (int i = 0; i < config->num_procesos; i++) {
+        const char* patron = config->procesos[i].patron;
+        if (strchr(patron, '/')) {
+            if (*exe && fnmatch(patron, exe, 0) == 0) return i;
+        } else if (fnmatch(patron, comm, 0) == 0 || (*base && fnmatch(patron, base, 0) == 0)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Socket de uevents del kernel (grupo 1); -1 si no está disponible
+static int abrir_uevents(void) {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) return -1;
+
+    struct sockaddr_nl direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.nl_family = AF_NETLINK;
+    direccion.nl_groups = 1;
+    if (bind(fd, (struct sockaddr*)&direccion, sizeof(direccion)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+typedef struct {
+    pid_t pid;
+    int regla;
+} ProcesoSeguido;
+
+typedef struct {
+    const AutoConfig* config;
+    char base[50];              // Modo de las reglas de energía
+    int activos[AUTO_MAX_PROCESOS];     // Procesos vivos por regla de proceso
+    ProcesoSeguido* seguidos;
+    int num_seguidos;
+    int cap_seguidos;
+    char pendiente[50];         // Modo esperando que pase el debounce
+    long long plazo_ms;
+    char aplicado[50];
+} AutoEstado;
+
+// Un proceso activo manda sobre la energía; entre varios, la primera regla
+static const char* modo_objetivo(const AutoEstado* estado, const char** motivo) {
+    for (int i = 0; i < estado->config->num_procesos; i++) {
+        if (estado->activos[i] > 0) {
+            *motivo = estado->config->procesos[i].patron;
+            return estado->config->procesos[i].modo;
+        }
+    }
+    *motivo = "energia";
+    return estado->base;
+}
+
+// Recalcular el modo a aplicar. Un cambio abre el debounce: de una ráfaga
+// (el cargador suele generar varios eventos, un compilador lanza procesos
+// cortos) solo se aplica el estado final, y si vuelve al modo activo no se
+// aplica nada
+static void programar(AutoEstado* estado, int inmediato) {
+    const char* motivo;
+    const char* modo = modo_objetivo(estado, &motivo);
+    if (!*modo || strcmp(modo, estado->aplicado) == 0) {
+        estado->pendiente[0] = '\0';
+        return;
+    }
+    if (strcmp(modo, estado->pendiente) == 0 && !inmediato) return;
+    snprintf(estado->pendiente, sizeof(estado->pendiente), "%s", modo);
+    estado->plazo_ms = ahora_ms() + (inmediato ? 0 : estado->config->debounce_ms);
+}
+
+static void aplicar(AutoEstado* estado) {
+    if (!estado->pendiente[0]) return;
+    if (strcmp(estado->pendiente, estado->aplicado) != 0) {
+        const char* motivo;
+        modo_objetivo(estado, &motivo);
+        salida_printf("\033[36m⚡ auto: aplicando modo %s (%s)\033[0m\n", estado->pendiente, motivo);
+        salida_json_inicio("auto");
+        salida_json_texto("modo", estado->pendiente);
+        salida_json_texto("motivo", motivo);
+        salida_json_fin();
+        // Si falló no queda como aplicado: el próximo evento lo vuelve a intentar
+        if (ejecutar_run(estado->pendiente, NODE_STRING)) {
+            snprintf(estado->aplicado, sizeof(estado->aplicado), "%s", estado->pendiente);
+        }
+    }
+    estado->pendiente[0] = '\0';
+    salida_vaciar();
+}
+
+// Dejar de contar un PID; retorna 1 si estaba seguido
+static int soltar_proceso(AutoEstado* estado, pid_t pid) {
+    for (int i = 0; i < estado->num_seguidos; i++) {
+        if (estado->seguidos[i].pid != pid) continue;
+        int regla = estado->seguidos[i].regla;
+        estado->seguidos[i] = estado->seguidos[--estado->num_seguidos];
+        if (--estado->activos[regla] == 0) {
+            salida_printf("\033[36m🎮 auto: terminó el último proceso de \"%s\"\033[0m\n", estado->config->procesos[regla].patron);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// Contar un PID si coincide con alguna regla; retorna 1 si se siguió
+static int seguir_proceso(AutoEstado* estado, pid_t pid, const char* comm, const char* exe) {
+    int regla = auto_regla_proceso(estado->config, comm, exe);
+    if (regla < 0) return 0;
+    if (estado->num_seguidos == estado->cap_seguidos) {
+        int nueva = estado->cap_seguidos ? estado->cap_seguidos * 2 : 16;
+        ProcesoSeguido* seguidos = realloc(estado->seguidos, nueva * sizeof(ProcesoSeguido));
+        if (!seguidos) return 0;
+        estado->seguidos = seguidos;
+        estado->cap_seguidos = nueva;
+    }
+    estado->seguidos[estado->num_seguidos].pid = pid;
+    estado->seguidos[estado->num_seguidos].regla = regla;
+    estado->num_seguidos++;
+    if (estado->activos[regla]++ == 0) {
+        salida_printf("\033[36m🎮 auto: %s (pid %d) coincide con \"%s\"\033[0m\n", comm, (int)pid, estado->config->procesos[regla].patron);
+    }
+    return 1;
+}
+
+static const ProcesoSeguido* buscar_seguido(const AutoEstado* estado, pid_t pid) {
+    for (int i = 0; i < estado->num_seguidos; i++) {
+        if (estado->seguidos[i].pid == pid) return &estado->seguidos[i];
+    }
+    return NULL;
+}
+
+// Un exec sobre un PID seguido reemplaza al programa anterior; si sigue
+// coincidiendo con la misma regla (el escaneo inicial y el conector pueden
+// reportar el mismo exec) no cambia nada
+static void evento_proceso(const ProcesoEvento* evento, void* ctx) {
+    AutoEstado* estado = ctx;
+    char comm[32];
+    char exe[512];
+    int vivo = evento->tipo == PROCESO_EXEC &&
+               procesos_identificar(evento->pid, comm, sizeof(comm), exe, sizeof(exe)) == 0;
+
+    const ProcesoSeguido* seguido = buscar_seguido(estado, evento->pid);
+    if (vivo && seguido && auto_regla_proceso(estado->config, comm, exe) == seguido->regla) return;
+
+    int cambio = soltar_proceso(estado, evento->pid);
+    if (vivo) cambio |= seguir_proceso(estado, evento->pid, comm, exe);
+    if (cambio) programar(estado, 0);
+}
+
+// Volver a identificar los PIDs seguidos: detecta los que terminaron sin
+// aviso (eventos perdidos) o cuyo PID reutilizó otro proceso entre escaneos
+static void revisar_seguidos(AutoEstado* estado) {
+    int cambio = 0;
+    for (int i = estado->num_seguidos - 1; i >= 0; i--) {
+        ProcesoSeguido seguido = estado->seguidos[i];
+        char comm[32];
+        char exe[512];
+        if (procesos_identificar(seguido.pid, comm, sizeof(comm), exe, sizeof(exe)) != 0 ||
+            auto_regla_proceso(estado->config, comm, exe) != seguido.regla) {
+            cambio |= soltar_proceso(estado, seguido.pid);
+        }
+    }
+    if (cambio) programar(estado, 0);
+}
+
+// Valor de CLAVE en un evento de texto; retorna 1 si está
+static int evento_campo(const char* evento, size_t len, const char* clave, char* valor, size_t size) {
+    size_t largo_clave = strlen(clave);
+    size_t i = 0;
+    while (i < len) {
+        size_t fin = i;
+        while (fin < len && evento[fin] != '\0' && evento[fin] != ' ' && evento[fin] != '\n' && evento[fin] != '\t') fin++;
+        if (fin - i > largo_clave && memcmp(evento + i, clave, largo_clave) == 0 && evento[i + largo_clave] == '=') {
+            snprintf(valor, size, "%.*s", (int)(fin - i - largo_clave - 1), evento + i + largo_clave + 1);
+            return 1;
+        }
+        i = fin + 1;
+    }
+    return 0;
+}
+
+// Evento de proceso escrito a mano (--stdin): la identidad viene en la línea
+static void evento_proceso_texto(AutoEstado* estado, const char* evento, size_t len) {
+    char tipo[16];
+    char pid[16];
+    char comm[32] = "";
+    char exe[512] = "";
+    if (!evento_campo(evento, len, "PROC_EVENT", tipo, sizeof(tipo)) || !evento_campo(evento, len, "PID", pid, sizeof(pid))) return;
+    evento_campo(evento, len, "COMM", comm, sizeof(comm));
+    evento_campo(evento, len, "EXE", exe, sizeof(exe));
+
+    int cambio = soltar_proceso(estado, (pid_t)atoi(pid));
+    if (strcmp(tipo, "exec") == 0) cambio |= seguir_proceso(estado, (pid_t)atoi(pid), comm, exe);
+    if (cambio) programar(estado, 0);
+}
+
+static void procesar_evento(AutoEstado* estado, const char* evento, size_t len, int inmediato) {
+    char tipo[16];
+    if (evento_campo(evento, len, "PROC_EVENT", tipo, sizeof(tipo))) {
+        evento_proceso_texto(estado, evento, len);
+        return;
+    }
+    const char* modo = auto_modo_para_evento(estado->config, evento, len);
+    if (!modo) return;
+    snprintf(estado->base, sizeof(estado->base), "%s", modo);
+    programar(estado, inmediato);
+}
+
+// Estado inicial: una sola lectura del cargador, convertida en evento
+// (las fuentes de ac_online son adaptadores de corriente: AC, ADP1, ACAD)
+static void evento_inicial(AutoEstado* estado) {
+    char ruta[512];
+    if (!status_fuente_ruta(STATUS_SRC_AC_ONLINE, ruta, sizeof(ruta))) return;
+    int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    char valor[8] = "";
+    ssize_t n = read(fd, valor, sizeof(valor) - 1);
+    close(fd);
+    if (n <= 0) return;
+    valor[n] = '\0';
+    valor[strcspn(valor, "\n")] = '\0';
+
+    char evento[128];
+    int len = snprintf(evento, sizeof(evento), "ACTION=change SUBSYSTEM=power_supply POWER_SUPPLY_TYPE=Mains POWER_SUPPLY_ONLINE=%s", valor);
+    procesar_evento(estado, evento, len, 1);
+}
+
+// Pasada completa de /proc para contar lo que ya estaba corriendo
+static void escaneo_completo(AutoEstado* estado) {
+    ProcesoEscaneo escaneo;
+    memset(&escaneo, 0, sizeof(escaneo));
+    procesos_escanear(&escaneo, evento_proceso, estado);
+    procesos_escaneo_liberar(&escaneo);
+}
+
+int auto_ejecutar(const AutoConfig* config, int desde_stdin) {
+    AutoEstado estado;
+    memset(&estado, 0, sizeof(estado));
+    estado.config = config;
+
+    int fd = desde_stdin ? STDIN_FILENO : abrir_uevents();
+    if (fd < 0) {
+        printf("\033[31m❌ Error: No se pudo abrir el socket de uevents: %s\033[0m\n", strerror(errno));
+        return 1;
+    }
+
+    // Procesos: conector del kernel o, sin permisos, escaneo incremental
+    int conector = -1;
+    int escaneando = 0;
+    ProcesoEscaneo escaneo;
+    memset(&escaneo, 0, sizeof(escaneo));
+    if (!desde_stdin && config->num_procesos > 0) {
+        conector = procesos_conector_abrir();
+        escaneando = conector < 0;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = manejar_senal; // Sin SA_RESTART para que poll() se interrumpa
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    detener = 0;
+
+    salida_printf("\033[36m🔌 gx auto: %d reglas de energía y %d de procesos (%s), debounce %d ms, eventos de %s%s\033[0m\n",
+                  config->num_reglas, config->num_procesos, config->origen[0] ? config->origen : "por defecto",
+                  config->debounce_ms, desde_stdin ? "stdin" : "netlink",
+                  conector >= 0 ? " y conector de procesos" : escaneando ? " y escaneo de /proc" : "");
+    salida_vaciar();
+
+    long long proximo_escaneo = 0;
+    if (!desde_stdin) {
+        if (escaneando) {
+            procesos_escanear(&escaneo, evento_proceso, &estado);
+            proximo_escaneo = ahora_ms() + PROCESOS_ESCANEO_MS;
+        } else if (conector >= 0) {
+            escaneo_completo(&estado);
+        }
+        evento_inicial(&estado);
+        aplicar(&estado);
+    }
+
+    char buffer[8192];
+    size_t usado = 0;           // Línea incompleta de stdin
+    int abierto = 1;
+    while (!detener && (abierto || estado.pendiente[0])) {
+        long long ahora = ahora_ms();
+        long long despertar = -1;
+        if (estado.pendiente[0]) despertar = estado.plazo_ms;
+        if (escaneando && (despertar < 0 || proximo_escaneo < despertar)) despertar = proximo_escaneo;
+        int espera = despertar < 0 ? -1 : despertar > ahora ? (int)(despertar - ahora) : 0;
+
+        struct pollfd pfds[2];
+        int num_pfds = 0;
+        if (abierto) pfds[num_pfds++] = (struct pollfd){ .fd = fd, .events = POLLIN };
+        int indice_conector = -1;
+        if (conector >= 0) {
+            indice_conector = num_pfds;
+            pfds[num_pfds++] = (struct pollfd){ .fd = conector, .events = POLLIN };
+        }
+
+        if (poll(pfds, num_pfds, espera) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (abierto && pfds[0].revents) {
+            if (!desde_stdin) {
+                // Solo se aceptan mensajes del kernel (nl_pid 0)
+                struct sockaddr_nl origen;
+                socklen_t largo_origen = sizeof(origen);
+                ssize_t n = recvfrom(fd, buffer, sizeof(buffer), 0, (struct sockaddr*)&origen, &largo_origen);
+                if (n > 0 && origen.nl_pid == 0) procesar_evento(&estado, buffer, n, 0);
+            } else {
+                ssize_t n = read(fd, buffer + usado, sizeof(buffer) - 1 - usado);
+                if (n <= 0) {
+                    if (usado > 0) procesar_evento(&estado, buffer, usado, 0);
+                    usado = 0;
+                    abierto = 0;
+                } else {
+                    usado += n;
+
+                    // Un evento por línea; lo que queda sin '\n' espera a la próxima lectura
+                    char* inicio = buffer;
+                    char* salto;
+                    while ((salto = memchr(inicio, '\n', buffer + usado - inicio))) {
+                        procesar_evento(&estado, inicio, salto - inicio, 0);
+                        inicio = salto + 1;
+                    }
+                    usado -= inicio - buffer;
+                    memmove(buffer, inicio, usado);
+                    if (usado == sizeof(buffer) - 1) usado = 0;   // Línea demasiado larga: se descarta
+                }
+            }
+        }
+
+        // Si el kernel descartó eventos por falta de espacio, se resincroniza
+        if (indice_conector >= 0 && pfds[indice_conector].revents &&
+            procesos_conector_leer(conector, evento_proceso, &estado) < 0) {
+            revisar_seguidos(&estado);
+            escaneo_completo(&estado);
+        }
+
+        ahora = ahora_ms();
+        if (escaneando && ahora >= proximo_escaneo) {
+            procesos_escanear(&escaneo, evento_proceso, &estado);
+            revisar_seguidos(&estado);
+            proximo_escaneo = ahora + PROCESOS_ESCANEO_MS;
+        }
+        if (estado.pendiente[0] && ahora >= estado.plazo_ms) aplicar(&estado);
+    }
+
+    if (!desde_stdin) close(fd);
+    if (conector >= 0) close(conector);
+    procesos_escaneo_liberar(&escaneo);
+    free(estado.seguidos);
+    salida_vaciar();
+    return 0;
+}
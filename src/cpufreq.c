@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/cpufreq.h"
+#include "../include/knobs.h"
+
+typedef struct {
+    char ruta[256];         // Directorio de la policy, ya con la raíz aplicada
+    int cpu;                // Primera CPU de affected_cpus
+    CpufreqClase clase;
+} Policy;
+
+static const char* atributos[] = {
+    [CPUFREQ_ATTR_EPP] = "energy_performance_preference",
+    [CPUFREQ_ATTR_GOBERNADOR] = "scaling_governor",
+    [CPUFREQ_ATTR_MAX_FREQ] = "scaling_max_freq",
+    [CPUFREQ_ATTR_MIN_FREQ] = "scaling_min_freq",
+};
+
+// Lista de valores aceptados que publica el kernel para los atributos de texto
+static const char* disponibles[] = {
+    [CPUFREQ_ATTR_EPP] = "energy_performance_available_preferences",
+    [CPUFREQ_ATTR_GOBERNADOR] = "scaling_available_governors",
+    [CPUFREQ_ATTR_MAX_FREQ] = NULL,
+    [CPUFREQ_ATTR_MIN_FREQ] = NULL,
+};
+
+static Policy* policies = NULL;
+static int num_policies = 0;
+static int enumerado = 0;
+// Los knobs de cada clase se escriben en hilos distintos (ejecutor.c)
+static pthread_mutex_t mutex_enumerar = PTHREAD_MUTEX_INITIALIZER;
+
+static int es_frecuencia(CpufreqAtributo atributo) {
+    return atributo == CPUFREQ_ATTR_MAX_FREQ || atributo == CPUFREQ_ATTR_MIN_FREQ;
+}
+
+// Leer un atributo chico sin el salto de línea; 1 si se pudo
+static int leer_archivo(const char* ruta, char* buffer, size_t size) {
+    int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    buffer[n] = '\0';
+    buffer[strcspn(buffer, "\n")] = '\0';
+    return 1;
+}
+
+// ¿Está cpu en una lista de rangos del kernel ("0-7,16,18-19")?
+static int cpu_en_lista(const char* lista, int cpu) {
+    const char* p = lista;
+    while (*p) {
+        char* fin;
+        long desde = strtol(p, &fin, 10);
+        if (fin == p) break;
+        long hasta = desde;
+        if (*fin == '-') {
+            p = fin + 1;
+            hasta = strtol(p, &fin, 10);
+        }
+        if (cpu >= desde && cpu <= hasta) return 1;
+        p = *fin == ',' ? fin + 1 : fin;
+    }
+    return 0;
+}
+
+static int comparar_policies(const void* a, const void* b) {
+    return ((const Policy*)a)->cpu - ((const Policy*)b)->cpu;
+}
+
+// Recorrer cpufreq/policy* una sola vez y clasificar cada policy
+static void enumerar(void) {
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s%s", knobs_get_root(), CPUFREQ_DIR);
+
+    char ruta[512];
+    char atom[256] = "";
+    snprintf(ruta, sizeof(ruta), "%s%s", knobs_get_root(), CPUFREQ_ATOM_CPUS);
+    int hibrida = leer_archivo(ruta, atom, sizeof(atom));
+
+    DIR* d = opendir(dir);
+    if (!d) return;
+    int capacidad = 0;
+    struct dirent* entrada;
+    while ((entrada = readdir(d))) {
+        int numero;
+        if (sscanf(entrada->d_name, "policy%d", &numero) != 1) continue;
+
+        if (num_policies >= capacidad) {
+            capacidad = capacidad ? capacidad * 2 : 16;
+            Policy* nuevas = realloc(policies, capacidad * sizeof(Policy));
+            if (!nuevas) break;
+            policies = nuevas;
+        }
+        Policy* p = &policies[num_policies];
+        if ((size_t)snprintf(p->ruta, sizeof(p->ruta), "%s/%s", dir, entrada->d_name) >= sizeof(p->ruta)) continue;
+
+        // La policy manda sobre las CPUs de affected_cpus; con intel_pstate
+        // hay una por CPU y su número coincide con el de la policy
+        char cpus[64];
+        snprintf(ruta, sizeof(ruta), "%s/affected_cpus", p->ruta);
+        p->cpu = leer_archivo(ruta, cpus, sizeof(cpus)) ? atoi(cpus) : numero;
+        p->clase = hibrida && cpu_en_lista(atom, p->cpu) ? CPUFREQ_CLASE_E : CPUFREQ_CLASE_P;
+        num_policies++;
+    }
+    closedir(d);
+    qsort(policies, num_policies, sizeof(Policy), comparar_policies);
+}
+
+static void asegurar_enumerado(void) {
+    pthread_mutex_lock(&mutex_enumerar);
+    if (!enumerado) {
+        enumerar();
+        enumerado = 1;
+    }
+    pthread_mutex_unlock(&mutex_enumerar);
+}
+
+void cpufreq_reiniciar(void) {
+    pthread_mutex_lock(&mutex_enumerar);
+    free(policies);
+    policies = NULL;
+    num_policies = 0;
+    enumerado = 0;
+    pthread_mutex_unlock(&mutex_enumerar);
+}
+
+int cpufreq_num_policies(CpufreqClase clase) {
+    asegurar_enumerado();
+    int cantidad = 0;
+    for (int i = 0; i < num_policies; i++) {
+        if (policies[i].clase == clase) cantidad++;
+    }
+    return cantidad;
+}
+
+static const Policy* primera_policy(CpufreqClase clase) {
+    for (int i = 0; i < num_policies; i++) {
+        if (policies[i].clase == clase) return &policies[i];
+    }
+    return NULL;
+}
+
+int cpufreq_validar(CpufreqClase clase, CpufreqAtributo atributo, const char* valor) {
+    if (!valor || !*valor || es_frecuencia(atributo)) return 0;
+    if (strspn(valor, "abcdefghijklmnopqrstuvwxyz_") != strlen(valor)) return 0;
+
+    asegurar_enumerado();
+    const Policy* p = primera_policy(clase);
+    char ruta[512];
+    char lista[256];
+    if (!p) return 1;
+    snprintf(ruta, sizeof(ruta), "%s/%s", p->ruta, disponibles[atributo]);
+    if (!leer_archivo(ruta, lista, sizeof(lista))) return 1;
+
+    char* guardado;
+    for (char* item = strtok_r(lista, " ", &guardado); item; item = strtok_r(NULL, " ", &guardado)) {
+        if (strcmp(item, valor) == 0) return 1;
+    }
+    return 0;
+}
+
+KnobResult cpufreq_escribir(CpufreqClase clase, CpufreqAtributo atributo, const char* valor) {
+    asegurar_enumerado();
+
+    // GLX maneja MHz; sysfs espera kHz
+    char texto[32];
+    if (es_frecuencia(atributo)) snprintf(texto, sizeof(texto), "%ld", atol(valor) * 1000);
+    else snprintf(texto, sizeof(texto), "%s", valor);
+
+    char** sin_permiso = malloc((num_policies ? num_policies : 1) * sizeof(char*));
+    if (!sin_permiso) return KNOB_ERROR;
+    int num_sin_permiso = 0;
+    int escritas = 0;
+    int primer_error = 0;
+
+    for (int i = 0; i < num_policies; i++) {
+        Policy* p = &policies[i];
+        if (p->clase != clase) continue;
+
+        char ruta[512];
+        snprintf(ruta, sizeof(ruta), "%s/%s", p->ruta, atributos[atributo]);
+        KnobResult r = write_sysfs_knob_directo(ruta, texto);
+        if (r == KNOB_OK) {
+            escritas++;
+        } else if (errno == EACCES) {
+            sin_permiso[num_sin_permiso] = strdup(ruta);
+            if (sin_permiso[num_sin_permiso]) num_sin_permiso++;
+        } else if (!primer_error) {
+            primer_error = errno;
+        }
+    }
+
+    KnobResult resultado = KNOB_OK;
+    if (num_sin_permiso > 0) {
+        // Un solo "sudo tee" para todas las policies que no se pudieron abrir
+        resultado = write_sysfs_knob_sudo((const char* const*)sin_permiso, num_sin_permiso, texto);
+        if (resultado != KNOB_ERROR) escritas += num_sin_permiso;
+        else if (!primer_error) primer_error = errno;
+        for (int i = 0; i < num_sin_permiso; i++) free(sin_permiso[i]);
+    }
+    free(sin_permiso);
+
+    if (primer_error) {
+        errno = primer_error;
+        return KNOB_ERROR;
+    }
+    if (escritas == 0) {
+        // Ninguna policy de esta clase (CPU no híbrida o sin cpufreq)
+        errno = ENOENT;
+        return KNOB_ERROR;
+    }
+    return resultado;
+}
+
+int cpufreq_leer(CpufreqClase clase, CpufreqAtributo atributo, char* valor, size_t size) {
+    asegurar_enumerado();
+    valor[0] = '\0';
+
+    char primero[64] = "";
+    int leidas = 0;
+    for (int i = 0; i < num_policies; i++) {
+        if (policies[i].clase != clase) continue;
+
+        char ruta[512];
+        char actual[64];
+        snprintf(ruta, sizeof(ruta), "%s/%s", policies[i].ruta, atributos[atributo]);
+        if (!leer_archivo(ruta, actual, sizeof(actual))) return 0;
+        // Policies en desacuerdo: no hay un valor de la clase
+        if (leidas > 0 && strcmp(actual, primero) != 0) return 0;
+        if (leidas == 0) snprintf(primero, sizeof(primero), "%s", actual);
+        leidas++;
+    }
+    if (leidas == 0) return 0;
+
+    if (es_frecuencia(atributo)) snprintf(valor, size, "%ld", atol(primero) / 1000);
+    else snprintf(valor, size, "%s", primero);
+    return 1;
+}
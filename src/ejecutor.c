@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/ejecutor.h"
+#include "../include/sim.h"
+
+// Restricción de orden entre dos knobs del mismo lote; la función decide
+// según los valores cuál va primero (1: a antes que b, -1: b antes que a)
+typedef struct {
+    KnobId a;
+    KnobId b;
+    int (*orden)(const KnobWrite* a, const KnobWrite* b);
+} RestriccionOrden;
+
+// intel_pstate rechaza min_perf_pct > max_perf_pct (y cpufreq un
+// scaling_max_freq bajo el mínimo): el mínimo va primero, salvo que supere
+// al máximo actual y haya que subir antes el máximo
+static int orden_min_max(const KnobWrite* min, const KnobWrite* max) {
+    char actual[32];
+    if (knob_leer_local(max->id, actual, sizeof(actual)) && atoi(min->valor) > atoi(actual)) {
+        return -1;
+    }
+    return 1;
+}
+
+// Con el governor "performance" intel_pstate rechaza cualquier otro EPP:
+// el governor se cambia antes
+static int orden_fijo(const KnobWrite* a, const KnobWrite* b) {
+    (void)a;
+    (void)b;
+    return 1;
+}
+
+static const RestriccionOrden restricciones[] = {
+    { KNOB_CPU_MIN_PERF, KNOB_CPU_MAX_PERF, orden_min_max },
+    { KNOB_CPU_MIN_FREQ_P, KNOB_CPU_MAX_FREQ_P, orden_min_max },
+    { KNOB_CPU_MIN_FREQ_E, KNOB_CPU_MAX_FREQ_E, orden_min_max },
+    { KNOB_CPU_GOVERNOR_P, KNOB_CPU_EPP_P, orden_fijo },
+    { KNOB_CPU_GOVERNOR_E, KNOB_CPU_EPP_E, orden_fijo },
+};
+
+#define NUM_RESTRICCIONES (int)(sizeof(restricciones) / sizeof(restricciones[0]))
+
+typedef struct {
+    KnobWrite write;            // Copia privada: los hilos no tocan el lote del llamador
+    int dependientes[KNOB_COUNT];
+    int num_dependientes;
+    int faltan;                 // Dependencias que todavía no terminaron
+    int terminada;
+} Tarea;
+
+// Estado compartido entre el llamador y los hilos. Si vence el plazo el
+// llamador se va y el último hilo en salir libera todo
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cambio;
+    Tarea* tareas;
+    int cantidad;
+    int* listas;                // Cola de tareas sin dependencias pendientes
+    int inicio;
+    int fin;
+    int terminadas;
+    int referencias;
+    int abandonada;
+    EjecutorEscribir escribir;
+} Ejecucion;
+
+static void agregar_dependencia(Tarea* tareas, int antes, int despues) {
+    Tarea* t = &tareas[antes];
+    if (t->num_dependientes >= KNOB_COUNT) return;
+    t->dependientes[t->num_dependientes++] = despues;
+    tareas[despues].faltan++;
+}
+
+// Armar el grafo: restricciones declaradas y, si un knob aparece dos veces,
+// la última escritura gana
+static void armar_dependencias(Tarea* tareas, int cantidad) {
+    for (int i = 0; i < cantidad; i++) {
+        for (int j = i + 1; j < cantidad; j++) {
+            KnobId a = tareas[i].write.id;
+            KnobId b = tareas[j].write.id;
+            if (a == b) {
+                agregar_dependencia(tareas, i, j);
+                continue;
+            }
+            for (int r = 0; r < NUM_RESTRICCIONES; r++) {
+                const RestriccionOrden* rest = &restricciones[r];
+                if (rest->a == a && rest->b == b) {
+                    if (rest->orden(&tareas[i].write, &tareas[j].write) > 0) agregar_dependencia(tareas, i, j);
+                    else agregar_dependencia(tareas, j, i);
+                } else if (rest->a == b && rest->b == a) {
+                    if (rest->orden(&tareas[j].write, &tareas[i].write) > 0) agregar_dependencia(tareas, j, i);
+                    else agregar_dependencia(tareas, i, j);
+                }
+            }
+        }
+    }
+}
+
+// Tareas escribiendo en este momento, de cualquier lote. Si un lote venció
+// su plazo sus tareas en curso siguen corriendo; un lote nuevo espera a que
+// terminen para que una escritura tardía no pise el modo aplicado después
+static pthread_mutex_t mutex_en_curso = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fin_en_curso = PTHREAD_COND_INITIALIZER;
+static int en_curso = 0;
+
+static long long ahora_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void ejecutar_tarea(Ejecucion* e, Tarea* tarea) {
+    long long inicio = ahora_us();
+    e->escribir(&tarea->write);
+    tarea->write.duracion_us = (int)(ahora_us() - inicio);
+}
+
+static void soltar(Ejecucion* e) {
+    // Se llama con el mutex tomado
+    int ultima = --e->referencias == 0;
+    pthread_mutex_unlock(&e->mutex);
+    if (ultima) {
+        pthread_mutex_destroy(&e->mutex);
+        pthread_cond_destroy(&e->cambio);
+        free(e->tareas);
+        free(e->listas);
+        free(e);
+    }
+}
+
+static void* hilo_ejecutor(void* arg) {
+    Ejecucion* e = arg;
+    pthread_mutex_lock(&e->mutex);
+    while (!e->abandonada && e->terminadas < e->cantidad) {
+        if (e->inicio == e->fin) {
+            pthread_cond_wait(&e->cambio, &e->mutex);
+            continue;
+        }
+        Tarea* tarea = &e->tareas[e->listas[e->inicio++]];
+        pthread_mutex_lock(&mutex_en_curso);
+        en_curso++;
+        pthread_mutex_unlock(&mutex_en_curso);
+        pthread_mutex_unlock(&e->mutex);
+
+        ejecutar_tarea(e, tarea);
+
+        pthread_mutex_lock(&mutex_en_curso);
+        if (--en_curso == 0) pthread_cond_broadcast(&fin_en_curso);
+        pthread_mutex_unlock(&mutex_en_curso);
+        pthread_mutex_lock(&e->mutex);
+        tarea->terminada = 1;
+        e->terminadas++;
+        for (int i = 0; i < tarea->num_dependientes; i++) {
+            int d = tarea->dependientes[i];
+            if (--e->tareas[d].faltan == 0) e->listas[e->fin++] = d;
+        }
+        pthread_cond_broadcast(&e->cambio);
+    }
+    soltar(e);
+    return NULL;
+}
+
+// Sin root, sudo puede pedir la contraseña: se valida una sola vez antes de
+// lanzar los hilos para que no haya varios prompts a la vez en la terminal
+static void validar_sudo(const KnobWrite* writes, int cantidad) {
+    if (geteuid() == 0) return;
+    for (int i = 0; i < cantidad; i++) {
+        char ruta[512];
+        char cmd[512];
+        int necesita = knob_ruta(writes[i].id, ruta, sizeof(ruta))
+                       ? access(ruta, W_OK) != 0
+                       : knob_comando(writes[i].id, writes[i].valor, cmd, sizeof(cmd));
+        if (necesita) {
+            fflush(stdout);
+            execute_system_command_status("sudo -v");
+            return;
+        }
+    }
+}
+
+static void calcular_limite(struct timespec* limite, int plazo_ms) {
+    clock_gettime(CLOCK_REALTIME, limite);
+    limite->tv_sec += plazo_ms / 1000;
+    limite->tv_nsec += (long)(plazo_ms % 1000) * 1000000;
+    if (limite->tv_nsec >= 1000000000) {
+        limite->tv_sec++;
+        limite->tv_nsec -= 1000000000;
+    }
+}
+
+// Esperar a que terminen las tareas de lotes anteriores; 0 si vence el plazo
+static int esperar_en_curso(const struct timespec* limite) {
+    int libre = 1;
+    pthread_mutex_lock(&mutex_en_curso);
+    while (en_curso > 0) {
+        if (pthread_cond_timedwait(&fin_en_curso, &mutex_en_curso, limite) == ETIMEDOUT) {
+            libre = en_curso == 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mutex_en_curso);
+    return libre;
+}
+
+int ejecutor_aplicar(KnobWrite* writes, int cantidad, int plazo_ms) {
+    if (cantidad > 0) validar_sudo(writes, cantidad);
+    return ejecutor_aplicar_con(writes, cantidad, plazo_ms, knob_aplicar_local);
+}
+
+int ejecutor_aplicar_con(KnobWrite* writes, int cantidad, int plazo_ms, EjecutorEscribir escribir) {
+    if (cantidad <= 0) return 0;
+
+    // El plazo cuenta desde ahora: incluye la espera por el lote anterior
+    struct timespec limite;
+    calcular_limite(&limite, plazo_ms);
+    if (!esperar_en_curso(&limite)) {
+        for (int i = 0; i < cantidad; i++) {
+            writes[i].resultado = KNOB_ERROR;
+            writes[i].error = EBUSY;
+            writes[i].via_comando = 0;
+            writes[i].duracion_us = 0;
+        }
+        return 0;
+    }
+
+    // La configuración del simulador se carga antes de que haya hilos
+    sim_activo();
+
+    Ejecucion* e = calloc(1, sizeof(Ejecucion));
+    e->tareas = calloc(cantidad, sizeof(Tarea));
+    e->listas = malloc(cantidad * sizeof(int));
+    e->cantidad = cantidad;
+    e->escribir = escribir;
+    for (int i = 0; i < cantidad; i++) {
+        e->tareas[i].write = writes[i];
+        e->tareas[i].write.duracion_us = 0;
+    }
+    armar_dependencias(e->tareas, cantidad);
+    for (int i = 0; i < cantidad; i++) {
+        if (e->tareas[i].faltan == 0) e->listas[e->fin++] = i;
+    }
+
+    pthread_mutex_init(&e->mutex, NULL);
+    pthread_cond_init(&e->cambio, NULL);
+
+    int hilos = cantidad < EJECUTOR_MAX_HILOS ? cantidad : EJECUTOR_MAX_HILOS;
+    e->referencias = 1;
+    for (int i = 0; i < hilos; i++) {
+        pthread_t hilo;
+        pthread_mutex_lock(&e->mutex);
+        e->referencias++;
+        pthread_mutex_unlock(&e->mutex);
+        if (pthread_create(&hilo, NULL, hilo_ejecutor, e) != 0) {
+            pthread_mutex_lock(&e->mutex);
+            e->referencias--;
+            pthread_mutex_unlock(&e->mutex);
+            break;
+        }
+        pthread_detach(hilo);
+    }
+
+    // Si no se pudo crear ningún hilo, el llamador hace de hilo (sin plazo)
+    pthread_mutex_lock(&e->mutex);
+    if (e->referencias == 1) {
+        e->referencias++;
+        pthread_mutex_unlock(&e->mutex);
+        hilo_ejecutor(e);
+        pthread_mutex_lock(&e->mutex);
+    }
+    while (e->terminadas < cantidad) {
+        if (pthread_cond_timedwait(&e->cambio, &e->mutex, &limite) == ETIMEDOUT) break;
+    }
+
+    int aplicados = 0;
+    for (int i = 0; i < cantidad; i++) {
+        if (e->tareas[i].terminada) {
+            writes[i] = e->tareas[i].write;
+        } else {
+            writes[i].resultado = KNOB_ERROR;
+            writes[i].error = ETIMEDOUT;
+            writes[i].via_comando = 0;
+            writes[i].duracion_us = plazo_ms * 1000;
+        }
+        if (writes[i].resultado != KNOB_ERROR) aplicados++;
+    }
+
+    e->abandonada = 1;
+    pthread_cond_broadcast(&e->cambio);
+    soltar(e);
+    return aplicados;
+}
@@ -0,0 +1,545 @@
+// glxd - Daemon privilegiado de GLX
+// Corre como root, mantiene abiertos los atributos sysfs de cada knob y atiende
+// peticiones "apply"/"query" de gx por un socket Unix (root y grupo glx).
+// Así gx nunca lanza sudo. Cada apply lo aplica un hilo con el ejecutor
+// paralelo (ejecutor.c), mientras el bucle de poll sigue atendiendo al resto.
+//
+// Uso:
+//   glxd                          - Daemon real (requiere root)
+//   glxd --mock DIR               - Trabaja contra un árbol sysfs falso en DIR; los
+//                                   knobs de comandos (nvidia-smi, legion_cli) se
+//                                   guardan en DIR/glxd/<knob> sin ejecutar nada
+//   glxd --socket RUTA            - Socket a usar (por defecto GLX_SOCKET o /run/glxd.sock)
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <grp.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "../include/knobs.h"
+#include "../include/glxd.h"
+#include "../include/ejecutor.h"
+#include "../include/sim.h"
+#include "../include/gpu_telemetry.h"
+
+static int knob_fds[KNOB_COUNT];
+static int modo_mock = 0;
+static volatile sig_atomic_t terminar = 0;
+
+static void manejar_senal(int sig) {
+    (void)sig;
+    terminar = 1;
+}
+
+// Abrir una sola vez el atributo sysfs de cada knob
+static void abrir_knob(int id) {
+    char ruta[512];
+    knob_fds[id] = -1;
+    if (!knob_ruta(id, ruta, sizeof(ruta))) return;
+
+    knob_fds[id] = open(ruta, O_RDWR | O_CLOEXEC);
+    if (knob_fds[id] < 0) {
+        knob_fds[id] = open(ruta, O_WRONLY | O_CLOEXEC);
+    }
+    if (knob_fds[id] < 0) {
+        fprintf(stderr, "glxd: no se pudo abrir %s: %s\n", ruta, strerror(errno));
+    }
+}
+
+static void abrir_knobs(void) {
+    for (int i = 0; i < KNOB_COUNT; i++) {
+        abrir_knob(i);
+    }
+}
+
+// Escribir un valor por el descriptor ya abierto
+static int escribir_fd(int id, const char* valor) {
+    size_t len = strlen(valor);
+    ssize_t n = pwrite(knob_fds[id], valor, len, 0);
+    if (n < 0 && (errno == EBADF || errno == ENODEV)) {
+        // El dispositivo pudo re-enumerarse: reabrir una vez y reintentar
+        close(knob_fds[id]);
+        abrir_knob(id);
+        if (knob_fds[id] < 0) return errno ? errno : ENOENT;
+        n = pwrite(knob_fds[id], valor, len, 0);
+    }
+    if (n != (ssize_t)len) return n < 0 ? errno : EIO;
+
+    // En un árbol falso son archivos comunes: recortar restos de un valor más largo
+    if (modo_mock && ftruncate(knob_fds[id], len) != 0) return errno;
+    return 0;
+}
+
+// En modo mock un knob de comando no ejecuta nada: su valor vive en DIR/glxd/<knob>
+static int es_knob_comando(int id) {
+    char cmd[256];
+    return knob_fds[id] < 0 && knob_comando(id, "0", cmd, sizeof(cmd));
+}
+
+static void ruta_mock(int id, char* buffer, size_t size) {
+    snprintf(buffer, size, "%s/glxd/%s", knobs_get_root(), knob_nombre(id));
+}
+
+static int escribir_mock(int id, const char* valor) {
+    char ruta[512];
+    snprintf(ruta, sizeof(ruta), "%s/glxd", knobs_get_root());
+    if (mkdir(ruta, 0755) != 0 && errno != EEXIST) return errno;
+    ruta_mock(id, ruta, sizeof(ruta));
+    int fd = open(ruta, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return errno;
+    size_t len = strlen(valor);
+    int error = write(fd, valor, len) == (ssize_t)len ? 0 : EIO;
+    close(fd);
+    return error;
+}
+
+static int leer_mock(int id, char* valor, size_t size) {
+    char ruta[512];
+    ruta_mock(id, ruta, sizeof(ruta));
+    int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    ssize_t n = read(fd, valor, size - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    valor[n] = '\0';
+    valor[strcspn(valor, "\n")] = '\0';
+    return 1;
+}
+
+// Aplicar una escritura (la llama el ejecutor, desde sus hilos)
+static void escribir_knob(KnobWrite* write) {
+    write->resultado = KNOB_ERROR;
+    write->error = 0;
+    write->via_comando = 0;
+    if (!knob_validar(write->id, write->valor)) {
+        write->error = EINVAL;
+        return;
+    }
+
+    if (modo_mock) {
+        // Latencia y fallas del simulador (GLX_SIM_LATENCIA), por clase como
+        // en gx: "sysfs" o el programa del comando (nvidia-smi, legion_cli)
+        char clase[256] = "sysfs";
+        if (knob_fds[write->id] < 0 && knob_comando(write->id, write->valor, clase, sizeof(clase))) {
+            char* programa = strncmp(clase, "sudo ", 5) == 0 ? clase + 5 : clase;
+            programa[strcspn(programa, " ")] = '\0';
+            memmove(clase, programa, strlen(programa) + 1);
+        }
+        if (sim_operacion(knob_nombre(write->id), clase) != 0) {
+            write->error = errno;
+            return;
+        }
+    }
+
+    if (knob_fds[write->id] >= 0 || (modo_mock && es_knob_comando(write->id))) {
+        int error = knob_fds[write->id] >= 0 ? escribir_fd(write->id, write->valor)
+                                             : escribir_mock(write->id, write->valor);
+        if (error == 0) write->resultado = KNOB_OK;
+        else write->error = error;
+        return;
+    }
+
+    // Knobs sin atributo sysfs (nvidia-smi, legion_cli): ejecutar sin sudo
+    knob_aplicar_local(write);
+}
+
+// Máximo de knobs por petición (un knob repetido cuenta dos veces)
+#define GLXD_MAX_ITEMS (GLXD_MAX_LINE / 4)
+
+static void atender_apply(char* args, char* respuesta, size_t size) {
+    char* nombres[GLXD_MAX_ITEMS];
+    char resultados[GLXD_MAX_ITEMS][16];
+    KnobWrite writes[GLXD_MAX_ITEMS];
+    int items_write[GLXD_MAX_ITEMS];       // Item de la petición de cada write
+    int num_items = 0;
+    int num_writes = 0;
+    char* save = NULL;
+
+    for (char* item = strtok_r(args, " ", &save); item && num_items < GLXD_MAX_ITEMS; item = strtok_r(NULL, " ", &save)) {
+        char* igual = strchr(item, '=');
+        int id = -1;
+        if (igual) {
+            *igual = '\0';
+            id = knob_buscar(item);
+        }
+
+        nombres[num_items] = item;
+        snprintf(resultados[num_items], sizeof(resultados[num_items]), "e%d", EINVAL);
+        if (id >= 0) {
+            knob_write_init(&writes[num_writes], id, igual + 1);
+            items_write[num_writes++] = num_items;
+        }
+        num_items++;
+    }
+
+    // El mismo ejecutor que gx sin daemon: cada backend en su hilo y con el
+    // orden que exigen las restricciones (cpu_min_perf/cpu_max_perf,
+    // frecuencias, governor antes que EPP)
+    ejecutor_aplicar_con(writes, num_writes, GLXD_PLAZO_MS, escribir_knob);
+    for (int i = 0; i < num_writes; i++) {
+        const KnobWrite* w = &writes[i];
+        char* resultado = resultados[items_write[i]];
+        if (w->resultado != KNOB_ERROR) snprintf(resultado, sizeof(resultados[0]), "ok");
+        else snprintf(resultado, sizeof(resultados[0]), "%c%d", w->via_comando ? 'x' : 'e', w->error);
+    }
+
+    // La respuesta va en el orden de la petición
+    int n = snprintf(respuesta, size, "ok");
+    for (int i = 0; i < num_items; i++) {
+        n += snprintf(respuesta + n, size - n, " %s=%s", nombres[i], resultados[i]);
+        if (n >= (int)size) break;
+    }
+}
+
+static void atender_query(char* respuesta, size_t size) {
+    int n = snprintf(respuesta, size, "ok");
+
+    for (int i = 0; i < KNOB_COUNT && n < (int)size; i++) {
+        char valor[32];
+        if (knob_fds[i] >= 0) {
+            ssize_t leidos = pread(knob_fds[i], valor, sizeof(valor) - 1, 0);
+            if (leidos <= 0) continue;
+            valor[leidos] = '\0';
+            valor[strcspn(valor, "\n ")] = '\0';
+        } else if (modo_mock && es_knob_comando(i)) {
+            if (!leer_mock(i, valor, sizeof(valor))) continue;
+        } else if (!knob_leer_local(i, valor, sizeof(valor))) {
+            continue;
+        }
+        n += snprintf(respuesta + n, size - n, " %s=%s", knob_nombre(i), valor);
+    }
+}
+
+static int es_apply(const char* linea) {
+    return strncmp(linea, "apply", 5) == 0 && (linea[5] == ' ' || linea[5] == '\0');
+}
+
+static void atender_linea(char* linea, char* respuesta, size_t size) {
+    if (es_apply(linea)) {
+        atender_apply(linea + 5, respuesta, size - 1);
+    } else if (strcmp(linea, "query") == 0) {
+        atender_query(respuesta, size - 1);
+    } else if (strcmp(linea, "ping") == 0) {
+        snprintf(respuesta, size - 1, "ok");
+    } else {
+        snprintf(respuesta, size - 1, "err peticion desconocida");
+    }
+    strcat(respuesta, "\n");
+}
+
+// Conexión de un cliente; el daemon atiende a todos desde un solo poll, así
+// que un cliente que no manda nada no frena a los demás
+typedef struct {
+    int fd;                     // -1 si el lugar está libre
+    char buffer[GLXD_MAX_LINE];
+    size_t usados;
+    long long ultimo_ms;        // Última actividad, para cortar conexiones ociosas
+    int bloqueado;              // Su "apply" está en curso o esperando turno
+} Cliente;
+
+static Cliente clientes[GLXD_MAX_CLIENTES];
+
+// Lote en curso: lo aplica un hilo mientras el bucle principal sigue
+// respondiendo query y ping a los demás. Hay uno solo a la vez; los apply
+// de otros clientes esperan su turno sin que se lea más de ellos
+typedef struct {
+    pthread_t hilo;
+    Cliente* cliente;           // NULL si no hay lote en curso
+    char linea[GLXD_MAX_LINE];
+    char respuesta[GLXD_MAX_LINE + 2];
+} Lote;
+
+static Lote lote;
+static int aviso[2] = { -1, -1 };     // El hilo del lote avisa que terminó
+
+static long long ahora_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void cerrar_cliente(Cliente* c) {
+    close(c->fd);
+    c->fd = -1;
+    c->bloqueado = 0;
+}
+
+static void* hilo_lote(void* arg) {
+    (void)arg;
+    atender_linea(lote.linea, lote.respuesta, sizeof(lote.respuesta));
+    char listo = 1;
+    if (write(aviso[1], &listo, 1) != 1) perror("glxd: aviso");
+    return NULL;
+}
+
+static int lanzar_lote(Cliente* c, const char* linea) {
+    snprintf(lote.linea, sizeof(lote.linea), "%s", linea);
+    lote.cliente = c;
+    if (pthread_create(&lote.hilo, NULL, hilo_lote, NULL) != 0) {
+        // Sin hilo se aplica acá, como antes
+        lote.cliente = NULL;
+        return 0;
+    }
+    c->bloqueado = 1;
+    return 1;
+}
+
+// Responder las líneas completas del buffer hasta que un apply quede en
+// curso o esperando turno. Retorna -1 si hay que cerrar la conexión
+static int procesar_lineas(Cliente* c) {
+    char respuesta[GLXD_MAX_LINE + 2];
+    char* inicio = c->buffer;
+    char* salto;
+    while (!c->bloqueado && (salto = strchr(inicio, '\n')) != NULL) {
+        *salto = '\0';
+        if (es_apply(inicio)) {
+            if (lote.cliente) {
+                *salto = '\n';
+                c->bloqueado = 1;
+                break;
+            }
+            if (lanzar_lote(c, inicio)) {
+                inicio = salto + 1;
+                break;
+            }
+        }
+        atender_linea(inicio, respuesta, sizeof(respuesta));
+        // La respuesta entra de sobra en el buffer del socket; si no, el
+        // cliente no está leyendo y se lo corta
+        size_t len = strlen(respuesta);
+        if (write(c->fd, respuesta, len) != (ssize_t)len) return -1;
+        inicio = salto + 1;
+    }
+
+    c->usados = strlen(inicio);
+    memmove(c->buffer, inicio, c->usados + 1);
+    return 0;
+}
+
+static void aceptar_clientes(int servidor) {
+    for (;;) {
+        int fd = accept4(servidor, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0) return;     // EAGAIN: no hay más pendientes
+
+        Cliente* libre = NULL;
+        for (int i = 0; i < GLXD_MAX_CLIENTES && !libre; i++) {
+            if (clientes[i].fd < 0) libre = &clientes[i];
+        }
+        if (!libre) {
+            // Sin lugar: el cliente ve la conexión cerrada
+            close(fd);
+            continue;
+        }
+        libre->fd = fd;
+        libre->usados = 0;
+        libre->buffer[0] = '\0';
+        libre->bloqueado = 0;
+        libre->ultimo_ms = ahora_ms();
+    }
+}
+
+// Leer lo disponible y responder cada línea completa
+// Retorna 0 si la conexión sigue abierta
+static int atender_cliente(Cliente* c) {
+    ssize_t n = read(c->fd, c->buffer + c->usados, sizeof(c->buffer) - 1 - c->usados);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) return 0;
+    if (n <= 0) return -1;
+    c->usados += n;
+    c->buffer[c->usados] = '\0';
+    c->ultimo_ms = ahora_ms();
+
+    if (procesar_lineas(c) != 0) return -1;
+    if (!c->bloqueado && c->usados == sizeof(c->buffer) - 1) return -1; // Línea demasiado larga
+    return 0;
+}
+
+// El lote terminó: responder a su cliente y dar el turno al siguiente apply
+static void terminar_lote(void) {
+    char listo;
+    if (read(aviso[0], &listo, 1) != 1) return;
+    pthread_join(lote.hilo, NULL);
+    Cliente* c = lote.cliente;
+    lote.cliente = NULL;
+
+    c->bloqueado = 0;
+    c->ultimo_ms = ahora_ms();
+    size_t len = strlen(lote.respuesta);
+    if (write(c->fd, lote.respuesta, len) != (ssize_t)len || procesar_lineas(c) != 0) cerrar_cliente(c);
+
+    for (int i = 0; i < GLXD_MAX_CLIENTES && !lote.cliente; i++) {
+        Cliente* otro = &clientes[i];
+        if (otro->fd < 0 || !otro->bloqueado) continue;
+        otro->bloqueado = 0;
+        otro->ultimo_ms = ahora_ms();
+        if (procesar_lineas(otro) != 0) cerrar_cliente(otro);
+    }
+}
+
+static void servir(int servidor) {
+    for (int i = 0; i < GLXD_MAX_CLIENTES; i++) clientes[i].fd = -1;
+
+    while (!terminar) {
+        struct pollfd fds[GLXD_MAX_CLIENTES + 3];
+        int indices[GLXD_MAX_CLIENTES + 3];
+        int cantidad = 0;
+        fds[cantidad++] = (struct pollfd){ servidor, POLLIN, 0 };
+        fds[cantidad++] = (struct pollfd){ aviso[0], POLLIN, 0 };
+        fds[cantidad++] = (struct pollfd){ gpu_telemetry_fd(), POLLIN, 0 };    // poll ignora un fd negativo
+        for (int i = 0; i < GLXD_MAX_CLIENTES; i++) {
+            // De un cliente con un apply pendiente no se lee más hasta responderlo
+            if (clientes[i].fd < 0 || clientes[i].bloqueado) continue;
+            indices[cantidad] = i;
+            fds[cantidad++] = (struct pollfd){ clientes[i].fd, POLLIN, 0 };
+        }
+
+        int listos = poll(fds, cantidad, GLXD_OCIOSO_MS);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            perror("glxd: poll");
+            break;
+        }
+
+        if (gpu_telemetry_activa() && (listos == 0 || fds[2].revents)) gpu_telemetry_actualizar();
+        for (int k = 3; k < cantidad; k++) {
+            Cliente* c = &clientes[indices[k]];
+            if (fds[k].revents && atender_cliente(c) != 0) cerrar_cliente(c);
+        }
+        if (fds[1].revents & POLLIN) terminar_lote();
+        if (fds[0].revents & POLLIN) aceptar_clientes(servidor);
+
+        long long ahora = ahora_ms();
+        for (int i = 0; i < GLXD_MAX_CLIENTES; i++) {
+            if (clientes[i].fd >= 0 && !clientes[i].bloqueado && ahora - clientes[i].ultimo_ms >= GLXD_OCIOSO_MS) {
+                cerrar_cliente(&clientes[i]);
+            }
+        }
+    }
+
+    // Un lote a medio aplicar se termina antes de salir
+    if (lote.cliente) pthread_join(lote.hilo, NULL);
+    for (int i = 0; i < GLXD_MAX_CLIENTES; i++) {
+        if (clientes[i].fd >= 0) cerrar_cliente(&clientes[i]);
+    }
+}
+
+static int crear_socket(const char* path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "glxd: ruta de socket demasiado larga: %s\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        perror("glxd: socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    // Si quedó un socket de una ejecución anterior y nadie escucha, reemplazarlo
+    int sonda = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sonda >= 0 && connect(sonda, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        fprintf(stderr, "glxd: ya hay un daemon escuchando en %s\n", path);
+        close(sonda);
+        close(fd);
+        return -1;
+    }
+    if (sonda >= 0) close(sonda);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+        fprintf(stderr, "glxd: no se pudo escuchar en %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    // Solo root y el grupo glx pueden pedir cambios; sin el grupo (o en
+    // --mock) el socket queda solo para su dueño
+    struct group* grupo = getgrnam(GLXD_GRUPO);
+    if (grupo && !modo_mock && geteuid() == 0 && chown(path, 0, grupo->gr_gid) == 0) {
+        chmod(path, 0660);
+    } else {
+        chmod(path, 0600);
+    }
+    return fd;
+}
+
+int main(int argc, char* argv[]) {
+    const char* socket_path = NULL;
+    const char* mock_root = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mock") == 0 && i + 1 < argc) {
+            mock_root = argv[++i];
+        } else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else {
+            fprintf(stderr, "Uso: glxd [--mock DIR] [--socket RUTA]\n");
+            return 1;
+        }
+    }
+
+    if (mock_root) {
+        modo_mock = 1;
+        knobs_set_root(mock_root);
+    } else if (geteuid() != 0) {
+        fprintf(stderr, "glxd: se necesita root (usa --mock DIR para pruebas)\n");
+        return 1;
+    }
+    if (!socket_path) socket_path = glxd_socket_path();
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = manejar_senal; // Sin SA_RESTART para que poll() se interrumpa
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    abrir_knobs();
+
+    // persistence_mode sale de un nvidia-smi que queda corriendo: un query no
+    // lanza uno nuevo cada vez. Sin GPU el productor muere enseguida y se
+    // deja de lado (knob_leer_local vuelve a consultar como antes)
+    if (!modo_mock && gpu_telemetry_iniciar(GLXD_GPU_INTERVALO_MS) == 0) {
+        GpuSample muestra;
+        if (!gpu_telemetry_esperar(&muestra, GLXD_GPU_ESPERA_MS)) gpu_telemetry_detener();
+    }
+
+    if (pipe2(aviso, O_CLOEXEC) != 0) {
+        perror("glxd: pipe");
+        return 1;
+    }
+
+    int servidor = crear_socket(socket_path);
+    if (servidor < 0) return 1;
+
+    if (modo_mock) {
+        fprintf(stderr, "glxd: escuchando en %s (mock: %s)\n", socket_path, mock_root);
+    } else {
+        fprintf(stderr, "glxd: escuchando en %s\n", socket_path);
+    }
+
+    servir(servidor);
+
+    gpu_telemetry_detener();
+    close(servidor);
+    unlink(socket_path);
+    for (int i = 0; i < KNOB_COUNT; i++) {
+        if (knob_fds[i] >= 0) close(knob_fds[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "../include/glxd.h"
+
+const char* glxd_socket_path(void) {
+    const char* env = getenv("GLX_SOCKET");
+    return (env && *env) ? env : GLXD_SOCKET_PATH;
+}
+
+// Conectarse al daemon
+// Retorna el descriptor, GLXD_AUSENTE si el daemon no puede haber recibido
+// nada (no hay socket, nadie escucha o no tenemos permiso) o GLXD_FALLO
+static int glxd_conectar(void) {
+    const char* path = glxd_socket_path();
+    if (strlen(path) >= sizeof(((struct sockaddr_un*)0)->sun_path)) return GLXD_AUSENTE;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return GLXD_FALLO;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return error == ENOENT || error == ECONNREFUSED || error == EACCES ? GLXD_AUSENTE : GLXD_FALLO;
+    }
+
+    // Un daemon colgado no debe bloquear a gx (GLXD_PLAZO_MS queda por debajo)
+    struct timeval timeout = { GLXD_ESPERA_MS / 1000, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+// Enviar una petición y leer la línea de respuesta completa
+// Retorna 0, GLXD_AUSENTE o GLXD_FALLO con errno (ETIMEDOUT si el daemon no
+// respondió a tiempo, EPROTO si cortó o respondió "err")
+static int glxd_transaccion(const char* peticion, char* respuesta, size_t size) {
+    int fd = glxd_conectar();
+    if (fd < 0) return fd;
+
+    size_t len = strlen(peticion);
+    if (write(fd, peticion, len) != (ssize_t)len) {
+        close(fd);
+        errno = EPROTO;
+        return GLXD_FALLO;
+    }
+
+    size_t total = 0;
+    int error = EPROTO;
+    while (total < size - 1) {
+        ssize_t n = read(fd, respuesta + total, size - 1 - total);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) error = ETIMEDOUT;
+        if (n <= 0) break;
+        total += n;
+        if (memchr(respuesta + total - n, '\n', n)) break;
+    }
+    close(fd);
+
+    respuesta[total] = '\0';
+    char* salto = strchr(respuesta, '\n');
+    if (!salto || strncmp(respuesta, "ok", 2) != 0) {
+        errno = salto ? EPROTO : error;
+        return GLXD_FALLO;
+    }
+    *salto = '\0';
+    return 0;
+}
+
+int glxd_aplicar(KnobWrite* writes, int cantidad) {
+    char peticion[GLXD_MAX_LINE];
+    char respuesta[GLXD_MAX_LINE];
+
+    int n = snprintf(peticion, sizeof(peticion), "apply");
+    for (int i = 0; i < cantidad; i++) {
+        n += snprintf(peticion + n, sizeof(peticion) - n, " %s=%s", knob_nombre(writes[i].id), writes[i].valor);
+        // Un lote que no entra en una línea no se manda: el daemon no lo vio
+        if (n >= (int)sizeof(peticion) - 1) return GLXD_AUSENTE;
+    }
+    peticion[n++] = '\n';
+    peticion[n] = '\0';
+
+    int resultado = glxd_transaccion(peticion, respuesta, sizeof(respuesta));
+    if (resultado != 0) return resultado;
+
+    // La respuesta trae un resultado por knob, en el mismo orden de la petición
+    char* save = NULL;
+    char* item = strtok_r(respuesta + 2, " ", &save);
+    for (int i = 0; i < cantidad; i++) {
+        writes[i].resultado = KNOB_ERROR;
+        writes[i].error = 0;
+        writes[i].via_comando = 0;
+
+        char* igual = item ? strchr(item, '=') : NULL;
+        if (!igual) {
+            writes[i].error = EPROTO;
+        } else if (strcmp(igual + 1, "ok") == 0) {
+            writes[i].resultado = KNOB_OK_DAEMON;
+        } else {
+            writes[i].via_comando = igual[1] == 'x';
+            writes[i].error = atoi(igual + 2);
+        }
+        item = strtok_r(NULL, " ", &save);
+    }
+    return 0;
+}
+
+int glxd_consultar(char valores[KNOB_COUNT][32]) {
+    char respuesta[GLXD_MAX_LINE];
+    for (int i = 0; i < KNOB_COUNT; i++) valores[i][0] = '\0';
+
+    if (glxd_transaccion("query\n", respuesta, sizeof(respuesta)) != 0) return -1;
+
+    char* save = NULL;
+    for (char* item = strtok_r(respuesta + 2, " ", &save); item; item = strtok_r(NULL, " ", &save)) {
+        char* igual = strchr(item, '=');
+        if (!igual) continue;
+        *igual = '\0';
+        int id = knob_buscar(item);
+        if (id < 0) continue;
+        strncpy(valores[id], igual + 1, 31);
+        valores[id][31] = '\0';
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../include/gpu_telemetry.h"
+
+// persistence_mode va al final: así knobs.c lo lee de acá en vez de lanzar
+// otro nvidia-smi (la línea que se muestra corta antes de ese campo)
+#define GPU_QUERY "--query-gpu=name,power.draw,temperature.gpu,clocks.current.graphics,persistence_mode"
+
+// Tiempo mínimo entre relanzamientos para no girar en falso si nvidia-smi falla
+#define REINICIO_MIN_MS 1000
+
+static pid_t productor_pid = -1;
+static int productor_fd = -1;
+static int productor_intervalo_ms = 0;
+static long long ultimo_inicio_ms = 0;
+
+// Línea parcial pendiente entre lecturas del pipe
+static char pendiente[512];
+static size_t pendiente_len = 0;
+
+static GpuSample ultima;
+
+static long long ahora_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Campo numérico de nvidia-smi: "[N/A]" o "[Not Supported]" se devuelven como -1
+static double parsear_numero(const char* campo) {
+    while (*campo == ' ') campo++;
+    if (*campo == '[' || *campo == '\0') return -1;
+    return atof(campo);
+}
+
+int gpu_telemetry_parsear_linea(const char* linea, GpuSample* sample) {
+    char copia[256];
+    strncpy(copia, linea, sizeof(copia) - 1);
+    copia[sizeof(copia) - 1] = '\0';
+    copia[strcspn(copia, "\r\n")] = '\0';
+
+    char* campos[5];
+    int n = 0;
+    char* save = NULL;
+    for (char* c = strtok_r(copia, ",", &save); c && n < 5; c = strtok_r(NULL, ",", &save)) {
+        campos[n++] = c;
+    }
+    if (n < 4) return 0;
+
+    strncpy(sample->linea, linea, sizeof(sample->linea) - 1);
+    sample->linea[sizeof(sample->linea) - 1] = '\0';
+    sample->linea[strcspn(sample->linea, "\r\n")] = '\0';
+    if (n == 5) sample->linea[campos[4] - copia - 1] = '\0';
+
+    while (*campos[0] == ' ') campos[0]++;
+    strncpy(sample->nombre, campos[0], sizeof(sample->nombre) - 1);
+    sample->nombre[sizeof(sample->nombre) - 1] = '\0';
+
+    sample->potencia_w = parsear_numero(campos[1]);
+    sample->temperatura_c = (int)parsear_numero(campos[2]);
+    sample->reloj_mhz = (int)parsear_numero(campos[3]);
+    sample->persistencia = -1;
+    if (n == 5) {
+        while (*campos[4] == ' ') campos[4]++;
+        if (strcmp(campos[4], "Enabled") == 0) sample->persistencia = 1;
+        else if (strcmp(campos[4], "Disabled") == 0) sample->persistencia = 0;
+    }
+    sample->timestamp_ms = ahora_ms();
+    sample->valida = 1;
+    return 1;
+}
+
+int gpu_telemetry_iniciar(int intervalo_ms) {
+    if (productor_pid > 0) return 0;
+    if (intervalo_ms <= 0) intervalo_ms = 500;
+    productor_intervalo_ms = intervalo_ms;
+
+    int pipefd[2];
+    if (pipe2(pipefd, O_CLOEXEC) != 0) return -1;
+
+    const char* binario = getenv("GLX_NVIDIA_SMI");
+    if (!binario || !*binario) binario = "nvidia-smi";
+
+    char intervalo[16];
+    snprintf(intervalo, sizeof(intervalo), "%d", intervalo_ms);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        dup2(pipefd[1], STDOUT_FILENO);
+        int nulo = open("/dev/null", O_WRONLY);
+        if (nulo >= 0) dup2(nulo, STDERR_FILENO);
+        execlp(binario, binario, GPU_QUERY, "--format=csv,noheader,nounits", "-lms", intervalo, (char*)NULL);
+        _exit(127);
+    }
+
+    close(pipefd[1]);
+    fcntl(pipefd[0], F_SETFL, fcntl(pipefd[0], F_GETFL) | O_NONBLOCK);
+    productor_pid = pid;
+    productor_fd = pipefd[0];
+    pendiente_len = 0;
+    ultimo_inicio_ms = ahora_ms();
+    return 0;
+}
+
+int gpu_telemetry_fd(void) {
+    return productor_fd;
+}
+
+int gpu_telemetry_activa(void) {
+    return productor_intervalo_ms > 0;
+}
+
+// Cerrar el pipe y cosechar el proceso (ya terminado o no)
+static void cerrar_productor(int matar) {
+    if (productor_fd >= 0) {
+        close(productor_fd);
+        productor_fd = -1;
+    }
+    if (productor_pid > 0) {
+        if (matar) kill(productor_pid, SIGTERM);
+        waitpid(productor_pid, NULL, 0);
+        productor_pid = -1;
+    }
+    pendiente_len = 0;
+}
+
+// Separar las líneas completas del pipe y quedarse con la más reciente
+static void procesar_datos(const char* datos, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (datos[i] == '\n') {
+            pendiente[pendiente_len] = '\0';
+            gpu_telemetry_parsear_linea(pendiente, &ultima);
+            pendiente_len = 0;
+        } else if (pendiente_len < sizeof(pendiente) - 1) {
+            pendiente[pendiente_len++] = datos[i];
+        }
+    }
+}
+
+void gpu_telemetry_actualizar(void) {
+    if (productor_fd >= 0) {
+        char buffer[1024];
+        for (;;) {
+            ssize_t n = read(productor_fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                procesar_datos(buffer, n);
+                continue;
+            }
+            if (n == 0) {
+                // EOF: el proceso terminó
+                cerrar_productor(0);
+            }
+            break; // EAGAIN: no hay más datos por ahora
+        }
+    }
+
+    // Relanzar si murió, respetando un intervalo mínimo entre intentos
+    if (productor_fd < 0 && productor_intervalo_ms > 0 &&
+        ahora_ms() - ultimo_inicio_ms >= REINICIO_MIN_MS) {
+        gpu_telemetry_iniciar(productor_intervalo_ms);
+    }
+}
+
+int gpu_telemetry_ultima(GpuSample* sample) {
+    gpu_telemetry_actualizar();
+    *sample = ultima;
+    return ultima.valida;
+}
+
+int gpu_telemetry_esperar(GpuSample* sample, int timeout_ms) {
+    long long limite = ahora_ms() + timeout_ms;
+    gpu_telemetry_actualizar();
+
+    while (!ultima.valida && productor_fd >= 0) {
+        long long restante = limite - ahora_ms();
+        if (restante <= 0) break;
+
+        struct pollfd pfd = { productor_fd, POLLIN, 0 };
+        if (poll(&pfd, 1, (int)restante) < 0 && errno != EINTR) break;
+
+        if (productor_fd < 0) break;
+        char buffer[1024];
+        ssize_t n = read(productor_fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            procesar_datos(buffer, n);
+        } else if (n == 0) {
+            // Murió antes de dar una muestra (por ejemplo, no hay nvidia-smi)
+            cerrar_productor(0);
+        }
+    }
+
+    *sample = ultima;
+    return ultima.valida;
+}
+
+void gpu_telemetry_detener(void) {
+    productor_intervalo_ms = 0; // No relanzar
+    cerrar_productor(1);
+}
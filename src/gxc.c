@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/gxc.h"
+#include "../include/interpreter.h"
+#include "../include/mode_cache.h"
+#include "../include/params.h"
+#include "../include/salida.h"
+
+void gxc_ruta(const char* fuente, char* buffer, size_t size) {
+    size_t len = strlen(fuente);
+    if (len > 3 && strcmp(fuente + len - 3, ".gx") == 0) {
+        snprintf(buffer, size, "%sc", fuente);
+    } else {
+        snprintf(buffer, size, "%s.gxc", fuente);
+    }
+}
+
+// Verificar que todas las instrucciones apunten dentro del pool de constantes
+static int codigo_valido(const GxcInstr* codigo, uint32_t num_instr, const char* constantes, uint32_t tam) {
+    if (tam == 0 || constantes[tam - 1] != '\0') return 0;
+    for (uint32_t i = 0; i < num_instr; i++) {
+        const GxcInstr* in = &codigo[i];
+        if (in->tipo > NODE_SENSOR) return 0;
+        switch (in->op) {
+            case GXC_OP_DECLARE:
+                if (in->a >= PARAM_COUNT || in->b >= tam) return 0;
+                break;
+            case GXC_OP_DECLARE_NOMBRE:
+            case GXC_OP_ASSIGN:
+                if (in->a >= tam || in->b >= tam) return 0;
+                break;
+            case GXC_OP_RUN_MODE:
+            case GXC_OP_LITERAL:
+                if (in->b >= tam) return 0;
+                break;
+            case GXC_OP_COMMAND:
+                if (in->a >= tam) return 0;
+                break;
+            case GXC_OP_STATUS:
+                break;
+            default:
+                return 0;
+        }
+    }
+    return 1;
+}
+
+// Ubicar código y constantes dentro de una imagen completa (header incluido)
+static int ubicar(const void* imagen, size_t tamano, GxcPrograma* prog) {
+    if (tamano < sizeof(GxcHeader)) return -1;
+    const GxcHeader* h = imagen;
+    if (h->magic != GXC_MAGIC || h->version != GXC_VERSION || h->tam_instr != sizeof(GxcInstr)) return -1;
+    // Compilado con otra tabla de parámetros: los ParamId no significan lo mismo
+    if (h->params_huella != param_tabla_huella()) return -1;
+    if (tamano != sizeof(GxcHeader) + (size_t)h->num_instr * sizeof(GxcInstr) + h->tam_constantes) return -1;
+
+    prog->codigo = (const GxcInstr*)((const char*)imagen + sizeof(GxcHeader));
+    prog->num_instr = h->num_instr;
+    prog->constantes = (const char*)(prog->codigo + h->num_instr);
+    prog->tam_constantes = h->tam_constantes;
+    return codigo_valido(prog->codigo, prog->num_instr, prog->constantes, prog->tam_constantes) ? 0 : -1;
+}
+
+int gxc_abrir(const char* fuente, GxcPrograma* prog) {
+    memset(prog, 0, sizeof(*prog));
+
+    char ruta[1024];
+    gxc_ruta(fuente, ruta, sizeof(ruta));
+
+    struct stat st_fuente, st;
+    if (stat(fuente, &st_fuente) != 0) return -1;
+    int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(GxcHeader)) {
+        close(fd);
+        return -1;
+    }
+    void* mapa = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) return -1;
+
+    const GxcHeader* h = mapa;
+    int valido = ubicar(mapa, st.st_size, prog) == 0 && h->fuente_tamano == st_fuente.st_size;
+
+    // Mismo tamaño con otro mtime: vale si el contenido es el mismo
+    if (valido && h->fuente_mtime_ns != cache_mtime_ns(&st_fuente)) {
+        uint64_t hash;
+        valido = cache_hash_archivo(fuente, &hash) == 0 && hash == h->fuente_hash;
+    }
+
+    if (!valido) {
+        munmap(mapa, st.st_size);
+        memset(prog, 0, sizeof(*prog));
+        return -1;
+    }
+    prog->mapa = mapa;
+    prog->tamano = st.st_size;
+    return 0;
+}
+
+// Estado del compilador: instrucciones y pool de constantes en crecimiento
+typedef struct {
+    GxcInstr* codigo;
+    uint32_t num_instr;
+    char* constantes;
+    uint32_t tam_constantes;
+    uint32_t cap_constantes;
+} Compilador;
+
+static uint32_t agregar_constante(Compilador* c, const char* texto) {
+    uint32_t len = strlen(texto) + 1;
+    if (c->tam_constantes + len > c->cap_constantes) {
+        while (c->tam_constantes + len > c->cap_constantes) {
+            c->cap_constantes = c->cap_constantes ? c->cap_constantes * 2 : 1024;
+        }
+        c->constantes = realloc(c->constantes, c->cap_constantes);
+    }
+    uint32_t offset = c->tam_constantes;
+    memcpy(c->constantes + offset, texto, len);
+    c->tam_constantes += len;
+    return offset;
+}
+
+// Emitir la instrucción de una sentencia; retorna 0 si la sentencia no hace nada
+static int compilar_sentencia(Compilador* c, const AST* ast, const ASTNode* node) {
+    GxcInstr* in = &c->codigo[c->num_instr];
+    memset(in, 0, sizeof(*in));
+    in->linea = node->linea;
+    in->columna = node->columna > UINT16_MAX ? UINT16_MAX : node->columna;
+
+    const ASTNode* valor = ast_hijo(ast, node, 0);
+    switch (node->type) {
+        case NODE_DECLARATION: {
+            if (!valor) return 0;
+            int parametro = param_buscar(node->value);
+            if (parametro >= 0) {
+                in->op = GXC_OP_DECLARE;
+                in->a = parametro;
+            } else {
+                in->op = GXC_OP_DECLARE_NOMBRE;
+                in->a = agregar_constante(c, node->value);
+            }
+            in->b = agregar_constante(c, valor->value);
+            in->tipo = valor->type;
+            break;
+        }
+        case NODE_ASSIGNMENT:
+            if (!valor) return 0;
+            in->op = GXC_OP_ASSIGN;
+            in->a = agregar_constante(c, node->value);
+            in->b = agregar_constante(c, valor->value);
+            in->tipo = valor->type;
+            break;
+        case NODE_RUN_COMMAND:
+            if (!valor) return 0;
+            in->op = GXC_OP_RUN_MODE;
+            in->b = agregar_constante(c, valor->value);
+            in->tipo = valor->type;
+            break;
+        case NODE_GPU_COMMAND:
+            if (strcmp(node->value, "status") == 0) {
+                in->op = GXC_OP_STATUS;
+            } else {
+                // Otros comandos (y los desconocidos, para la sugerencia) se resuelven al ejecutar
+                in->op = GXC_OP_COMMAND;
+                in->a = agregar_constante(c, node->value);
+            }
+            break;
+        case NODE_NUMBER:
+        case NODE_STRING:
+        case NODE_IDENTIFIER:
+            in->op = GXC_OP_LITERAL;
+            in->b = agregar_constante(c, node->value);
+            in->tipo = node->type;
+            break;
+        default:
+            // NODE_PROGRAM y NODE_SENSOR no son sentencias
+            return 0;
+    }
+    c->num_instr++;
+    return 1;
+}
+
+// Escribir la imagen en un temporal y renombrar
+static int guardar(const char* ruta, const void* imagen, size_t tamano) {
+    char temporal[1100];
+    snprintf(temporal, sizeof(temporal), "%s.%d", ruta, (int)getpid());
+    FILE* archivo = fopen(temporal, "wb");
+    if (!archivo) return 0;
+    int ok = fwrite(imagen, tamano, 1, archivo) == 1;
+    ok = (fclose(archivo) == 0) && ok;
+    if (!ok || rename(temporal, ruta) != 0) {
+        unlink(temporal);
+        return 0;
+    }
+    return 1;
+}
+
+int gxc_compilar(const AST* ast, const char* fuente, GxcPrograma* prog) {
+    memset(prog, 0, sizeof(*prog));
+
+    const ASTNode* raiz = ast_raiz(ast);
+    Compilador c = { NULL, 0, NULL, 0, 0 };
+    c.codigo = malloc((raiz->num_children + 1) * sizeof(GxcInstr));
+    agregar_constante(&c, "");  // El pool nunca queda vacío
+
+    for (int i = 0; i < raiz->num_children; i++) {
+        compilar_sentencia(&c, ast, ast_hijo(ast, raiz, i));
+    }
+
+    // Imagen completa igual a la del archivo: header, código, constantes
+    GxcHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = GXC_MAGIC;
+    h.version = GXC_VERSION;
+    h.tam_instr = sizeof(GxcInstr);
+    h.params_huella = param_tabla_huella();
+    h.num_instr = c.num_instr;
+    h.tam_constantes = c.tam_constantes;
+
+    struct stat st;
+    int firmado = stat(fuente, &st) == 0 && cache_hash_archivo(fuente, &h.fuente_hash) == 0;
+    if (firmado) {
+        h.fuente_mtime_ns = cache_mtime_ns(&st);
+        h.fuente_tamano = st.st_size;
+    }
+
+    size_t tamano = sizeof(h) + (size_t)c.num_instr * sizeof(GxcInstr) + c.tam_constantes;
+    char* imagen = malloc(tamano);
+    memcpy(imagen, &h, sizeof(h));
+    memcpy(imagen + sizeof(h), c.codigo, (size_t)c.num_instr * sizeof(GxcInstr));
+    memcpy(imagen + sizeof(h) + (size_t)c.num_instr * sizeof(GxcInstr), c.constantes, c.tam_constantes);
+    free(c.codigo);
+    free(c.constantes);
+
+    ubicar(imagen, tamano, prog);
+    prog->memoria = imagen;
+    prog->tamano = tamano;
+
+    if (!firmado) return 0;
+    char ruta[1024];
+    gxc_ruta(fuente, ruta, sizeof(ruta));
+    return guardar(ruta, imagen, tamano);
+}
+
+void gxc_ejecutar(const GxcPrograma* prog) {
+    salida_printf("Ejecutando programa...\n");
+
+    const char* k = prog->constantes;
+    for (uint32_t i = 0; i < prog->num_instr; i++) {
+        const GxcInstr* in = &prog->codigo[i];
+        interpret_marcar_sentencia(in->linea, in->columna);
+        switch (in->op) {
+            case GXC_OP_DECLARE:
+                ejecutar_parametro(in->a, k + in->b, in->tipo);
+                break;
+            case GXC_OP_DECLARE_NOMBRE:
+                ejecutar_declaracion(k + in->a, k + in->b, in->tipo);
+                break;
+            case GXC_OP_ASSIGN:
+                ejecutar_asignacion(k + in->a, k + in->b, in->tipo);
+                break;
+            case GXC_OP_RUN_MODE:
+                ejecutar_run(k + in->b, in->tipo);
+                break;
+            case GXC_OP_STATUS:
+                ejecutar_comando("status");
+                break;
+            case GXC_OP_COMMAND:
+                ejecutar_comando(k + in->a);
+                break;
+            case GXC_OP_LITERAL:
+                ejecutar_literal(k + in->b, in->tipo);
+                break;
+        }
+    }
+}
+
+void gxc_cerrar(GxcPrograma* prog) {
+    if (prog->mapa) munmap(prog->mapa, prog->tamano);
+    free(prog->memoria);
+    memset(prog, 0, sizeof(*prog));
+}
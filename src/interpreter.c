@@ -3,54 +3,76 @@
 #include <string.h>
 #include <ctype.h>
 #include <unistd.h>
+#include <setjmp.h>
 #include "../include/interpreter.h"
 #include "utils.h"
+#include "knobs.h"
+#include "status.h"
+#include "mode_cache.h"
+#include "symtab.h"
+#include "salida.h"
+#include "sensores.h"
 
 // Variables globales para simular el estado de la GPU
 static char gpu_mode[50] = "normal";
 
-// Sistema de variables
-#define MAX_VARIABLES 100
-#define MAX_VAR_NAME 50
+// Archivo en ejecución, para anteponer archivo:línea:columna a cada sentencia
+static const char* archivo_fuente = NULL;
 
-typedef struct {
-    char name[MAX_VAR_NAME];
-    char value[100];
-    int is_number;
-} Variable;
+void interpret_set_fuente(const char* archivo) {
+    archivo_fuente = archivo;
+}
 
-static Variable variables[MAX_VARIABLES];
-static int num_variables = 0;
+// Sistema de variables: tabla de símbolos con hash y nombres internados
+static SymTab variables;
 
-// Buscar una variable por nombre
-Variable* find_variable(const char* name) {
-    for (int i = 0; i < num_variables; i++) {
-        if (strcmp(variables[i].name, name) == 0) {
-            return &variables[i];
-        }
+// AST en ejecución: los hijos de un nodo son índices dentro de él
+static const AST* ast_actual = NULL;
+
+// Sesión interactiva (gx shell): punto de recuperación y caché de modos que
+// queda mapeada entre sentencias
+static jmp_buf* sesion = NULL;
+static ModeCache modos_sesion;
+static char modelo_sesion[512];
+
+void interpret_set_sesion(jmp_buf* recuperacion) {
+    sesion = recuperacion;
+    if (!sesion) mode_cache_cerrar(&modos_sesion);
+}
+
+// Error crítico: fuera de una sesión termina el proceso; dentro, corta solo
+// la sentencia en curso y vuelve al prompt
+static void abortar(void) {
+    if (sesion) {
+        ast_actual = NULL;
+        salida_vaciar();
+        longjmp(*sesion, 1);
     }
-    return NULL;
+    exit(1);
 }
 
-// Agregar o actualizar una variable
-void set_variable(const char* name, const char* value, int is_number) {
-    Variable* var = find_variable(name);
+// Buscar una variable por nombre
+Simbolo* find_variable(const char* name) {
+    return symtab_buscar(&variables, name);
+}
+
+// Variable lista para recibir un valor nuevo: valida el tipo y pide
+// confirmación antes de sobrescribir; la crea si no existe
+static Simbolo* preparar_variable(const char* name, int is_number) {
+    Simbolo* var = find_variable(name);
     if (var) {
         // Validación estricta de tipo
-        if (var->is_number != is_number) {
-            printf("\033[31m⛔ Error crítico: Conflicto de tipos al asignar a la variable '%s'. ", name);
-            if (var->is_number) {
-                printf("La variable fue definida como número y se intenta asignar texto.\033[0m\n");
-            } else {
-                printf("La variable fue definida como texto y se intenta asignar un número.\033[0m\n");
-            }
-            exit(1);
+        if ((var->tipo == SYM_NUMERO) != (is_number != 0)) {
+            salida_error("\033[31m⛔ Error crítico: Conflicto de tipos al asignar a la variable '%s'. %s\033[0m\n", name,
+                         var->tipo == SYM_NUMERO ? "La variable fue definida como número y se intenta asignar texto."
+                                                 : "La variable fue definida como texto y se intenta asignar un número.");
+            abortar();
         }
         // Advertencia de sobrescritura
-        printf("\033[33m📝 Advertencia: La variable '%s' ya existía y será sobrescrita.\033[0m\n", name);
+        salida_pregunta("\033[33m📝 Advertencia: La variable '%s' ya existía y será sobrescrita.\033[0m\n", name);
         char respuesta[10];
         while (1) {
-            printf("¿Desea continuar? (y/n): ");
+            salida_pregunta("¿Desea continuar? (y/n): ");
             if (fgets(respuesta, sizeof(respuesta), stdin) != NULL) {
                 // Eliminar salto de línea
                 size_t len = strlen(respuesta);
@@ -58,38 +80,92 @@ void set_variable(const char* name, const char* value, int is_number) {
                 if (strcmp(respuesta, "y") == 0 || strcmp(respuesta, "Y") == 0) {
                     break; // Continuar
                 } else if (strcmp(respuesta, "n") == 0 || strcmp(respuesta, "N") == 0) {
-                    printf("\033[31m⛔ Ejecución abortada por el usuario.\033[0m\n");
-                    exit(1);
+                    salida_error("\033[31m⛔ Ejecución abortada por el usuario.\033[0m\n");
+                    abortar();
                 } else {
-                    printf("Por favor, responda 'y' para continuar o 'n' para abortar.\n");
+                    salida_pregunta("Por favor, responda 'y' para continuar o 'n' para abortar.\n");
                 }
             }
         }
-        // Actualizar variable existente
-        strncpy(var->value, value, sizeof(var->value) - 1);
-        var->value[sizeof(var->value) - 1] = '\0'; // Asegurar null-terminator
-        var->is_number = is_number;
-    } else if (num_variables < MAX_VARIABLES) {
-        // Crear nueva variable
-        strncpy(variables[num_variables].name, name, sizeof(variables[num_variables].name) - 1);
-        variables[num_variables].name[sizeof(variables[num_variables].name) - 1] = '\0';
-        strncpy(variables[num_variables].value, value, sizeof(variables[num_variables].value) - 1);
-        variables[num_variables].value[sizeof(variables[num_variables].value) - 1] = '\0';
-        variables[num_variables].is_number = is_number;
-        num_variables++;
+    } else {
+        // Crear nueva variable (sin límite de cantidad)
+        var = symtab_definir(&variables, name);
     }
+    return var;
+}
+
+// Agregar o actualizar una variable
+void set_variable(const char* name, const char* value, int is_number) {
+    Simbolo* var = preparar_variable(name, is_number);
+    
+    // Los números se convierten una sola vez, al asignarlos
+    if (is_number) {
+        symtab_asignar_numero(var, strtoll(value, NULL, 10), value);
+    } else {
+        symtab_asignar_texto(var, value);
+    }
+}
+
+void interpret_reiniciar(void) {
+    symtab_liberar(&variables);
+    sensores_reiniciar();
+    snprintf(gpu_mode, sizeof(gpu_mode), "%s", "normal");
+}
+
+// Índice de un sensor por nombre; aborta si no existe (como una variable no definida)
+static int buscar_sensor(const char* nombre) {
+    int id = sensor_buscar(nombre);
+    if (id < 0) {
+        const char* sugerido = sugerir_palabra(nombre, sensores_validos, num_sensores, 2);
+        if (sugerido) {
+            salida_error("\033[31m⛔ Error crítico: Sensor desconocido: %s (¿quisiste decir %s?). Ejecución abortada.\033[0m\n", nombre, sugerido);
+        } else {
+            salida_error("\033[31m⛔ Error crítico: Sensor desconocido: %s. Ejecución abortada.\033[0m\n", nombre);
+        }
+        abortar();
+    }
+    return id;
+}
+
+// Valor actual de un sensor (desde la caché mientras no venza el TTL)
+static const char* leer_sensor(int id, long long* numero) {
+    const char* texto = sensor_leer(id, numero);
+    if (!texto) {
+        salida_error("\033[31m⛔ Error crítico: No se pudo leer sensor:%s. Ejecución abortada.\033[0m\n", sensor_nombre(id));
+        abortar();
+    }
+    return texto;
+}
+
+// Reemplazar "sensor:nombre" por su lectura y el tipo que corresponde
+static const char* valor_sensor(const char* nombre, NodeType* tipo) {
+    int id = buscar_sensor(nombre);
+    *tipo = sensor_es_numero(id) ? NODE_NUMBER : NODE_STRING;
+    return leer_sensor(id, NULL);
+}
+
+// Buscar una variable con su valor al día: si está ligada a un sensor, el
+// valor se lee recién acá (la primera vez o cuando vence el TTL)
+static Simbolo* resolver_variable(const char* name) {
+    Simbolo* var = find_variable(name);
+    if (var && var->sensor) {
+        long long numero = 0;
+        const char* texto = leer_sensor(var->sensor - 1, &numero);
+        symtab_refrescar(var, numero, texto);
+    }
+    return var;
 }
 
 // Obtener el valor de una variable
 const char* get_variable_value(const char* name) {
-    Variable* var = find_variable(name);
-    return var ? var->value : NULL;
+    Simbolo* var = resolver_variable(name);
+    return var ? var->texto : NULL;
 }
 
 // Verificar si una variable es número
 int is_variable_number(const char* name) {
-    Variable* var = find_variable(name);
-    return var ? var->is_number : 0;
+    Simbolo* var = find_variable(name);
+    return var ? var->tipo == SYM_NUMERO : 0;
 }
 
 // Verificar si un string es un número
@@ -103,8 +179,50 @@ int is_string_number(const char* str) {
     return 1;
 }
 
+// Mostrar el resultado de aplicar un parámetro
+// Retorna 1 si se aplicó, 0 si falló
+static int reportar_knob(const char* nombre, const char* valor, const KnobWrite* write) {
+    if (salida_json()) {
+        char error[128];
+        salida_json_inicio("knob");
+        salida_json_texto("knob", knob_nombre(write->id));
+        salida_json_texto("valor", write->valor);
+        salida_json_texto("resultado", knob_result_str(write->resultado));
+        if (write->resultado == KNOB_ERROR) {
+            salida_json_texto("error", knob_error_str(write, error, sizeof(error)));
+        }
+        if (write->duracion_us > 0) salida_json_entero("duracion_us", write->duracion_us);
+        salida_json_fin();
+        return write->resultado != KNOB_ERROR;
+    }
+    if (write->resultado == KNOB_ERROR) {
+        char error[128];
+        salida_error("   Advertencia: %s: Error al aplicar (%s)\033[0m\n", nombre, knob_error_str(write, error, sizeof(error)));
+        return 0;
+    }
+    if (write->resultado == KNOB_OK) {
+        salida_printf("   %s: %s\033[0m\n", nombre, valor);
+    } else {
+        salida_printf("   %s: %s (%s)\033[0m\n", nombre, valor, knob_result_str(write->resultado));
+    }
+    return 1;
+}
+
+static ASTNode* hijo(const ASTNode* node, int i) {
+    return ast_hijo(ast_actual, node, i);
+}
+
 // Función principal del interpreter
-void interpret_ast(ASTNode* node) {
+void interpret_ast(const AST* ast) {
+    if (!ast) return;
+    const AST* anterior = ast_actual;
+    ast_actual = ast;
+    interpret_node(ast_raiz(ast));
+    ast_actual = anterior;
+}
+
+// Ejecutar un nodo del AST en ejecución
+void interpret_node(ASTNode* node) {
     if (!node) return;
     
     // Según el tipo de nodo, llamamos a la función específica
@@ -133,387 +251,312 @@ void interpret_ast(ASTNode* node) {
         case NODE_RUN_COMMAND:
             interpret_run_command(node);
             break;
+        case NODE_SENSOR:
+            // El parser solo lo arma como valor de una declaración,
+            // asignación o run; nunca es una sentencia
+            break;
     }
 }
 
 // Interpretar un programa (nodo raíz)
 void interpret_program(ASTNode* node) {
-    printf("Ejecutando programa...\n");
+    if (!sesion) salida_printf("Ejecutando programa...\n");
     
-    // Ejecutar todos los hijos del programa
+    // Ejecutar todos los hijos del programa; cuando vienen de un archivo se
+    // indica la posición de cada sentencia para que los errores queden ubicados
     for (int i = 0; i < node->num_children; i++) {
-        interpret_ast(node->children[i]);
+        ASTNode* sentencia = hijo(node, i);
+        interpret_marcar_sentencia(sentencia->linea, sentencia->columna);
+        interpret_node(sentencia);
+    }
+}
+
+void interpret_marcar_sentencia(int linea, int columna) {
+    salida_ubicacion(archivo_fuente, linea, columna);
+    if (archivo_fuente && linea > 0) {
+        salida_printf("\n\033[90m%s:%d:%d\033[0m\n", archivo_fuente, linea, columna);
     }
 }
 
 // Interpretar una declaración (ej: "modo: quiet" o "power_limit: mi_potencia")
 void interpret_declaration(ASTNode* node) {
-    if (node->num_children > 0 && node->children[0]) {
-        char* value = node->children[0]->value;
-        NodeType value_type = node->children[0]->type;
-        
-        // Primero validar si el valor es válido para el tipo de declaración
-        if (strcmp(node->value, "mode") == 0 || strcmp(node->value, "modo") == 0) {
-            // Para modos, validar directamente si es un modo válido
-            int es_valido = 0;
-            for (int i = 0; i < num_modos; i++) {
-                if (strcmp(value, modos_validos[i]) == 0) {
-                    es_valido = 1;
-                    break;
-                }
-            }
-            if (!es_valido) {
-                const char* sugerido = sugerir_palabra(value, modos_validos, num_modos, 2);
-                if (sugerido) {
-                    printf("\033[33mSugerencia: ¿Quisiste decir: %s?\033[0m\n", sugerido);
-                } else {
-                    printf("Modo desconocido: %s\n", value);
-                }
-                return; // No continuar si el modo no es válido
-            }
-            strncpy(gpu_mode, value, sizeof(gpu_mode) - 1);
-            gpu_mode[sizeof(gpu_mode) - 1] = '\0'; // Asegurar null-terminator
-            printf("\033[36mModo GPU cambiado a: %s\033[0m\n", gpu_mode);
-        }
-        else if (strcmp(node->value, "dynamic_boost") == 0) {
-            // Para dynamic_boost, verificar si es número o variable numérica
-            if (value_type == NODE_IDENTIFIER) {
-                const char* var_value = get_variable_value(value);
-                if (var_value) {
-                    value = (char*)var_value;
-                    if (is_variable_number(node->children[0]->value)) {
-                        value_type = NODE_NUMBER;
-                    } else {
-                        printf("\033[33mError: 'dynamic_boost' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-                        return;
-                    }
-                } else {
-                    printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                    exit(1);
-                }
-            }
-            
-            if (value_type == NODE_NUMBER) {
-                int val = atoi(value);
-                if (val < 0 || val > 1) {
-                    printf("\033[31m⛔ Error crítico: 'dynamic_boost' fuera de rango (0-1). Valor recibido: %d. Ejecución abortada.\033[0m\n", val);
-                    exit(1);
-                }
-                printf("\033[36mDynamic Boost establecido a: %d\033[0m\n", val);
-            } else {
-                printf("\033[33mError: 'dynamic_boost' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-            }
+    if (node->num_children > 0) {
+        ASTNode* valor = hijo(node, 0);
+        ejecutar_declaracion(node->value, valor->value, valor->type);
+    }
+}
+
+// Registro JSON de una declaración aplicada
+static void registrar_declaracion(const ParamInfo* param, const char* texto, int es_numero, long long numero) {
+    salida_json_inicio("declaracion");
+    salida_json_texto("parametro", param->nombre);
+    if (es_numero) salida_json_entero("valor", numero);
+    else salida_json_texto("valor", texto);
+    salida_json_fin();
+}
+
+// Ejecutar "parametro: valor" (lo usan el intérprete y la VM de bytecode)
+void ejecutar_declaracion(const char* parametro, const char* valor_fuente, NodeType tipo_fuente) {
+    int id = param_buscar(parametro);
+    if (id < 0) {
+        // Parámetro desconocido, usar fuzzy match
+        const char* sugerido = sugerir_palabra(parametro, parametros_validos, num_parametros, 2);
+        if (sugerido) {
+            salida_printf("\033[33m💡 ¿Quisiste decir: %s?\033[0m\n", sugerido);
+        } else {
+            salida_error("\033[31m⛔ Error crítico: Parámetro desconocido: %s. Ejecución abortada.\033[0m\n", parametro);
+            abortar();
         }
-        else if (strcmp(node->value, "cpu_max_perf") == 0) {
-            // Para cpu_max_perf, verificar si es número o variable numérica
-            if (value_type == NODE_IDENTIFIER) {
-                const char* var_value = get_variable_value(value);
-                if (var_value) {
-                    value = (char*)var_value;
-                    if (is_variable_number(node->children[0]->value)) {
-                        value_type = NODE_NUMBER;
-                    } else {
-                        printf("\033[33mError: 'cpu_max_perf' debe ser un número (0-100), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-                        return;
-                    }
-                } else {
-                    printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                    exit(1);
-                }
-            }
-            
-            if (value_type == NODE_NUMBER) {
-                int val = atoi(value);
-                if (val < 0 || val > 100) {
-                    printf("\033[31m⛔ Error crítico: 'cpu_max_perf' fuera de rango (0-100). Valor recibido: %d. Ejecución abortada.\033[0m\n", val);
-                    exit(1);
-                }
-                printf("\033[36mCPU Max Performance establecido a: %d%%\033[0m\n", val);
+        return;
+    }
+    ejecutar_parametro(id, valor_fuente, tipo_fuente);
+}
+
+// Ejecutar una declaración con el parámetro ya resuelto
+void ejecutar_parametro(int id, const char* valor_fuente, NodeType tipo_fuente) {
+    const ParamInfo* param = &param_tabla[id];
+    const char* value = valor_fuente;
+    NodeType value_type = tipo_fuente;
+    if (value_type == NODE_SENSOR) {
+        value = valor_sensor(valor_fuente, &value_type);
+    }
+    
+    if (param->tipo == PARAM_TIPO_MODO) {
+        // Para modos, validar directamente si es un modo válido
+        if (!modo_disponible(value)) {
+            const char* sugerido = sugerir_modo(value);
+            if (sugerido) {
+                salida_printf("\033[33mSugerencia: ¿Quisiste decir: %s?\033[0m\n", sugerido);
             } else {
-                printf("\033[33mError: 'cpu_max_perf' debe ser un número (0-100), no '%s'. Revisa el valor asignado.\033[0m\n", value);
+                salida_printf("Modo desconocido: %s\n", value);
             }
+            return; // No continuar si el modo no es válido
         }
-        else if (strcmp(node->value, "cpu_min_perf") == 0) {
-            // Para cpu_min_perf, verificar si es número o variable numérica
-            if (value_type == NODE_IDENTIFIER) {
-                const char* var_value = get_variable_value(value);
-                if (var_value) {
-                    value = (char*)var_value;
-                    if (is_variable_number(node->children[0]->value)) {
-                        value_type = NODE_NUMBER;
-                    } else {
-                        printf("\033[33mError: 'cpu_min_perf' debe ser un número (0-100), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-                        return;
-                    }
-                } else {
-                    printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                    exit(1);
-                }
-            }
-            
-            if (value_type == NODE_NUMBER) {
-                int val = atoi(value);
-                if (val < 0 || val > 100) {
-                    printf("\033[31m⛔ Error crítico: 'cpu_min_perf' fuera de rango (0-100). Valor recibido: %d. Ejecución abortada.\033[0m\n", val);
-                    exit(1);
-                }
-                printf("\033[36mCPU Min Performance establecido a: %d%%\033[0m\n", val);
-            } else {
-                printf("\033[33mError: 'cpu_min_perf' debe ser un número (0-100), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-            }
+        strncpy(gpu_mode, value, sizeof(gpu_mode) - 1);
+        gpu_mode[sizeof(gpu_mode) - 1] = '\0'; // Asegurar null-terminator
+        salida_printf("\033[36mModo GPU cambiado a: %s\033[0m\n", gpu_mode);
+        registrar_declaracion(param, gpu_mode, 0, 0);
+        return;
+    }
+    
+    if (param->tipo == PARAM_TIPO_COLOR) {
+        // El color puede venir de una variable o escribirse directo (rgb_color: red)
+        if (value_type == NODE_IDENTIFIER) {
+            const char* var_value = get_variable_value(value);
+            if (var_value) value = var_value;
         }
-        else if (strcmp(node->value, "turbo_boost") == 0) {
-            // Para turbo_boost, verificar si es número o variable numérica
-            if (value_type == NODE_IDENTIFIER) {
-                const char* var_value = get_variable_value(value);
-                if (var_value) {
-                    value = (char*)var_value;
-                    if (is_variable_number(node->children[0]->value)) {
-                        value_type = NODE_NUMBER;
-                    } else {
-                        printf("\033[33mError: 'turbo_boost' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-                        return;
-                    }
-                } else {
-                    printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                    exit(1);
-                }
-            }
-            
-            if (value_type == NODE_NUMBER) {
-                int val = atoi(value);
-                if (val < 0 || val > 1) {
-                    printf("\033[31m⛔ Error crítico: 'turbo_boost' fuera de rango (0-1). Valor recibido: %d. Ejecución abortada.\033[0m\n", val);
-                    exit(1);
-                }
-                printf("\033[36mTurbo Boost establecido a: %d\033[0m\n", val);
-            } else {
-                printf("\033[33mError: 'turbo_boost' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-            }
+        if (!rgb_color_to_profile(value)) {
+            salida_printf("\033[33mError: '%s' debe ser un color (blue, white o red), no '%s'. Revisa el valor asignado.\033[0m\n", param->nombre, value);
+            return;
         }
-        else if (strcmp(node->value, "persist_mode") == 0) {
-            // Para persist_mode, verificar si es número o variable numérica
-            if (value_type == NODE_IDENTIFIER) {
-                const char* var_value = get_variable_value(value);
-                if (var_value) {
-                    value = (char*)var_value;
-                    if (is_variable_number(node->children[0]->value)) {
-                        value_type = NODE_NUMBER;
-                    } else {
-                        printf("\033[33mError: 'persist_mode' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-                    return;
-                    }
-                } else {
-                    printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                    exit(1);
-                }
-            }
-            
-            if (value_type == NODE_NUMBER) {
-                int val = atoi(value);
-                if (val < 0 || val > 1) {
-                    printf("\033[31m⛔ Error crítico: 'persist_mode' fuera de rango (0-1). Valor recibido: %d. Ejecución abortada.\033[0m\n", val);
-                    exit(1);
-                }
-                printf("\033[36mPersistence Mode establecido a: %d\033[0m\n", val);
-            } else {
-                printf("\033[33mError: 'persist_mode' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-            }
+        salida_printf("\033[36m%s establecido a: %s\033[0m\n", param->etiqueta, value);
+        registrar_declaracion(param, value, 0, 0);
+        return;
+    }
+    
+    if (param->tipo == PARAM_TIPO_OPCION) {
+        // EPP y governor: una palabra de la lista, directa o desde una variable
+        if (value_type == NODE_IDENTIFIER) {
+            const char* var_value = get_variable_value(value);
+            if (var_value) value = var_value;
         }
-        else if (strcmp(node->value, "battery_conservation") == 0) {
-            // Para battery_conservation, verificar si es número o variable numérica
-            if (value_type == NODE_IDENTIFIER) {
-                const char* var_value = get_variable_value(value);
-                if (var_value) {
-                    value = (char*)var_value;
-                    if (is_variable_number(node->children[0]->value)) {
-                        value_type = NODE_NUMBER;
-                    } else {
-                        printf("\033[33mError: 'battery_conservation' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-                    return;
-                }
-                } else {
-                    printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                    exit(1);
-                }
-            }
-            
-            if (value_type == NODE_NUMBER) {
-                int val = atoi(value);
-                if (val < 0 || val > 1) {
-                    printf("\033[31m⛔ Error crítico: 'battery_conservation' fuera de rango (0-1). Valor recibido: %d. Ejecución abortada.\033[0m\n", val);
-                    exit(1);
-                }
-                printf("\033[36mBattery Conservation establecido a: %d\033[0m\n", val);
+        if (param_opcion_buscar(param, value) < 0) {
+            int cantidad;
+            const char** opciones = param_opciones(param, &cantidad);
+            const char* sugerido = sugerir_palabra(value, opciones, cantidad, 2);
+            if (sugerido) {
+                salida_printf("\033[33m💡 ¿Quisiste decir: %s?\033[0m\n", sugerido);
             } else {
-                printf("\033[33mError: 'battery_conservation' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-            }
-        }
-        else if (strcmp(node->value, "fnlock") == 0) {
-            // Para fnlock, verificar si es número o variable numérica
-            if (value_type == NODE_IDENTIFIER) {
-                const char* var_value = get_variable_value(value);
-                if (var_value) {
-                    value = (char*)var_value;
-                    if (is_variable_number(node->children[0]->value)) {
-                        value_type = NODE_NUMBER;
-                    } else {
-                        printf("\033[33mError: 'fnlock' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-                        return;
-                    }
-                } else {
-                    printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                    exit(1);
+                char lista[128] = "";
+                for (int i = 0; i < cantidad; i++) {
+                    size_t n = strlen(lista);
+                    snprintf(lista + n, sizeof(lista) - n, "%s%s", i ? ", " : "", opciones[i]);
                 }
+                salida_printf("\033[33mError: '%s' debe ser uno de (%s), no '%s'. Revisa el valor asignado.\033[0m\n", param->nombre, lista, value);
             }
-            
-            if (value_type == NODE_NUMBER) {
-                int val = atoi(value);
-                if (val < 0 || val > 1) {
-                    printf("\033[31m⛔ Error crítico: 'fnlock' fuera de rango (0-1). Valor recibido: %d. Ejecución abortada.\033[0m\n", val);
-                    exit(1);
-                }
-                printf("\033[36mFnLock establecido a: %d\033[0m\n", val);
-            } else {
-                printf("\033[33mError: 'fnlock' debe ser un número (0 o 1), no '%s'. Revisa el valor asignado.\033[0m\n", value);
-            }
+            return;
         }
-        else {
-            // Parámetro desconocido, usar fuzzy match
-            const char* sugerido = sugerir_palabra(node->value, parametros_validos, num_parametros, 2);
-            if (sugerido) {
-                printf("\033[33m💡 ¿Quisiste decir: %s?\033[0m\n", sugerido);
-            } else {
-                printf("\033[31m⛔ Error crítico: Parámetro desconocido: %s. Ejecución abortada.\033[0m\n", node->value);
-                exit(1);
-            }
+        salida_printf("\033[36m%s establecido a: %s\033[0m\n", param->etiqueta, value);
+        registrar_declaracion(param, value, 0, 0);
+        return;
+    }
+    
+    // Parámetros enteros: verificar si es número o variable numérica
+    char rango[32];
+    if (param->min == 0 && param->max == 1) {
+        snprintf(rango, sizeof(rango), "0 o 1");
+    } else {
+        snprintf(rango, sizeof(rango), "%d-%d", param->min, param->max);
+    }
+    
+    long long val;
+    if (value_type == NODE_IDENTIFIER) {
+        Simbolo* var = resolver_variable(value);
+        if (!var) {
+            salida_error("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
+            abortar();
+        }
+        if (var->tipo != SYM_NUMERO) {
+            salida_printf("\033[33mError: '%s' debe ser un número (%s), no '%s'. Revisa el valor asignado.\033[0m\n", param->nombre, rango, var->texto);
+            return;
         }
+        val = var->numero;
+    } else if (value_type == NODE_NUMBER) {
+        val = atoi(value);
+    } else {
+        salida_printf("\033[33mError: '%s' debe ser un número (%s), no '%s'. Revisa el valor asignado.\033[0m\n", param->nombre, rango, value);
+        return;
+    }
+    
+    if (val < param->min || val > param->max) {
+        salida_error("\033[31m⛔ Error crítico: '%s' fuera de rango (%d-%d). Valor recibido: %lld. Ejecución abortada.\033[0m\n", param->nombre, param->min, param->max, val);
+        abortar();
+    }
+    if (id == PARAM_sensor_ttl_ms) {
+        sensores_set_ttl((int)val);
     }
+    salida_printf("\033[36m%s establecido a: %lld%s\033[0m\n", param->etiqueta, val,
+                  param->formato == PARAM_FMT_PORCENTAJE ? "%" : param->formato == PARAM_FMT_MHZ ? " MHz" : "");
+    registrar_declaracion(param, NULL, 1, val);
 }
 
 // Interpretar una asignación (ej: "mi_potencia = 80")
 void interpret_assignment(ASTNode* node) {
-    if (node->num_children > 0 && node->children[0]) {
-        char* value = node->children[0]->value;
-        NodeType value_type = node->children[0]->type;
-        
-        // Si el valor es un identificador, buscar la variable
-        if (value_type == NODE_IDENTIFIER) {
-            const char* var_value = get_variable_value(value);
-            if (var_value) {
-                value = (char*)var_value;
-                if (is_variable_number(node->children[0]->value)) {
-                    value_type = NODE_NUMBER;
-                } else {
-                    value_type = NODE_STRING;
-                }
+    if (node->num_children > 0) {
+        ASTNode* valor = hijo(node, 0);
+        ejecutar_asignacion(node->value, valor->value, valor->type);
+    }
+}
+
+// Registro JSON con el valor de una variable
+static void registrar_variable(const Simbolo* var) {
+    salida_json_inicio("variable");
+    salida_json_texto("nombre", var->nombre);
+    if (var->sensor) {
+        salida_json_texto("sensor", sensor_nombre(var->sensor - 1));
+        const char* leido = sensor_cacheado(var->sensor - 1);
+        if (leido) salida_json_texto("valor", leido);
+    } else if (var->tipo == SYM_NUMERO) salida_json_entero("valor", var->numero);
+    else salida_json_texto("valor", var->texto);
+    salida_json_fin();
+}
+
+// Ligar una variable a un sensor sin leerlo todavía
+static void ligar_variable(const char* nombre, int sensor) {
+    int es_numero = sensor_es_numero(sensor);
+    Simbolo* var = preparar_variable(nombre, es_numero);
+    symtab_ligar_sensor(var, sensor, es_numero ? SYM_NUMERO : SYM_TEXTO, sensor_nombre(sensor));
+    salida_printf("📝 Variable '%s' ligada a: sensor:%s\n", nombre, sensor_nombre(sensor));
+    registrar_variable(var);
+}
+
+// Ejecutar "nombre = valor" (lo usan el intérprete y la VM de bytecode)
+void ejecutar_asignacion(const char* nombre, const char* valor_fuente, NodeType tipo_fuente) {
+    const char* value = valor_fuente;
+    NodeType value_type = tipo_fuente;
+    
+    if (value_type == NODE_SENSOR) {
+        ligar_variable(nombre, buscar_sensor(valor_fuente));
+        return;
+    }
+    
+    // Copiar una variable ligada a un sensor la liga al mismo sensor
+    if (value_type == NODE_IDENTIFIER) {
+        Simbolo* origen = find_variable(value);
+        if (origen && origen->sensor) {
+            ligar_variable(nombre, origen->sensor - 1);
+            return;
+        }
+    }
+    
+    // Si el valor es un identificador, buscar la variable
+    if (value_type == NODE_IDENTIFIER) {
+        const char* var_value = get_variable_value(value);
+        if (var_value) {
+            value = (char*)var_value;
+            if (is_variable_number(valor_fuente)) {
+                value_type = NODE_NUMBER;
             } else {
-                printf("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
-                exit(1);
+                value_type = NODE_STRING;
             }
+        } else {
+            salida_error("\033[31m⛔ Error crítico: La variable '%s' no está definida. Ejecución abortada.\033[0m\n", value);
+            abortar();
         }
-        // Guardar la variable
-        set_variable(node->value, value, (value_type == NODE_NUMBER));
-        printf("📝 Variable '%s' asignada a: %s\n", node->value, value);
     }
+    // Guardar la variable
+    set_variable(nombre, value, (value_type == NODE_NUMBER));
+    salida_printf("📝 Variable '%s' asignada a: %s\n", nombre, value);
+    registrar_variable(find_variable(nombre));
 }
 
 // Interpretar un identificador
 void interpret_identifier(ASTNode* node) {
-    printf("Identificador: %s\n", node->value);
+    ejecutar_literal(node->value, NODE_IDENTIFIER);
 }
 
 // Interpretar un número
 void interpret_number(ASTNode* node) {
-    printf("🔢 Número: %s\n", node->value);
+    ejecutar_literal(node->value, NODE_NUMBER);
 }
 
 // Interpretar un string
 void interpret_string(ASTNode* node) {
-    printf("📄 String: %s\n", node->value);
+    ejecutar_literal(node->value, NODE_STRING);
+}
+
+// Mostrar un literal suelto (sentencia que es solo un valor)
+void ejecutar_literal(const char* valor, NodeType tipo) {
+    if (tipo == NODE_NUMBER) {
+        salida_printf("🔢 Número: %s\n", valor);
+    } else if (tipo == NODE_STRING) {
+        salida_printf("📄 String: %s\n", valor);
+    } else {
+        salida_printf("Identificador: %s\n", valor);
+    }
+    salida_json_inicio("literal");
+    salida_json_texto("valor", valor);
+    salida_json_fin();
 }
 
 // Interpretar un comando del sistema
 void interpret_gpu_command(ASTNode* node) {
+    ejecutar_comando(node->value);
+}
+
+// Ejecutar un comando del sistema (lo usan el intérprete y la VM de bytecode)
+void ejecutar_comando(const char* comando) {
 // Fuzzy match para comandos del sistema
     int es_valido = 0;
-    const char* comando_a_ejecutar = node->value;
+    const char* comando_a_ejecutar = comando;
     
     for (int i = 0; i < num_comandos_gpu; i++) {
-        if (strcmp(node->value, comandos_gpu_validos[i]) == 0) {
+        if (strcmp(comando, comandos_gpu_validos[i]) == 0) {
             es_valido = 1;
             break;
         }
     }
     
     if (!es_valido) {
-        const char* sugerido = sugerir_palabra(node->value, comandos_gpu_validos, num_comandos_gpu, 2);
+        const char* sugerido = sugerir_palabra(comando, comandos_gpu_validos, num_comandos_gpu, 2);
         if (sugerido) {
-            printf("\033[33mSugerencia: ¿Quisiste decir: %s?\033[0m\n", sugerido);
+            salida_printf("\033[33mSugerencia: ¿Quisiste decir: %s?\033[0m\n", sugerido);
             comando_a_ejecutar = sugerido; // Usar el comando sugerido
         } else {
-            printf("Comando del sistema desconocido: %s\n", node->value);
+            salida_printf("Comando del sistema desconocido: %s\n", comando);
             return;
         }
     }
     
     // Ejecutar el comando (original o sugerido)
+    salida_json_inicio("comando");
+    salida_json_texto("comando", comando_a_ejecutar);
+    salida_json_fin();
     if (strcmp(comando_a_ejecutar, "status") == 0) {
-        printf("\033[36mEstado actual del sistema:\033[0m\n");
-        
-        // Obtener información de GPU
-        char* gpu_info = execute_system_command("nvidia-smi --query-gpu=name,power.draw,temperature.gpu,clocks.current.graphics --format=csv,noheader,nounits 2>/dev/null");
-        if (gpu_info) {
-            printf("   GPU: %s", gpu_info);
-            free(gpu_info);
-        } else {
-            printf("   Advertencia: GPU: No se pudo obtener información\033[0m\n");
-        }
-        
-        // Obtener información de CPU
-        char* cpu_info = execute_system_command("cat /proc/cpuinfo | grep 'model name' | head -1 | cut -d':' -f2 | sed 's/^[ \t]*//'");
-        if (cpu_info) {
-            printf("   CPU: %s", cpu_info);
-            free(cpu_info);
-        }
-        
-        // Obtener información de memoria
-        char* mem_info = execute_system_command("free -h | grep '^Mem:' | awk '{print \"Memoria: \" $2 \" total, \" $3 \" usado, \" $4 \" libre\"}'");
-        if (mem_info) {
-            printf("   %s", mem_info);
-            free(mem_info);
-        }
-        
-        // Obtener información de parámetros del sistema
-        char* cpu_max = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/max_perf_pct 2>/dev/null");
-        char* cpu_min = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/min_perf_pct 2>/dev/null");
-        char* dynamic_boost = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/hwp_dynamic_boost 2>/dev/null");
-        char* turbo_boost = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/no_turbo 2>/dev/null");
-        char* battery_status = execute_system_command("cat /sys/class/power_supply/AC/online 2>/dev/null");
-        
-        if (cpu_max && cpu_min && dynamic_boost && turbo_boost && battery_status) {
-            printf("   CPU Max Performance: %s%%\n", cpu_max);
-            printf("   CPU Min Performance: %s%%\n", cpu_min);
-            printf("   Dynamic Boost: %s\n", strcmp(dynamic_boost, "1") == 0 ? "ON" : "OFF");
-            printf("   Turbo Boost: %s\n", strcmp(turbo_boost, "1") == 0 ? "OFF" : "ON");
-            printf("   Estado de batería: %s\n", strcmp(battery_status, "1") == 0 ? "Enchufada" : "Con batería");
-            
-            free(cpu_max);
-            free(cpu_min);
-            free(dynamic_boost);
-            free(turbo_boost);
-            free(battery_status);
-        } else {
-            printf("   Advertencia: CPU/Sistema: No se pudo obtener información completa\033[0m\n");
-            if (cpu_max) free(cpu_max);
-            if (cpu_min) free(cpu_min);
-            if (dynamic_boost) free(dynamic_boost);
-            if (turbo_boost) free(turbo_boost);
-            if (battery_status) free(battery_status);
-        }
+        status_mostrar();
     }
     else if (strcmp(comando_a_ejecutar, "reset") == 0) {
-        printf("\033[36m🔄 GPU reseteada a configuración por defecto\033[0m\n");
+        salida_printf("\033[36m🔄 GPU reseteada a configuración por defecto\033[0m\n");
     }
     else if (strcmp(comando_a_ejecutar, "-") == 0) {
         // El guión "-" indica configuración, no hace nada por sí solo
@@ -522,264 +565,350 @@ void interpret_gpu_command(ASTNode* node) {
         // Los comentarios no hacen nada
     }
     else if (strcmp(comando_a_ejecutar, "hola") == 0) {
-        printf("\033[36m👋 ¡Hola! Bienvenido al controlador de GPU\033[0m\n");
+        salida_printf("\033[36m👋 ¡Hola! Bienvenido al controlador de GPU\033[0m\n");
     }
     else if (strcmp(comando_a_ejecutar, "mundo") == 0) {
-        printf("\033[36m🌍 ¡Hola mundo desde GLX!\033[0m\n");
+        salida_printf("\033[36m🌍 ¡Hola mundo desde GLX!\033[0m\n");
     }
     else if (strcmp(comando_a_ejecutar, "vars") == 0) {
-        printf("\033[36m📋 Variables definidas:\n");
-        if (num_variables == 0) {
-            printf("   (ninguna variable definida)\033[0m\n");
+        salida_printf("\033[36m📋 Variables definidas:\n");
+        if (variables.cantidad == 0) {
+            salida_printf("   (ninguna variable definida)\033[0m\n");
         } else {
-            for (int i = 0; i < num_variables; i++) {
-                printf("   %s = %s (%s)\n", 
-                       variables[i].name, 
-                       variables[i].value,
-                       variables[i].is_number ? "número" : "texto");
+            for (uint32_t i = 0; i < variables.cantidad; i++) {
+                const Simbolo* var = &variables.simbolos[i];
+                // Ligada a un sensor: la última lectura (la haya hecho esta
+                // variable u otra) sin volver a leer la fuente
+                const char* leido = NULL;
+                if (var->sensor) {
+                    leido = sensor_cacheado(var->sensor - 1);
+                    if (!leido && strncmp(var->texto, "sensor:", 7) != 0) leido = var->texto;
+                }
+                if (leido) {
+                    salida_printf("   %s = %s (%s, sensor:%s)\n", var->nombre, leido, var->tipo == SYM_NUMERO ? "número" : "texto",
+                                  sensor_nombre(var->sensor - 1));
+                } else {
+                    salida_printf("   %s = %s (%s)\n", var->nombre, var->texto, var->tipo == SYM_NUMERO ? "número" : "texto");
+                }
+                registrar_variable(var);
             }
-            printf("\033[0m");
+            salida_printf("\033[0m");
         }
     }
     else if (strcmp(comando_a_ejecutar, "help") == 0) {
-        printf("\033[36m📚 Comandos disponibles:\n");
-        printf("   status - Mostrar estado del sistema\n");
-        printf("   reset - Resetear a valores por defecto\n");
-        printf("   vars - Mostrar variables definidas\n");
-        printf("   run mode: [quiet/balanced/performance] - Aplicar modo\n");
-        printf("   dynamic_boost: [0/1] - Activar/desactivar Dynamic Boost\n");
-        printf("   cpu_max_perf: [0-100] - Rendimiento máximo de CPU\n");
-        printf("   cpu_min_perf: [0-100] - Rendimiento mínimo de CPU\n");
-        printf("   turbo_boost: [0/1] - Activar/desactivar Turbo Boost\n");
-        printf("   persist_mode: [0/1] - Activar/desactivar Persistence Mode\n");
-        printf("   battery_conservation: [0/1] - Activar/desactivar conservación de batería\n");
-        printf("   fnlock: [0/1] - Activar/desactivar FnLock\n");
-        printf("   variable = valor - Definir una variable\033[0m\n");
+        salida_printf("\033[36m📚 Comandos disponibles:\n");
+        salida_printf("   status - Mostrar estado del sistema\n");
+        salida_printf("   reset - Resetear a valores por defecto\n");
+        salida_printf("   vars - Mostrar variables definidas\n");
+        salida_printf("   run mode: [quiet/balanced/performance] - Aplicar modo\n");
+        salida_printf("   dynamic_boost: [0/1] - Activar/desactivar Dynamic Boost\n");
+        salida_printf("   cpu_max_perf: [0-100] - Rendimiento máximo de CPU\n");
+        salida_printf("   cpu_min_perf: [0-100] - Rendimiento mínimo de CPU\n");
+        salida_printf("   turbo_boost: [0/1] - Activar/desactivar Turbo Boost\n");
+        salida_printf("   persist_mode: [0/1] - Activar/desactivar Persistence Mode\n");
+        salida_printf("   battery_conservation: [0/1] - Activar/desactivar conservación de batería\n");
+        salida_printf("   fnlock: [0/1] - Activar/desactivar FnLock\n");
+        salida_printf("   variable = valor - Definir una variable\033[0m\n");
     }
 }
 
 // Interpretar un comando de ejecución (ej: "run mode: quiet")
 void interpret_run_command(ASTNode* node) {
-    if (node->num_children > 0 && node->children[0]) {
-        char* value = node->children[0]->value;
-        NodeType value_type = node->children[0]->type;
-        
-        // Si el valor es un identificador, verificar si es una variable o un modo literal
-        if (value_type == NODE_IDENTIFIER) {
-            const char* var_value = get_variable_value(value);
-            if (var_value) {
-                // Es una variable definida
-                value = (char*)var_value;
-                if (is_variable_number(node->children[0]->value)) {
-                    value_type = NODE_NUMBER;
-                } else {
-                    value_type = NODE_STRING;
-                }
-            }
-            // Si no es una variable definida, tratar como valor literal del modo
-        }
+    if (node->num_children > 0) {
+        ASTNode* valor = hijo(node, 0);
+        ejecutar_run(valor->value, valor->type);
+    }
+}
 
-        // Validar si el valor es un modo válido
-        int es_valido = 0;
-        for (int i = 0; i < num_modos; i++) {
-            if (strcmp(value, modos_validos[i]) == 0) {
-                es_valido = 1;
-                break;
-            }
-        }
+// Caché de modos para ejecutar_modo; en una sesión queda mapeada y solo se
+// reabre si cambió modelo.txt. NULL si hay que parsear el texto
+static ModeCache* abrir_modos(const char* modelo_path, ModeCache* local) {
+    if (!sesion) return mode_cache_abrir(modelo_path, local) == 0 ? local : NULL;
+    if (strcmp(modelo_sesion, modelo_path) != 0 || !mode_cache_vigente(&modos_sesion, modelo_path)) {
+        mode_cache_cerrar(&modos_sesion);
+        if (mode_cache_abrir(modelo_path, &modos_sesion) != 0) return NULL;
+        snprintf(modelo_sesion, sizeof(modelo_sesion), "%s", modelo_path);
+    }
+    return &modos_sesion;
+}
 
-        if (!es_valido) {
-            const char* sugerido = sugerir_palabra(value, modos_validos, num_modos, 2);
-            if (sugerido) {
-                printf("\033[33m💡 ¿Quisiste decir: %s?\033[0m\n", sugerido);
-                // Usar el modo sugerido para la validación
-                // Validar el modo sugerido
-                int sugerido_valido = 0;
-                for (int i = 0; i < num_modos; i++) {
-                    if (strcmp(sugerido, modos_validos[i]) == 0) {
-                        sugerido_valido = 1;
-                        break;
-                    }
-                }
-                if (sugerido_valido) {
-                    printf("\033[36mAplicando modo sugerido: %s\033[0m\n", sugerido);
-                    value = (char*)sugerido;
-                } else {
-                    printf("Modo de ejecución desconocido: %s\n", value);
-                    return;
-                }
-            } else {
-                printf("Modo de ejecución desconocido: %s\n", value);
-                return;
-            }
-        }
+static void cerrar_modos(ModeCache* cache) {
+    if (cache && cache != &modos_sesion) mode_cache_cerrar(cache);
+}
 
-        // Cargar configuraciones desde modelo.txt
-        printf("\033[36mCargando configuración para modo: %s\033[0m\n", value);
-        
-        int num_modes;
-        // Buscar modelo.txt en ubicaciones del sistema
-        char modelo_path[512];
-        
-        // Primero intentar en la ubicación del sistema
-        strcpy(modelo_path, "/usr/local/share/glx/modelo.txt");
-        
-        // Verificar si existe
-        FILE* test_file = fopen(modelo_path, "r");
-        if (!test_file) {
-            // Si no existe en /usr/local/share/glx/, intentar en la ubicación del ejecutable
-            char exec_path[512];
-            ssize_t len = readlink("/proc/self/exe", exec_path, sizeof(exec_path) - 1);
-            if (len != -1) {
-                exec_path[len] = '\0';
-                char* last_slash = strrchr(exec_path, '/');
-                if (last_slash) {
-                    *last_slash = '\0';
-                    snprintf(modelo_path, sizeof(modelo_path), "%s/../../modelo.txt", exec_path);
-                } else {
-                    strcpy(modelo_path, "modelo.txt");
-                }
-            } else {
-                strcpy(modelo_path, "modelo.txt");
-            }
+// Nombres de los modos que se pueden ejecutar: los integrados en gx y los que
+// agrega un modelo.txt en disco. Se copian porque la caché puede cerrarse;
+// valen hasta la próxima llamada
+#define MODOS_DISPONIBLES_MAX 32
+static char nombres_modos[MODOS_DISPONIBLES_MAX][50];
+static const char* lista_modos[MODOS_DISPONIBLES_MAX];
+
+static void agregar_nombre_modo(const char* nombre, int* cantidad) {
+    if (*cantidad >= MODOS_DISPONIBLES_MAX || !nombre[0]) return;
+    for (int i = 0; i < *cantidad; i++) {
+        if (strcmp(lista_modos[i], nombre) == 0) return;
+    }
+    snprintf(nombres_modos[*cantidad], sizeof(nombres_modos[0]), "%s", nombre);
+    lista_modos[*cantidad] = nombres_modos[*cantidad];
+    (*cantidad)++;
+}
+
+static int listar_modos(void) {
+    int cantidad = 0;
+    for (int i = 0; i < num_modos_integrados(); i++) {
+        agregar_nombre_modo(modo_integrado(i)->name, &cantidad);
+    }
+
+    char modelo_path[512];
+    if (!find_modelo_path(modelo_path, sizeof(modelo_path))) return cantidad;
+    ModeCache local;
+    ModeCache* cache = abrir_modos(modelo_path, &local);
+    if (cache) {
+        for (int i = 0; i < cache->num_modos; i++) agregar_nombre_modo(cache->modos[i].name, &cantidad);
+        cerrar_modos(cache);
+    } else {
+        int num_modes = 0;
+        GPU_Mode* modes = load_gpu_modes_ex(modelo_path, &num_modes, 0);
+        for (int i = 0; i < num_modes; i++) agregar_nombre_modo(modes[i].name, &cantidad);
+        free(modes);
+    }
+    return cantidad;
+}
+
+// Un modo buscado por nombre junto con lo que hubo que abrir para
+// encontrarlo (la caché o el texto parseado de modelo.txt)
+typedef struct {
+    char modelo_path[512];
+    ModeCache local;
+    ModeCache* cache;
+    GPU_Mode* modes;
+    int sin_modelo;             // Había modelo.txt pero no se pudo cargar
+    const GPU_Mode* modo;       // NULL si no existe
+} ModoBuscado;
+
+// Un modelo.txt en disco reemplaza a los modos integrados; si no hay, no
+// se puede leer o no define este modo, sale de la tabla compilada en gx
+// sin abrir ni parsear nada. Si la caché no se puede usar (sin $HOME,
+// disco de solo lectura) se parsea el texto como antes. No arma la lista
+// de nombres: esa solo hace falta para sugerir
+static const GPU_Mode* buscar_modo(const char* nombre, ModoBuscado* b) {
+    b->cache = NULL;
+    b->modes = NULL;
+    b->sin_modelo = 0;
+    b->modo = NULL;
+    if (find_modelo_path(b->modelo_path, sizeof(b->modelo_path))) {
+        b->cache = abrir_modos(b->modelo_path, &b->local);
+        if (b->cache) {
+            b->modo = mode_cache_buscar(b->cache, nombre);
         } else {
-            fclose(test_file);
-        }
-        
-        GPU_Mode* modes = load_gpu_modes(modelo_path, &num_modes);
-        
-        if (!modes) {
-            printf("\033[31m❌ Error: No se pudo cargar modelo.txt\033[0m\n");
-            return;
-        }
-        
-        // Buscar el modo específico
-        GPU_Mode* target_mode = NULL;
-        for (int i = 0; i < num_modes; i++) {
-            if (strcmp(modes[i].name, value) == 0) {
-                target_mode = &modes[i];
-                break;
+            int num_modes = 0;
+            b->modes = load_gpu_modes_ex(b->modelo_path, &num_modes, 0);
+            b->sin_modelo = !b->modes;
+            for (int i = 0; i < num_modes; i++) {
+                if (strcmp(b->modes[i].name, nombre) == 0) {
+                    b->modo = &b->modes[i];
+                    break;
+                }
             }
         }
-        
-        if (!target_mode) {
-            printf("\033[31m❌ Error: Modo '%s' no encontrado en modelo.txt\033[0m\n", value);
-            free(modes);
-            return;
-        }
-        
-        // Aplicar configuraciones
-        printf("\033[36mAplicando configuraciones del sistema...\033[0m\n");
-        
-        // Dynamic Boost
-        char cmd[512];
-        snprintf(cmd, sizeof(cmd), "echo %d | sudo tee /sys/devices/system/cpu/intel_pstate/hwp_dynamic_boost", target_mode->dynamic_boost);
-        char* result = execute_system_command(cmd);
-        if (result) {
-            printf("   Dynamic Boost: %d\033[0m\n", target_mode->dynamic_boost);
-            free(result);
-        } else {
-            printf("   Advertencia: Dynamic Boost: Error al aplicar\033[0m\n");
-        }
-        
-        // CPU Max Performance
-        snprintf(cmd, sizeof(cmd), "echo %d | sudo tee /sys/devices/system/cpu/intel_pstate/max_perf_pct", target_mode->cpu_max_perf);
-        result = execute_system_command(cmd);
-        if (result) {
-            printf("   CPU Max Performance: %d%%\033[0m\n", target_mode->cpu_max_perf);
-            free(result);
-        } else {
-            printf("   Advertencia: CPU Max Performance: Error al aplicar\033[0m\n");
-        }
-        
-        // CPU Min Performance
-        snprintf(cmd, sizeof(cmd), "echo %d | sudo tee /sys/devices/system/cpu/intel_pstate/min_perf_pct", target_mode->cpu_min_perf);
-        result = execute_system_command(cmd);
-        if (result) {
-            printf("   CPU Min Performance: %d%%\033[0m\n", target_mode->cpu_min_perf);
-            free(result);
-        } else {
-            printf("   Advertencia: CPU Min Performance: Error al aplicar\033[0m\n");
-        }
-        
-        // Turbo Boost
-        snprintf(cmd, sizeof(cmd), "echo %d | sudo tee /sys/devices/system/cpu/intel_pstate/no_turbo", target_mode->turbo_boost);
-        result = execute_system_command(cmd);
-        if (result) {
-            printf("   Turbo Boost: %s\033[0m\n", target_mode->turbo_boost ? "OFF" : "ON");
-            free(result);
-        } else {
-            printf("   Advertencia: Turbo Boost: Error al aplicar\033[0m\n");
-        }
-        
-        // Persistence Mode
-        snprintf(cmd, sizeof(cmd), "sudo nvidia-smi -pm %d", target_mode->persist_mode);
-        result = execute_system_command(cmd);
-        if (result) {
-            printf("   Persistence Mode: %s\033[0m\n", target_mode->persist_mode ? "ON" : "OFF");
-            free(result);
-        } else {
-            printf("   Advertencia: Persistence Mode: Error al aplicar\033[0m\n");
-        }
-        
-        // Battery Conservation
-        snprintf(cmd, sizeof(cmd), "sudo legion_cli --donotexpecthwmon batteryconservation-%s", target_mode->battery_conservation ? "enable" : "disable");
-        result = execute_system_command(cmd);
-        if (result) {
-            printf("   Battery Conservation: %s\033[0m\n", target_mode->battery_conservation ? "ON" : "OFF");
-            free(result);
+    }
+    if (!b->modo) {
+        b->modo = buscar_modo_integrado(nombre);
+    }
+    return b->modo;
+}
+
+static void soltar_modo(ModoBuscado* b) {
+    cerrar_modos(b->cache);
+    free(b->modes);
+    b->cache = NULL;
+    b->modes = NULL;
+}
+
+int modo_disponible(const char* nombre) {
+    ModoBuscado b;
+    int existe = buscar_modo(nombre, &b) != NULL;
+    soltar_modo(&b);
+    return existe;
+}
+
+const char* sugerir_modo(const char* palabra) {
+    return sugerir_palabra_variable(palabra, lista_modos, listar_modos(), 2);
+}
+
+// Aplicar el modo que encontró buscar_modo (lo libera quien lo buscó)
+static int aplicar_modo(const char* value, ModoBuscado* b) {
+    salida_printf("\033[36mCargando configuración para modo: %s\033[0m\n", value);
+    if (b->sin_modelo) {
+        salida_printf("\033[33m⚠️  No se pudo cargar %s; se usan los modos integrados\033[0m\n", b->modelo_path);
+    }
+
+    const GPU_Mode* target_mode = b->modo;
+    if (!target_mode) {
+        salida_error("\033[31m❌ Error: Modo '%s' no encontrado en modelo.txt ni en los modos integrados\033[0m\n", value);
+        return 0;
+    }
+    
+    // Aplicar configuraciones
+    salida_printf("\033[36mAplicando configuraciones del sistema...\033[0m\n");
+    
+    // Todos los knobs del modo en un solo lote; se leen los valores actuales
+    // de una pasada y solo se escriben los que cambian
+    KnobWrite writes[PARAM_COUNT];
+    const ParamInfo* origen[PARAM_COUNT];
+    int total = 0;
+    
+    // RGB: el color del botón sale del platform-profile, más el brillo del teclado
+    const char* perfil = strlen(target_mode->rgb_color) > 0 ? rgb_color_to_profile(target_mode->rgb_color) : NULL;
+    if (!perfil && strlen(target_mode->rgb_color) > 0) {
+        salida_printf("   ⚠️  Color no reconocido: %s\n", target_mode->rgb_color);
+    }
+    
+    for (int id = 0; id < PARAM_COUNT; id++) {
+        const ParamInfo* param = &param_tabla[id];
+        if (param->knob == PARAM_SIN_KNOB || param->tipo == PARAM_TIPO_MODO) continue;
+        // Lo que el modo no menciona queda como está (frecuencias, EPP...)
+        if (!modo_define(target_mode, id)) continue;
+        if (param->tipo == PARAM_TIPO_COLOR) {
+            if (!perfil) continue;
+            knob_write_init(&writes[total], param->knob, perfil);
+        } else if (param->tipo == PARAM_TIPO_OPCION) {
+            int cantidad;
+            const char** opciones = param_opciones(param, &cantidad);
+            int indice = target_mode->valores[id];
+            if (indice < 0 || indice >= cantidad) continue;
+            knob_write_init(&writes[total], param->knob, opciones[indice]);
         } else {
-            printf("   Advertencia: Battery Conservation: Error al aplicar\033[0m\n");
+            // El brillo del teclado solo acompaña a un color válido
+            if (param->knob == KNOB_KBD_BACKLIGHT && !perfil) continue;
+            knob_write_init_int(&writes[total], param->knob, target_mode->valores[id]);
         }
-        
-        // FnLock
-        snprintf(cmd, sizeof(cmd), "sudo legion_cli --donotexpecthwmon fnlock-%s", target_mode->fnlock ? "enable" : "disable");
-        result = execute_system_command(cmd);
-        if (result) {
-            printf("   FnLock: %s\033[0m\n", target_mode->fnlock ? "ON" : "OFF");
-            free(result);
+        origen[total++] = param;
+    }
+    
+    int cambios = knobs_aplicar_cambios(writes, total);
+    if (cambios == 0 && !salida_json()) {
+        salida_printf("\033[36mEl sistema ya está en modo '%s' (0 de %d parámetros cambiados)\033[0m\n", value, total);
+        return 1;
+    }
+    
+    int errores = 0;
+    char valor[64];
+    for (int i = 0; i < total; i++) {
+        const KnobWrite* w = &writes[i];
+        const ParamInfo* param = origen[i];
+        // En JSON también se registran los knobs que ya tenían el valor
+        if (w->resultado == KNOB_UNCHANGED && !salida_json()) continue;
+        if (param->tipo == PARAM_TIPO_COLOR) {
+            snprintf(valor, sizeof(valor), "%s (color %s)", w->valor, target_mode->rgb_color);
+            errores += !reportar_knob("Platform Profile", valor, w);
         } else {
-            printf("   Advertencia: FnLock: Error al aplicar\033[0m\n");
+            param_formatear(param, target_mode->valores[param - param_tabla], valor, sizeof(valor));
+            errores += !reportar_knob(param->etiqueta, valor, w);
         }
-        
-        // RGB Control
-        if (strlen(target_mode->rgb_color) > 0) {
-            set_rgb_color(target_mode->rgb_color, target_mode->rgb_brightness);
+    }
+    
+    salida_printf("   %d de %d parámetros cambiados\n", cambios, total);
+    if (errores == 0) {
+        salida_printf("\033[36mModo '%s' aplicado exitosamente!\033[0m\n", value);
+    } else {
+        salida_printf("\033[33mModo '%s' aplicado parcialmente: %d de %d parámetros con error\033[0m\n", value, errores, cambios);
+    }
+    salida_json_inicio("modo");
+    salida_json_texto("modo", value);
+    salida_json_entero("parametros", total);
+    salida_json_entero("cambiados", cambios);
+    salida_json_entero("errores", errores);
+    salida_json_fin();
+    
+    return errores == 0;
+}
+
+
+// Aplicar un modo ya validado (de modelo.txt o integrado en gx)
+// Retorna 1 si todos los parámetros quedaron aplicados, 0 si hubo errores
+int ejecutar_modo(const char* value) {
+    ModoBuscado b;
+    buscar_modo(value, &b);
+    int aplicado = aplicar_modo(value, &b);
+    soltar_modo(&b);
+    return aplicado;
+}
+
+// Ejecutar "run mode: valor" (lo usan el intérprete, la VM de bytecode y gx auto)
+// Retorna 1 si el modo quedó aplicado sin errores
+int ejecutar_run(const char* valor_fuente, NodeType tipo_fuente) {
+    const char* value = valor_fuente;
+    NodeType value_type = tipo_fuente;
+    
+    if (value_type == NODE_SENSOR) {
+        value = valor_sensor(valor_fuente, &value_type);
+    }
+    
+    // Si el valor es un identificador, verificar si es una variable o un modo literal
+    if (value_type == NODE_IDENTIFIER) {
+        const char* var_value = get_variable_value(value);
+        if (var_value) {
+            // Es una variable definida
+            value = (char*)var_value;
+            if (is_variable_number(valor_fuente)) {
+                value_type = NODE_NUMBER;
+            } else {
+                value_type = NODE_STRING;
+            }
         }
-        
-        printf("\033[36mModo '%s' aplicado exitosamente!\033[0m\n", value);
-        
-        free(modes);
+        // Si no es una variable definida, tratar como valor literal del modo
     }
+
+    // Buscar el modo una sola vez; la lista de nombres solo para sugerir
+    ModoBuscado b;
+    if (!buscar_modo(value, &b)) {
+        soltar_modo(&b);
+        const char* sugerido = sugerir_modo(value);
+        if (!sugerido) {
+            salida_printf("Modo de ejecución desconocido: %s\n", value);
+            return 0;
+        }
+        salida_printf("\033[33m💡 ¿Quisiste decir: %s?\033[0m\n", sugerido);
+        salida_printf("\033[36mAplicando modo sugerido: %s\033[0m\n", sugerido);
+        value = sugerido;
+        buscar_modo(value, &b);
+    }
+
+    int aplicado = aplicar_modo(value, &b);
+    soltar_modo(&b);
+    return aplicado;
 }
 
+
 // Llama a esta función cuando detectes un identificador desconocido
 // tipo: 0 = modo, 1 = parámetro, 2 = comando CLI
 void manejar_identificador_desconocido(const char* palabra, int tipo) {
     const char* sugerido = NULL;
     if (tipo == 0) {
-        sugerido = sugerir_palabra(palabra, modos_validos, num_modos, 2);
+        sugerido = sugerir_modo(palabra);
     } else if (tipo == 1) {
         sugerido = sugerir_palabra(palabra, parametros_validos, num_parametros, 2);
     } else if (tipo == 2) {
         sugerido = sugerir_palabra(palabra, comandos_gpu_validos, num_comandos_gpu, 2);
     }
     if (sugerido) {
-        printf("\033[33m💡 ¿Quisiste decir: %s?\033[0m\n", sugerido); // Sugerencia en amarillo
+        salida_printf("\033[33m💡 ¿Quisiste decir: %s?\033[0m\n", sugerido); // Sugerencia en amarillo
     } else {
-        printf("Identificador desconocido: %s\n", palabra);
+        salida_printf("Identificador desconocido: %s\n", palabra);
     }
 }
 
 // Listar todas las variables definidas
 void list_variables() {
-    printf("\n📋 Variables definidas:\n");
-    if (num_variables == 0) {
-        printf("  (No hay variables definidas)\n");
+    salida_printf("\n📋 Variables definidas:\n");
+    if (variables.cantidad == 0) {
+        salida_printf("  (No hay variables definidas)\n");
         return;
     }
-    for (int i = 0; i < num_variables; i++) {
-        printf("  - %s = %s  [%s]\n", variables[i].name, variables[i].value, variables[i].is_number ? "número" : "string");
+    for (uint32_t i = 0; i < variables.cantidad; i++) {
+        const Simbolo* var = &variables.simbolos[i];
+        salida_printf("  - %s = %s  [%s]\n", var->nombre, var->texto, var->tipo == SYM_NUMERO ? "número" : "string");
     }
 }
 
@@ -0,0 +1,461 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "../include/knobs.h"
+#include "../include/glxd.h"
+#include "../include/sim.h"
+#include "../include/gpu_telemetry.h"
+#include "../include/ejecutor.h"
+#include "../include/cpufreq.h"
+
+#define VPC2004_DIR "/sys/devices/pci0000:00/0000:00:1f.0/PNP0C09:00/VPC2004:00"
+
+#define NVIDIA_PERSISTENCE_QUERY "nvidia-smi --query-gpu=persistence_mode --format=csv,noheader 2>/dev/null"
+
+// Descripción de cada knob: rutas sysfs candidatas (en orden de preferencia),
+// comandos alternativos y rango válido para valores numéricos
+typedef struct {
+    const char* nombre;
+    const char* rutas[2];
+    const char* comando;     // printf con %s = "enable"/"disable" o el valor
+    int es_booleano_cli;     // el comando espera enable/disable en vez del número
+    const char* lectura;     // comando que imprime el valor actual (si no hay sysfs)
+    int min;
+    int max;
+} KnobInfo;
+
+static const KnobInfo knob_tabla[KNOB_COUNT] = {
+    [KNOB_DYNAMIC_BOOST] = { "dynamic_boost", { INTEL_PSTATE_DIR "/hwp_dynamic_boost", NULL }, NULL, 0, NULL, 0, 1 },
+    [KNOB_CPU_MAX_PERF] = { "cpu_max_perf", { INTEL_PSTATE_DIR "/max_perf_pct", NULL }, NULL, 0, NULL, 0, 100 },
+    [KNOB_CPU_MIN_PERF] = { "cpu_min_perf", { INTEL_PSTATE_DIR "/min_perf_pct", NULL }, NULL, 0, NULL, 0, 100 },
+    [KNOB_NO_TURBO] = { "no_turbo", { INTEL_PSTATE_DIR "/no_turbo", NULL }, NULL, 0, NULL, 0, 1 },
+    [KNOB_PERSIST_MODE] = { "persist_mode", { NULL, NULL }, "nvidia-smi -pm %s", 0, NVIDIA_PERSISTENCE_QUERY, 0, 1 },
+    [KNOB_BATTERY_CONSERVATION] = { "battery_conservation", { VPC2004_DIR "/conservation_mode", NULL },
+                                    "legion_cli --donotexpecthwmon batteryconservation-%s", 1, NULL, 0, 1 },
+    [KNOB_FNLOCK] = { "fnlock", { VPC2004_DIR "/fn_lock", NULL },
+                      "legion_cli --donotexpecthwmon fnlock-%s", 1, NULL, 0, 1 },
+    [KNOB_PLATFORM_PROFILE] = { "platform_profile", { PLATFORM_PROFILE_PATH, PLATFORM_PROFILE_LEGACY_PATH }, NULL, 0, NULL, 0, 0 },
+    [KNOB_KBD_BACKLIGHT] = { "kbd_backlight", { KBD_BACKLIGHT_PATH, NULL }, NULL, 0, NULL, 0, 100 },
+    // Sin ruta propia: los escribe cpufreq.c en cada policy (frecuencias en MHz)
+    [KNOB_CPU_EPP_P] = { "cpu_epp_p", { NULL, NULL }, NULL, 0, NULL, 0, 0 },
+    [KNOB_CPU_EPP_E] = { "cpu_epp_e", { NULL, NULL }, NULL, 0, NULL, 0, 0 },
+    [KNOB_CPU_GOVERNOR_P] = { "cpu_governor_p", { NULL, NULL }, NULL, 0, NULL, 0, 0 },
+    [KNOB_CPU_GOVERNOR_E] = { "cpu_governor_e", { NULL, NULL }, NULL, 0, NULL, 0, 0 },
+    [KNOB_CPU_MAX_FREQ_P] = { "cpu_max_freq_p", { NULL, NULL }, NULL, 0, NULL, 100, 10000 },
+    [KNOB_CPU_MAX_FREQ_E] = { "cpu_max_freq_e", { NULL, NULL }, NULL, 0, NULL, 100, 10000 },
+    [KNOB_CPU_MIN_FREQ_P] = { "cpu_min_freq_p", { NULL, NULL }, NULL, 0, NULL, 100, 10000 },
+    [KNOB_CPU_MIN_FREQ_E] = { "cpu_min_freq_e", { NULL, NULL }, NULL, 0, NULL, 100, 10000 },
+};
+
+// Atributo y clase de núcleos de cada knob de cpufreq
+typedef struct {
+    KnobId id;
+    CpufreqAtributo atributo;
+    CpufreqClase clase;
+} KnobCpufreq;
+
+static const KnobCpufreq knobs_cpufreq[] = {
+    { KNOB_CPU_EPP_P, CPUFREQ_ATTR_EPP, CPUFREQ_CLASE_P },
+    { KNOB_CPU_EPP_E, CPUFREQ_ATTR_EPP, CPUFREQ_CLASE_E },
+    { KNOB_CPU_GOVERNOR_P, CPUFREQ_ATTR_GOBERNADOR, CPUFREQ_CLASE_P },
+    { KNOB_CPU_GOVERNOR_E, CPUFREQ_ATTR_GOBERNADOR, CPUFREQ_CLASE_E },
+    { KNOB_CPU_MAX_FREQ_P, CPUFREQ_ATTR_MAX_FREQ, CPUFREQ_CLASE_P },
+    { KNOB_CPU_MAX_FREQ_E, CPUFREQ_ATTR_MAX_FREQ, CPUFREQ_CLASE_E },
+    { KNOB_CPU_MIN_FREQ_P, CPUFREQ_ATTR_MIN_FREQ, CPUFREQ_CLASE_P },
+    { KNOB_CPU_MIN_FREQ_E, CPUFREQ_ATTR_MIN_FREQ, CPUFREQ_CLASE_E },
+};
+
+static const KnobCpufreq* knob_cpufreq(KnobId id) {
+    for (size_t i = 0; i < sizeof(knobs_cpufreq) / sizeof(knobs_cpufreq[0]); i++) {
+        if (knobs_cpufreq[i].id == id) return &knobs_cpufreq[i];
+    }
+    return NULL;
+}
+
+// Perfiles aceptados por platform_profile
+static const char* perfiles_validos[] = {
+    "low-power", "quiet", "balanced", "balanced-performance", "performance"
+};
+
+static char sysfs_root[256] = "";
+static int backend_nulo = 0;
+
+void knobs_set_nulo(int activo) {
+    backend_nulo = activo;
+}
+
+void knobs_set_root(const char* root) {
+    if (!root) root = "";
+    strncpy(sysfs_root, root, sizeof(sysfs_root) - 1);
+    sysfs_root[sizeof(sysfs_root) - 1] = '\0';
+    // Evitar dobles barras al concatenar con rutas absolutas
+    size_t len = strlen(sysfs_root);
+    while (len > 0 && sysfs_root[len - 1] == '/') sysfs_root[--len] = '\0';
+    cpufreq_reiniciar();
+}
+
+const char* knobs_get_root(void) {
+    return sysfs_root;
+}
+
+const char* knob_nombre(KnobId id) {
+    if (id < 0 || id >= KNOB_COUNT) return "desconocido";
+    return knob_tabla[id].nombre;
+}
+
+int knob_buscar(const char* nombre) {
+    for (int i = 0; i < KNOB_COUNT; i++) {
+        if (strcmp(knob_tabla[i].nombre, nombre) == 0) return i;
+    }
+    return -1;
+}
+
+// Verificar que un valor es aceptable para el knob antes de escribirlo
+int knob_validar(KnobId id, const char* valor) {
+    if (id < 0 || id >= KNOB_COUNT || !valor || !*valor) return 0;
+
+    if (id == KNOB_PLATFORM_PROFILE) {
+        for (size_t i = 0; i < sizeof(perfiles_validos) / sizeof(perfiles_validos[0]); i++) {
+            if (strcmp(valor, perfiles_validos[i]) == 0) return 1;
+        }
+        return 0;
+    }
+
+    // EPP y governor: la lista la da el kernel en cada policy
+    const KnobCpufreq* cpufreq = knob_cpufreq(id);
+    if (cpufreq && (cpufreq->atributo == CPUFREQ_ATTR_EPP || cpufreq->atributo == CPUFREQ_ATTR_GOBERNADOR)) {
+        return cpufreq_validar(cpufreq->clase, cpufreq->atributo, valor);
+    }
+
+    char* fin;
+    long n = strtol(valor, &fin, 10);
+    if (*fin != '\0') return 0;
+    return n >= knob_tabla[id].min && n <= knob_tabla[id].max;
+}
+
+int knob_ruta(KnobId id, char* buffer, size_t size) {
+    if (id < 0 || id >= KNOB_COUNT) return 0;
+    for (int i = 0; i < 2; i++) {
+        const char* ruta = knob_tabla[id].rutas[i];
+        if (!ruta) continue;
+        snprintf(buffer, size, "%s%s", sysfs_root, ruta);
+        if (access(buffer, F_OK) == 0) return 1;
+    }
+    return 0;
+}
+
+int knob_comando(KnobId id, const char* valor, char* buffer, size_t size) {
+    if (id < 0 || id >= KNOB_COUNT || !knob_tabla[id].comando) return 0;
+
+    const char* argumento = valor;
+    if (knob_tabla[id].es_booleano_cli) {
+        argumento = atoi(valor) ? "enable" : "disable";
+    }
+
+    // Como root no hace falta sudo (por ejemplo dentro de glxd)
+    int n = snprintf(buffer, size, "%s", geteuid() == 0 ? "" : "sudo ");
+    snprintf(buffer + n, size - n, knob_tabla[id].comando, argumento);
+    return 1;
+}
+
+void knob_write_init(KnobWrite* write, KnobId id, const char* valor) {
+    write->id = id;
+    strncpy(write->valor, valor, sizeof(write->valor) - 1);
+    write->valor[sizeof(write->valor) - 1] = '\0';
+    write->resultado = KNOB_ERROR;
+    write->error = 0;
+    write->via_comando = 0;
+    write->duracion_us = 0;
+}
+
+void knob_write_init_int(KnobWrite* write, KnobId id, int valor) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%d", valor);
+    knob_write_init(write, id, buffer);
+}
+
+// Descriptores que quedan abiertos durante una sesión (gx shell), como los
+// de glxd; -1 si el atributo no existe o no se puede abrir sin privilegios
+static int sesion_fds[KNOB_COUNT];
+static int sesion_regular[KNOB_COUNT];     // Archivo común (árbol falso)
+static int sesion_activa = 0;
+
+static void sesion_abrir_knob(int id) {
+    char ruta[512];
+    sesion_fds[id] = -1;
+    sesion_regular[id] = 0;
+    if (!knob_ruta(id, ruta, sizeof(ruta))) return;
+
+    sesion_fds[id] = open(ruta, O_RDWR | O_CLOEXEC);
+    struct stat st;
+    if (sesion_fds[id] >= 0 && fstat(sesion_fds[id], &st) == 0) {
+        sesion_regular[id] = S_ISREG(st.st_mode);
+    }
+}
+
+int knobs_sesion_abrir(void) {
+    int abiertos = 0;
+    for (int i = 0; i < KNOB_COUNT; i++) {
+        sesion_abrir_knob(i);
+        if (sesion_fds[i] >= 0) abiertos++;
+    }
+    sesion_activa = 1;
+    return abiertos;
+}
+
+void knobs_sesion_cerrar(void) {
+    if (!sesion_activa) return;
+    for (int i = 0; i < KNOB_COUNT; i++) {
+        if (sesion_fds[i] >= 0) close(sesion_fds[i]);
+        sesion_fds[i] = -1;
+    }
+    sesion_activa = 0;
+}
+
+static int sesion_fd(KnobId id) {
+    return sesion_activa ? sesion_fds[id] : -1;
+}
+
+// Escribir por el descriptor de la sesión
+// Retorna 0 si quedó escrito, errno si falló
+static int sesion_escribir(KnobId id, const char* valor) {
+    size_t len = strlen(valor);
+    ssize_t n = pwrite(sesion_fds[id], valor, len, 0);
+    if (n < 0 && (errno == EBADF || errno == ENODEV)) {
+        // El dispositivo pudo re-enumerarse: reabrir una vez y reintentar
+        close(sesion_fds[id]);
+        sesion_abrir_knob(id);
+        if (sesion_fds[id] < 0) return errno ? errno : ENOENT;
+        n = pwrite(sesion_fds[id], valor, len, 0);
+    }
+    if (n != (ssize_t)len) return n < 0 ? errno : EIO;
+
+    // En un árbol falso son archivos comunes: recortar restos de un valor más largo
+    if (sesion_regular[id] && ftruncate(sesion_fds[id], len) != 0) return errno;
+    return 0;
+}
+
+// persistence_mode sale de la telemetría si hay un productor andando (gx
+// shell, watch, glxd), sin lanzar otro nvidia-smi. Solo vale una muestra
+// posterior a la última escritura; si no, se consulta como siempre
+static long long persistencia_escrita_ms = 0;
+
+static long long ahora_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int leer_persistencia_telemetria(char* valor, size_t size) {
+    GpuSample muestra;
+    if (gpu_telemetry_activa()) gpu_telemetry_actualizar();    // drenar lo que ya imprimió
+    if (!gpu_telemetry_activa() || !gpu_telemetry_ultima(&muestra) || muestra.persistencia < 0) return 0;
+    if (muestra.timestamp_ms <= __atomic_load_n(&persistencia_escrita_ms, __ATOMIC_RELAXED)) return 0;
+    snprintf(valor, size, "%d", muestra.persistencia);
+    return 1;
+}
+
+void knob_aplicar_local(KnobWrite* write) {
+    char ruta[512];
+    write->resultado = KNOB_ERROR;
+    write->error = 0;
+    write->via_comando = 0;
+
+    if (!knob_validar(write->id, write->valor)) {
+        write->error = EINVAL;
+        return;
+    }
+
+    if (knob_ruta(write->id, ruta, sizeof(ruta))) {
+        if (sim_operacion(knob_tabla[write->id].nombre, "sysfs") != 0) {
+            write->error = errno;
+            return;
+        }
+        if (sesion_fd(write->id) >= 0) {
+            write->error = sesion_escribir(write->id, write->valor);
+            write->resultado = write->error == 0 ? KNOB_OK : KNOB_ERROR;
+            return;
+        }
+        write->resultado = write_sysfs_knob(ruta, write->valor);
+        if (write->resultado == KNOB_ERROR) write->error = errno;
+        return;
+    }
+
+    const KnobCpufreq* cpufreq = knob_cpufreq(write->id);
+    if (cpufreq) {
+        if (sim_operacion(knob_tabla[write->id].nombre, "sysfs") != 0) {
+            write->error = errno;
+            return;
+        }
+        write->resultado = cpufreq_escribir(cpufreq->clase, cpufreq->atributo, write->valor);
+        if (write->resultado == KNOB_ERROR) write->error = errno;
+        return;
+    }
+
+    char cmd[512];
+    if (knob_comando(write->id, write->valor, cmd, sizeof(cmd))) {
+        int codigo = execute_system_command_status(cmd);
+        if (write->id == KNOB_PERSIST_MODE) __atomic_store_n(&persistencia_escrita_ms, ahora_ms(), __ATOMIC_RELAXED);
+        write->via_comando = 1;
+        if (codigo == 0) {
+            write->resultado = geteuid() == 0 ? KNOB_OK : KNOB_OK_PRIVILEGED;
+        } else {
+            write->error = codigo;
+        }
+        return;
+    }
+
+    // Ni atributo sysfs ni comando: el hardware no está presente
+    write->error = ENOENT;
+}
+
+int knob_leer_local(KnobId id, char* valor, size_t size) {
+    char ruta[512];
+    valor[0] = '\0';
+    if (id < 0 || id >= KNOB_COUNT) return 0;
+
+    if (knob_ruta(id, ruta, sizeof(ruta))) {
+        if (sim_operacion(knob_tabla[id].nombre, "sysfs") != 0) return 0;
+        ssize_t n;
+        if (sesion_fd(id) >= 0) {
+            n = pread(sesion_fds[id], valor, size - 1, 0);
+        } else {
+            int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return 0;
+            n = read(fd, valor, size - 1);
+            close(fd);
+        }
+        if (n <= 0) {
+            valor[0] = '\0';
+            return 0;
+        }
+        valor[n] = '\0';
+        valor[strcspn(valor, "\n")] = '\0';
+        return 1;
+    }
+
+    const KnobCpufreq* cpufreq = knob_cpufreq(id);
+    if (cpufreq) {
+        if (sim_operacion(knob_tabla[id].nombre, "sysfs") != 0) return 0;
+        return cpufreq_leer(cpufreq->clase, cpufreq->atributo, valor, size);
+    }
+
+    if (id == KNOB_PERSIST_MODE && leer_persistencia_telemetria(valor, size)) return 1;
+
+    if (knob_tabla[id].lectura) {
+        char* salida = execute_system_command(knob_tabla[id].lectura);
+        if (!salida) return 0;
+        salida[strcspn(salida, "\n")] = '\0';
+        // nvidia-smi responde Enabled/Disabled; el resto de GLX usa 1/0
+        if (strcmp(salida, "Enabled") == 0) snprintf(valor, size, "1");
+        else if (strcmp(salida, "Disabled") == 0) snprintf(valor, size, "0");
+        free(salida);
+        return valor[0] != '\0';
+    }
+    return 0;
+}
+
+int knobs_leer_estado(char valores[KNOB_COUNT][32]) {
+    int leidos = 0;
+
+    if (backend_nulo) {
+        for (int i = 0; i < KNOB_COUNT; i++) valores[i][0] = '\0';
+        return 0;
+    }
+
+    // glxd ya tiene los descriptores abiertos: una sola consulta trae todo
+    if (glxd_consultar(valores) == 0) {
+        for (int i = 0; i < KNOB_COUNT; i++) {
+            if (valores[i][0]) leidos++;
+        }
+        return leidos;
+    }
+
+    for (int i = 0; i < KNOB_COUNT; i++) {
+        leidos += knob_leer_local(i, valores[i], sizeof(valores[i]));
+    }
+    return leidos;
+}
+
+const char* knob_error_str(const KnobWrite* write, char* buffer, size_t size) {
+    if (write->via_comando) {
+        snprintf(buffer, size, "código de salida %d", write->error);
+    } else {
+        snprintf(buffer, size, "%s", strerror(write->error));
+    }
+    return buffer;
+}
+
+int knobs_aplicar(KnobWrite* writes, int cantidad) {
+    int aplicados = 0;
+
+    if (backend_nulo) {
+        for (int i = 0; i < cantidad; i++) {
+            writes[i].resultado = KNOB_OK;
+            writes[i].error = 0;
+            writes[i].via_comando = 0;
+        }
+        return cantidad;
+    }
+
+    // Con el daemon corriendo, un solo mensaje aplica todo el lote sin sudo
+    int daemon = glxd_aplicar(writes, cantidad);
+    if (daemon == 0) {
+        for (int i = 0; i < cantidad; i++) {
+            if (writes[i].resultado != KNOB_ERROR) aplicados++;
+        }
+        return aplicados;
+    }
+    if (daemon == GLXD_FALLO) {
+        // El daemon pudo estar escribiendo todavía: aplicar localmente
+        // lanzaría un segundo lote en paralelo con el suyo
+        int error = errno;
+        for (int i = 0; i < cantidad; i++) {
+            writes[i].resultado = KNOB_ERROR;
+            writes[i].error = error;
+            writes[i].via_comando = 0;
+        }
+        return 0;
+    }
+
+    // Sin daemon: cada backend en su hilo, respetando el orden entre knobs
+    return ejecutor_aplicar(writes, cantidad, EJECUTOR_PLAZO_MS);
+}
+
+int knobs_aplicar_cambios(KnobWrite* writes, int cantidad) {
+    char actuales[KNOB_COUNT][32];
+    knobs_leer_estado(actuales);
+
+    KnobWrite* pendientes = malloc(cantidad * sizeof(KnobWrite));
+    int* origen = malloc(cantidad * sizeof(int));
+    int cambios = 0;
+
+    for (int i = 0; i < cantidad; i++) {
+        // Un valor que no se pudo leer cuenta como distinto y se escribe
+        if (actuales[writes[i].id][0] && strcmp(actuales[writes[i].id], writes[i].valor) == 0) {
+            writes[i].resultado = KNOB_UNCHANGED;
+            writes[i].error = 0;
+            writes[i].via_comando = 0;
+            continue;
+        }
+        pendientes[cambios] = writes[i];
+        origen[cambios] = i;
+        cambios++;
+    }
+
+    if (cambios > 0) {
+        knobs_aplicar(pendientes, cambios);
+        for (int i = 0; i < cambios; i++) {
+            writes[origen[i]] = pendientes[i];
+        }
+    }
+
+    free(pendientes);
+    free(origen);
+    return cambios;
+}
@@ -4,113 +4,150 @@
 #include <ctype.h>
 #include "../include/lexer.h"
 
-// Función auxiliar: agrega un token al array de token
-void agregar_token(char*** tokens, int* cantidad, const char* valor) {
-    *tokens = realloc(*tokens, (*cantidad + 1) * sizeof(char*));
-    (*tokens)[*cantidad] = strdup(valor);
-    (*cantidad)++; 
+// Estado del lexer mientras recorre el texto
+typedef struct {
+    Token* tokens;
+    int cantidad;
+    int capacidad;
+    int tokens_en_linea;   // Tokens de la línea actual (para el guión inicial)
+    Arena* arena;
+} Lexer;
+
+// Función auxiliar: agrega un token al array de tokens
+// El array crece al doble para que un archivo grande no haga un realloc por token
+static void agregar_token(Lexer* lx, TokenType tipo, char* texto, int linea, int columna) {
+    if (lx->cantidad == lx->capacidad) {
+        lx->capacidad = lx->capacidad ? lx->capacidad * 2 : 64;
+        lx->tokens = realloc(lx->tokens, lx->capacidad * sizeof(Token));
+    }
+    Token* t = &lx->tokens[lx->cantidad++];
+    t->tipo = tipo;
+    t->texto = texto;
+    t->linea = linea;
+    t->columna = columna;
+    if (tipo == TOKEN_FIN_LINEA) {
+        lx->tokens_en_linea = 0;
+    } else {
+        lx->tokens_en_linea++;
+    }
 }
 
-char** lexer_tokenize(const char* linea, int* cantidad) {
-    char* copia = strdup(linea);
-    char** tokens = NULL;
-    *cantidad = 0;
-    
-    char* ptr = copia;
-    while (*ptr) {
+// Todos los fines de línea comparten el mismo texto
+static char fin_linea_texto[] = "\n";
+
+Token* lexer_tokenize(const char* texto, size_t len, int* cantidad, Arena* arena) {
+    Lexer lx = { NULL, 0, 0, 0, arena };
+    const char* ptr = texto;
+    const char* fin = texto + len;
+    const char* inicio_linea = texto;
+    int linea = 1;
+
+#define COLUMNA(p) ((int)((p) - inicio_linea) + 1)
+
+    while (ptr < fin) {
         // Saltar espacios y tabs
-        while (*ptr == ' ' || *ptr == '\t' || *ptr == '\n') ptr++;
-        if (*ptr == '\0') break;
+        while (ptr < fin && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r')) ptr++;
+        if (ptr >= fin) break;
+
+        // Fin de línea: separa sentencias (las líneas vacías no generan token)
+        if (*ptr == '\n') {
+            if (lx.tokens_en_linea > 0) {
+                agregar_token(&lx, TOKEN_FIN_LINEA, fin_linea_texto, linea, COLUMNA(ptr));
+            }
+            ptr++;
+            linea++;
+            inicio_linea = ptr;
+            continue;
+        }
 
-        // Ignorar comentarios (todo lo que viene después de #)
+        // Ignorar comentarios (todo lo que viene después de # hasta el fin de línea)
         if (*ptr == '#') {
-            break; // Terminar el procesamiento de esta línea
+            while (ptr < fin && *ptr != '\n') ptr++;
+            continue;
         }
 
         // Ignorar guiones al inicio de línea (parte de la estructura)
-        // Solo si es el primer token de la línea (después de espacios)
-        if (*ptr == '-' && (*cantidad == 0 || (ptr > copia && *(ptr-1) == ' '))) {
+        // Solo si es el primer token de la línea o viene después de un espacio
+        if (*ptr == '-' && (lx.tokens_en_linea == 0 || (ptr > inicio_linea && *(ptr-1) == ' '))) {
             ptr++;
             // Saltar espacios después del guión
-            while (*ptr == ' ' || *ptr == '\t') ptr++;
+            while (ptr < fin && (*ptr == ' ' || *ptr == '\t')) ptr++;
             continue;
         }
 
         // Soporte robusto para strings entre comillas dobles con escapes
         if (*ptr == '"') {
+            const char* inicio = ptr;
             ptr++; // Saltar la comilla inicial
-            char buffer[256];
+            // El string nunca es más largo que lo que queda de la línea
+            const char* fin_linea = memchr(ptr, '\n', fin - ptr);
+            if (!fin_linea) fin_linea = fin;
+            char* buffer = arena_alloc(lx.arena, (fin_linea - ptr) + 3);
             int buf_idx = 0;
             buffer[buf_idx++] = '"'; // Mantener la comilla inicial en el token
             int cerrado = 0;
-            while (*ptr && buf_idx < 254) {
-                if (*ptr == '\\') {
+            while (ptr < fin_linea) {
+                if (*ptr == '\\' && ptr + 1 < fin_linea) {
                     ptr++;
                     if (*ptr == 'n') buffer[buf_idx++] = '\n';
                     else if (*ptr == 't') buffer[buf_idx++] = '\t';
                     else if (*ptr == 'r') buffer[buf_idx++] = '\r';
-                    else if (*ptr == '"') buffer[buf_idx++] = '"';
-                    else if (*ptr == '\\') buffer[buf_idx++] = '\\';
-                    else if (*ptr) buffer[buf_idx++] = *ptr;
-                    if (*ptr) ptr++;
+                    else buffer[buf_idx++] = *ptr;
+                    ptr++;
                 } else if (*ptr == '"') {
                     buffer[buf_idx++] = '"'; // Mantener la comilla final en el token
                     ptr++; // Saltar la comilla final
                     cerrado = 1;
                     break;
                 } else {
-                    buffer[buf_idx++] = *ptr;
-                    ptr++;
+                    buffer[buf_idx++] = *ptr++;
                 }
             }
             buffer[buf_idx] = '\0';
-            agregar_token(&tokens, cantidad, buffer);
-            // Si no se cerró el string, avanzar hasta el final de la comilla para no romper el flujo
-            if (!cerrado && *ptr == '"') ptr++;
+            if (!cerrado) {
+                fprintf(stderr, "\033[33mAdvertencia: línea %d, columna %d: string sin cerrar\033[0m\n", linea, COLUMNA(inicio));
+            }
+            agregar_token(&lx, TOKEN_TEXTO, buffer, linea, COLUMNA(inicio));
             continue;
         }
 
         // Buscar delimitadores : o = en el token actual
-        char* start = ptr;
-        while (*ptr && *ptr != ' ' && *ptr != '\t' && *ptr != '\n' && *ptr != ':' && *ptr != '=') ptr++;
-        size_t len = ptr - start;
-        if (len > 0) {
-            char temp[256];
-            strncpy(temp, start, len);
-            temp[len] = '\0';
-            agregar_token(&tokens, cantidad, temp);
+        const char* start = ptr;
+        while (ptr < fin && *ptr != ' ' && *ptr != '\t' && *ptr != '\r' && *ptr != '\n' && *ptr != ':' && *ptr != '=') ptr++;
+        if (ptr > start) {
+            agregar_token(&lx, TOKEN_TEXTO, arena_strndup(lx.arena, start, ptr - start), linea, COLUMNA(start));
         }
-        if (*ptr == ':' || *ptr == '=') {
-            char temp[2] = {*ptr, '\0'};
-            agregar_token(&tokens, cantidad, temp);
+        if (ptr < fin && (*ptr == ':' || *ptr == '=')) {
+            agregar_token(&lx, TOKEN_TEXTO, arena_strndup(lx.arena, ptr, 1), linea, COLUMNA(ptr));
             ptr++;
             
             // Después de un delimitador, manejar números negativos correctamente
-            while (*ptr == ' ' || *ptr == '\t') ptr++;
-            if (*ptr == '-') {
+            while (ptr < fin && (*ptr == ' ' || *ptr == '\t')) ptr++;
+            if (ptr < fin && *ptr == '-') {
                 // Es un número negativo
-                char* num_start = ptr;
+                const char* num_start = ptr;
                 ptr++; // Saltar el signo menos
-                while (*ptr && isdigit(*ptr)) ptr++;
+                while (ptr < fin && isdigit((unsigned char)*ptr)) ptr++;
                 size_t num_len = ptr - num_start;
                 if (num_len > 1) { // Al menos un dígito después del signo
-                    char temp_num[256];
-                    strncpy(temp_num, num_start, num_len);
-                    temp_num[num_len] = '\0';
-                    agregar_token(&tokens, cantidad, temp_num);
+                    agregar_token(&lx, TOKEN_TEXTO, arena_strndup(lx.arena, num_start, num_len), linea, COLUMNA(num_start));
                     continue;
                 }
             }
         }
     }
-    free(copia);
-    return tokens;
-}
 
-void liberar_tokens(char** tokens, int cantidad) {
-    for (int i = 0; i < cantidad; i++) {
-        free(tokens[i]);
+    // La última sentencia también termina en fin de línea aunque el archivo no lo tenga
+    if (lx.tokens_en_linea > 0) {
+        agregar_token(&lx, TOKEN_FIN_LINEA, fin_linea_texto, linea, COLUMNA(ptr));
     }
-    free(tokens);
+#undef COLUMNA
+
+    *cantidad = lx.cantidad;
+    return lx.tokens;
 }
 
+void liberar_tokens(Token* tokens, int cantidad) {
+    (void)cantidad;
+    free(tokens);
+}
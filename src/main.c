@@ -1,13 +1,28 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "../include/lexer.h"
 #include "../include/parser.h"
 #include "../include/interpreter.h"
 #include "../include/utils.h"
+#include "../include/knobs.h"
+#include "../include/status.h"
+#include "../include/mode_cache.h"
+#include "../include/watch.h"
+#include "../include/record.h"
+#include "../include/gxc.h"
+#include "../include/salida.h"
+#include "../include/sim.h"
+#include "../include/optimizador.h"
+#include "../include/auto.h"
+#include "../include/shell.h"
 
 // Función auxiliar para imprimir el AST
-void print_ast(ASTNode* node, int depth) {
+void print_ast(const AST* ast, const ASTNode* node, int depth) {
     if (!node) return;
 
     // Imprimir indentación
@@ -26,23 +41,55 @@ void print_ast(ASTNode* node, int depth) {
         case NODE_STRING: printf("STRING"); break;
         case NODE_GPU_COMMAND: printf("GPU_COMMAND"); break;
         case NODE_RUN_COMMAND: printf("RUN_COMMAND"); break;
+        case NODE_SENSOR: printf("SENSOR"); break;
     }
     if (node->value) {
         printf(", Value: %s", node->value);
     }
+    if (node->linea > 0) {
+        printf(" (%d:%d)", node->linea, node->columna);
+    }
     printf("\n");
 
     // Imprimir nodos hijos
     for (int i = 0; i < node->num_children; i++) {
-        print_ast(node->children[i], depth + 1);
+        print_ast(ast, ast_hijo(ast, node, i), depth + 1);
     }
 }
 
 int main(int argc, char* argv[]) {
-    FILE* archivo;
-    char linea[256];
     const char* nombre_archivo = "gx_programs/ejemplo.gx";
     
+    // Permitir apuntar sysfs/procfs a un árbol alternativo (pruebas, benchmarks)
+    knobs_set_root(getenv("GLX_SYSFS_ROOT"));
+    
+    // Simulador de hardware (sim/glx-sim): por entorno o con --sim=DIR
+    const char* sim_dir = getenv("GLX_SIM");
+    if (sim_dir && *sim_dir && sim_activar(sim_dir) != 0) {
+        printf("\033[31m❌ Error: GLX_SIM no apunta a un árbol simulado: %s\033[0m\n", sim_dir);
+        return 1;
+    }
+    
+    // Opciones de salida globales, antes del comando (gx -q archivo.gx)
+    while (argc > 1 && argv[1][0] == '-') {
+        int opcion = salida_opcion(argv[1]);
+        if (opcion == 0 && strncmp(argv[1], "--sim=", 6) == 0) {
+            if (sim_activar(argv[1] + 6) != 0) {
+                printf("\033[31m❌ Error: No es un árbol simulado: %s (crearlo con sim/glx-sim crear)\033[0m\n", argv[1] + 6);
+                return 1;
+            }
+            opcion = 1;
+        }
+        if (opcion == 0) break;
+        if (opcion < 0) {
+            printf("\033[31m❌ Error: Formato de salida inválido: %s (usar --format=text o --format=json)\033[0m\n", argv[1]);
+            return 1;
+        }
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+    }
+    
     // Verificar si se pasó el comando help
     if (argc > 1 && strcmp(argv[1], "help") == 0) {
         printf("\033[36m📚 GLX - Controlador de GPU\n");
@@ -50,8 +97,21 @@ int main(int argc, char* argv[]) {
         printf("Comandos disponibles:\n");
         printf("  help                    - Mostrar esta ayuda\n");
         printf("  status                  - Mostrar estado de la GPU\n");
+        printf("  watch [--hz N] [--count N] - Muestrear el estado de forma continua\n");
+        printf("  shell                   - Sesión interactiva que conserva variables y backends\n");
+        printf("  auto [--config archivo] [--stdin] - Cambiar de modo al conectar/desconectar el cargador\n");
+        printf("  record archivo.glxr [--hz N] [--duration S] - Grabar telemetría binaria\n");
+        printf("  replay archivo.glxr [--from S] [--to S] - Mostrar una grabación\n");
+        printf("  export archivo.glxr [--format csv|json] [--from S] [--to S] - Exportar una grabación\n");
         printf("  reset                   - Resetear GPU a valores por defecto\n");
-        printf("  vars                    - Mostrar variables definidas\n\n");
+        printf("  vars                    - Mostrar variables definidas\n");
+        printf("  modes compile [archivo] - Compilar la caché de modelo.txt\n\n");
+        printf("Opciones de salida (antes del comando o archivo):\n");
+        printf("  -q, --quiet             - Mostrar solo errores\n");
+        printf("  --debug-tokens          - Mostrar los tokens del lexer\n");
+        printf("  --debug-ast             - Mostrar tokens y AST\n");
+        printf("  --format=json           - Un registro JSON por sentencia y knob aplicado\n");
+        printf("  --sim=DIR               - Usar el hardware simulado de sim/glx-sim\n\n");
         printf("Parámetros de GPU:\n");
         printf("  run mode: [quiet/balanced/performance] - Aplicar modo\n");
         printf("  dynamic_boost: [0/1]    - Activar/desactivar Dynamic Boost\n");
@@ -72,68 +132,138 @@ int main(int argc, char* argv[]) {
     
     // Verificar si se pasó el comando status
     if (argc > 1 && strcmp(argv[1], "status") == 0) {
-        printf("\033[36mEstado actual del sistema:\033[0m\n");
-        
-        // Obtener información de GPU
-        char* gpu_info = execute_system_command("nvidia-smi --query-gpu=name,power.draw,temperature.gpu,clocks.current.graphics --format=csv,noheader,nounits 2>/dev/null");
-        if (gpu_info) {
-            printf("   GPU: %s", gpu_info);
-            free(gpu_info);
-        } else {
-            printf("   Advertencia: GPU: No se pudo obtener información\033[0m\n");
+        status_mostrar();
+        return 0;
+    }
+    
+    // Verificar si se pasó el comando shell
+    if (argc > 1 && strcmp(argv[1], "shell") == 0) {
+        if (argc > 2) {
+            printf("\033[31m❌ Error: Uso: gx shell\033[0m\n");
+            return 1;
         }
-        
-        // Obtener información de CPU
-        char* cpu_info = execute_system_command("cat /proc/cpuinfo | grep 'model name' | head -1 | cut -d':' -f2 | sed 's/^[ \t]*//'");
-        if (cpu_info) {
-            printf("   CPU: %s", cpu_info);
-            free(cpu_info);
+        return shell_ejecutar();
+    }
+    
+    // Verificar si se pasó el comando watch
+    if (argc > 1 && strcmp(argv[1], "watch") == 0) {
+        int hz = WATCH_HZ_DEFECTO;
+        long muestras = 0;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+                hz = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+                muestras = atol(argv[++i]);
+            } else {
+                printf("\033[31m❌ Error: Uso: gx watch [--hz 1-%d] [--count N]\033[0m\n", WATCH_HZ_MAX);
+                return 1;
+            }
         }
-        
-        // Obtener información de memoria
-        char* mem_info = execute_system_command("free -h | grep '^Mem:' | awk '{print \"Memoria: \" $2 \" total, \" $3 \" usado, \" $4 \" libre\"}'");
-        if (mem_info) {
-            printf("   %s", mem_info);
-            free(mem_info);
+        if (hz < 1 || hz > WATCH_HZ_MAX) {
+            printf("\033[31m❌ Error: --hz debe estar entre 1 y %d\033[0m\n", WATCH_HZ_MAX);
+            return 1;
+        }
+        return watch_ejecutar(hz, muestras);
+    }
+    
+    // Verificar si se pasó el comando auto
+    if (argc > 1 && strcmp(argv[1], "auto") == 0) {
+        const char* config_path = NULL;
+        int desde_stdin = 0;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+                config_path = argv[++i];
+            } else if (strcmp(argv[i], "--stdin") == 0) {
+                desde_stdin = 1;
+            } else {
+                printf("\033[31m❌ Error: Uso: gx auto [--config archivo] [--stdin]\033[0m\n");
+                return 1;
+            }
+        }
+        static AutoConfig config;
+        if (auto_cargar_config(config_path, &config) != 0) return 1;
+        return auto_ejecutar(&config, desde_stdin);
+    }
+    
+    // Verificar si se pasó el comando record
+    if (argc > 1 && strcmp(argv[1], "record") == 0) {
+        int hz = WATCH_HZ_DEFECTO;
+        double duracion = 0;
+        const char* destino = NULL;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+                hz = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+                duracion = atof(argv[++i]);
+            } else if (!destino && argv[i][0] != '-') {
+                destino = argv[i];
+            } else {
+                destino = NULL;
+                break;
+            }
+        }
+        if (!destino) {
+            printf("\033[31m❌ Error: Uso: gx record archivo.glxr [--hz 1-%d] [--duration S]\033[0m\n", WATCH_HZ_MAX);
+            return 1;
+        }
+        if (hz < 1 || hz > WATCH_HZ_MAX) {
+            printf("\033[31m❌ Error: --hz debe estar entre 1 y %d\033[0m\n", WATCH_HZ_MAX);
+            return 1;
+        }
+        return record_grabar(destino, hz, duracion);
+    }
+    
+    // Verificar si se pasó el comando replay o export
+    if (argc > 1 && (strcmp(argv[1], "replay") == 0 || strcmp(argv[1], "export") == 0)) {
+        RecordFormato formato = strcmp(argv[1], "replay") == 0 ? RECORD_FORMATO_TABLA : RECORD_FORMATO_CSV;
+        long long desde_ms = 0, hasta_ms = -1;
+        const char* origen = NULL;
+        int valido = 1;
+        for (int i = 2; i < argc && valido; i++) {
+            if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+                desde_ms = (long long)(atof(argv[++i]) * 1000);
+            } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+                hasta_ms = (long long)(atof(argv[++i]) * 1000);
+            } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+                i++;
+                if (strcmp(argv[i], "csv") == 0) formato = RECORD_FORMATO_CSV;
+                else if (strcmp(argv[i], "json") == 0) formato = RECORD_FORMATO_JSON;
+                else valido = 0;
+            } else if (!origen && argv[i][0] != '-') {
+                origen = argv[i];
+            } else {
+                valido = 0;
+            }
+        }
+        if (!origen || !valido) {
+            printf("\033[31m❌ Error: Uso: gx %s archivo.glxr [--format csv|json] [--from S] [--to S]\033[0m\n", argv[1]);
+            return 1;
+        }
+        return record_exportar(origen, formato, desde_ms, hasta_ms);
+    }
+    
+    // Verificar si se pasó el comando modes compile
+    if (argc > 1 && strcmp(argv[1], "modes") == 0) {
+        if (argc < 3 || strcmp(argv[2], "compile") != 0) {
+            printf("\033[31m❌ Error: Uso: gx modes compile [modelo.txt]\033[0m\n");
+            return 1;
         }
         
-        // Obtener información de parámetros del sistema
-        char* cpu_max = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/max_perf_pct 2>/dev/null");
-        char* cpu_min = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/min_perf_pct 2>/dev/null");
-        char* dynamic_boost = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/hwp_dynamic_boost 2>/dev/null");
-        char* turbo_boost = execute_system_command("cat /sys/devices/system/cpu/intel_pstate/no_turbo 2>/dev/null");
-        char* battery_status = execute_system_command("cat /sys/class/power_supply/AC/online 2>/dev/null");
-        
-        if (cpu_max && cpu_min && dynamic_boost && turbo_boost && battery_status) {
-            // Eliminar saltos de línea de todos los valores
-            size_t len;
-            if ((len = strlen(cpu_max)) > 0 && cpu_max[len-1] == '\n') cpu_max[len-1] = '\0';
-            if ((len = strlen(cpu_min)) > 0 && cpu_min[len-1] == '\n') cpu_min[len-1] = '\0';
-            if ((len = strlen(dynamic_boost)) > 0 && dynamic_boost[len-1] == '\n') dynamic_boost[len-1] = '\0';
-            if ((len = strlen(turbo_boost)) > 0 && turbo_boost[len-1] == '\n') turbo_boost[len-1] = '\0';
-            if ((len = strlen(battery_status)) > 0 && battery_status[len-1] == '\n') battery_status[len-1] = '\0';
-            
-            printf("   CPU Max Performance: %s%%\n", cpu_max);
-            printf("   CPU Min Performance: %s%%\n", cpu_min);
-            printf("   Dynamic Boost: %s\n", strcmp(dynamic_boost, "1") == 0 ? "ON" : "OFF");
-            printf("   Turbo Boost: %s\n", strcmp(turbo_boost, "1") == 0 ? "OFF" : "ON");
-            printf("   Estado de batería: %s\n", strcmp(battery_status, "1") == 0 ? "Enchufada" : "Con batería");
-            printf("   Color del botón de encendido: %s\n", get_current_power_button_color());
-            
-            free(cpu_max);
-            free(cpu_min);
-            free(dynamic_boost);
-            free(turbo_boost);
-            free(battery_status);
-        } else {
-            printf("   Advertencia: CPU/Sistema: No se pudo obtener información completa\033[0m\n");
-            if (cpu_max) free(cpu_max);
-            if (cpu_min) free(cpu_min);
-            if (dynamic_boost) free(dynamic_boost);
-            if (turbo_boost) free(turbo_boost);
-            if (battery_status) free(battery_status);
+        char modelo_path[512];
+        if (argc > 3) {
+            snprintf(modelo_path, sizeof(modelo_path), "%s", argv[3]);
+        } else if (!find_modelo_path(modelo_path, sizeof(modelo_path))) {
+            printf("\033[31m❌ Error: No se encontró modelo.txt\033[0m\n");
+            return 1;
         }
         
+        char ruta_cache[512];
+        int num_modos = mode_cache_compilar(modelo_path, ruta_cache, sizeof(ruta_cache));
+        if (num_modos < 0) {
+            printf("\033[31m❌ Error: No se pudo compilar %s\033[0m\n", modelo_path);
+            return 1;
+        }
+        printf("\033[36m✅ %d modos compilados desde %s\n   Caché: %s\033[0m\n", num_modos, modelo_path, ruta_cache);
         return 0;
     }
     
@@ -163,70 +293,119 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        salida_buffer_completo();
+        
         // Crear un comando temporal para procesar
         char temp_command[256];
         snprintf(temp_command, sizeof(temp_command), "run %s", argv[2]);
         
         // Tokenizar el comando
+        Arena arena;
+        arena_init(&arena);
         int cantidad_tokens = 0;
-        char** tokens = lexer_tokenize(temp_command, &cantidad_tokens);
+        Token* tokens = lexer_tokenize(temp_command, strlen(temp_command), &cantidad_tokens, &arena);
         
         // Parsear y ejecutar
-        ASTNode* ast = parser_parse(tokens, cantidad_tokens);
+        AST* ast = parser_parse(tokens, cantidad_tokens, &arena);
         interpret_ast(ast);
         
-        // Limpieza
-        parser_free_ast(ast);
+        // Limpieza: el AST y los textos se liberan con la arena
         liberar_tokens(tokens, cantidad_tokens);
+        arena_liberar(&arena);
         
         return 0;
     }
     
+    salida_buffer_completo();
     if (argc > 1) {
         nombre_archivo = argv[1];
     } else {
-        printf("[INFO] No se especificó archivo .gx, usando por defecto: %s\n", nombre_archivo);
+        salida_printf("[INFO] No se especificó archivo .gx, usando por defecto: %s\n", nombre_archivo);
     }
 
-    archivo = fopen(nombre_archivo, "r");
-    if (archivo == NULL) {
+    // Con un .gxc válido no hace falta tokenizar ni parsear (salvo que se
+    // pidan los tokens o el AST)
+    GxcPrograma programa;
+    if (!salida_muestra(SALIDA_DEBUG_TOKENS) && gxc_abrir(nombre_archivo, &programa) == 0) {
+        char ruta_gxc[1024];
+        gxc_ruta(nombre_archivo, ruta_gxc, sizeof(ruta_gxc));
+        salida_printf("[INFO] Usando bytecode compilado: %s\n", ruta_gxc);
+        salida_printf("\nEjecutando %s:\n", nombre_archivo);
+        interpret_set_fuente(nombre_archivo);
+        gxc_ejecutar(&programa);
+        gxc_cerrar(&programa);
+        return 0;
+    }
+
+    // Mapear el archivo completo: se tokeniza de una pasada y se arma un solo programa
+    int fd = open(nombre_archivo, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
         perror("No se pudo abrir el archivo");
+        if (fd >= 0) close(fd);
         return 1;
     }
-
-    while (fgets(linea, sizeof(linea), archivo)) {
-        // Ignorar líneas vacías y comentarios
-        char* ptr = linea;
-        while (*ptr == ' ' || *ptr == '\t') ptr++;
-        if (*ptr == '#' || *ptr == '\0' || *ptr == '\n') {
-            continue;
+    size_t tamano = st.st_size;
+    const char* contenido = "";
+    void* mapa = NULL;
+    if (tamano > 0) {
+        mapa = mmap(NULL, tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa == MAP_FAILED) {
+            perror("No se pudo leer el archivo");
+            close(fd);
+            return 1;
         }
+        contenido = mapa;
+    }
+    close(fd);
 
-        printf("\nProcesando línea: %s", linea);
-
-        // Fase 1: Lexer
-        int cantidad_tokens = 0;
-        char** tokens = lexer_tokenize(linea, &cantidad_tokens);
+    // Fase 1: Lexer
+    Arena arena;
+    arena_init(&arena);
+    int cantidad_tokens = 0;
+    Token* tokens = lexer_tokenize(contenido, tamano, &cantidad_tokens, &arena);
 
+    if (salida_muestra(SALIDA_DEBUG_TOKENS)) {
         printf("Tokens encontrados:\n");
         for (int i = 0; i < cantidad_tokens; i++) {
-            printf("  Token[%d]: %s\n", i, tokens[i]);
+            if (tokens[i].tipo == TOKEN_FIN_LINEA) continue;
+            printf("  Token[%d] (%d:%d): %s\n", i, tokens[i].linea, tokens[i].columna, tokens[i].texto);
         }
+    }
 
-        // Fase 2: Parser
+    // Fase 2: Parser
+    AST* ast = parser_parse(tokens, cantidad_tokens, &arena);
+    if (salida_muestra(SALIDA_DEBUG_AST)) {
         printf("\nÁrbol de sintaxis abstracta (AST):\n");
-        ASTNode* ast = parser_parse(tokens, cantidad_tokens);
-        print_ast(ast, 0);
-
-        // Fase 3: Interpreter
-        printf("\nEjecutando comando:\n");
-        interpret_ast(ast);
+        print_ast(ast, ast_raiz(ast), 0);
+    }
 
-        // Limpieza
-        parser_free_ast(ast);
+    // Fase 3: Optimizar; los errores que abortarían a mitad de camino se
+    // reportan antes de tocar el hardware
+    OptInforme informe;
+    if (optimizar_ast(ast, &arena, nombre_archivo, &informe) != 0) {
+        salida_error("\033[31m⛔ %d error(es) en %s. Ejecución abortada antes de aplicar cambios.\033[0m\n", informe.errores, nombre_archivo);
         liberar_tokens(tokens, cantidad_tokens);
+        arena_liberar(&arena);
+        if (mapa) munmap(mapa, tamano);
+        return 1;
+    }
+    if (salida_muestra(SALIDA_DEBUG_AST)) {
+        printf("\nOptimizador: %d variables reemplazadas por constantes, %d declaraciones redundantes eliminadas\n",
+               informe.constantes, informe.eliminadas);
+        print_ast(ast, ast_raiz(ast), 0);
     }
 
-    fclose(archivo);
+    // Fase 4: Compilar a bytecode (y guardarlo para la próxima ejecución)
+    gxc_compilar(ast, nombre_archivo, &programa);
+    liberar_tokens(tokens, cantidad_tokens);
+    arena_liberar(&arena);
+    if (mapa) munmap(mapa, tamano);
+
+    // Fase 5: Ejecutar
+    salida_printf("\nEjecutando %s:\n", nombre_archivo);
+    interpret_set_fuente(nombre_archivo);
+    gxc_ejecutar(&programa);
+    gxc_cerrar(&programa);
     return 0;
 }
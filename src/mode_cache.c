@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/mode_cache.h"
+
+uint64_t fnv1a64(const void* datos, size_t len) {
+    const unsigned char* p = datos;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Directorio de la caché: $XDG_CACHE_HOME/glx o ~/.cache/glx
+static int directorio_cache(char* buffer, size_t size) {
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) {
+        snprintf(buffer, size, "%s/glx", xdg);
+        return 1;
+    }
+    const char* home = getenv("HOME");
+    if (home && *home) {
+        snprintf(buffer, size, "%s/.cache/glx", home);
+        return 1;
+    }
+    return 0;
+}
+
+// Una caché por archivo fuente: el nombre lleva el hash de la ruta
+static int ruta_cache(const char* fuente, char* buffer, size_t size) {
+    char dir[400];
+    if (!directorio_cache(dir, sizeof(dir))) return 0;
+
+    char absoluta[4096];
+    const char* clave = realpath(fuente, absoluta) ? absoluta : fuente;
+    snprintf(buffer, size, "%s/modos-%016llx.bin", dir, (unsigned long long)fnv1a64(clave, strlen(clave)));
+    return 1;
+}
+
+// Crear el directorio (y el padre ~/.cache si hace falta)
+static void crear_directorio(const char* ruta_archivo) {
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", ruta_archivo);
+    for (char* p = dir + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(dir, 0755);
+            *p = '/';
+        }
+    }
+}
+
+int cache_hash_archivo(const char* fuente, uint64_t* hash) {
+    int fd = open(fuente, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    char* datos = malloc(st.st_size > 0 ? st.st_size : 1);
+    ssize_t leidos = read(fd, datos, st.st_size);
+    close(fd);
+    if (leidos != st.st_size) {
+        free(datos);
+        return -1;
+    }
+
+    *hash = fnv1a64(datos, st.st_size);
+    free(datos);
+    return 0;
+}
+
+int64_t cache_mtime_ns(const struct stat* st) {
+    return (int64_t)st->st_mtim.tv_sec * 1000000000ll + st->st_mtim.tv_nsec;
+}
+
+int mode_cache_compilar(const char* fuente, char* destino, size_t size) {
+    char ruta[512];
+    if (!ruta_cache(fuente, ruta, sizeof(ruta))) return -1;
+    if (destino) snprintf(destino, size, "%s", ruta);
+
+    struct stat st;
+    if (stat(fuente, &st) != 0) return -1;
+
+    ModeCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MODE_CACHE_MAGIC;
+    header.version = MODE_CACHE_VERSION;
+    header.tam_modo = sizeof(GPU_Mode);
+    header.fuente_mtime_ns = cache_mtime_ns(&st);
+    header.fuente_tamano = st.st_size;
+    if (cache_hash_archivo(fuente, &header.fuente_hash) != 0) return -1;
+
+    int num_modos = 0;
+    GPU_Mode* modos = load_gpu_modes_ex(fuente, &num_modos, 0);
+    if (!modos) return -1;
+    header.num_modos = num_modos;
+
+    // Escribir en un temporal y renombrar: un lector nunca ve una caché a medias
+    crear_directorio(ruta);
+    char temporal[520];
+    snprintf(temporal, sizeof(temporal), "%s.%d", ruta, (int)getpid());
+    FILE* archivo = fopen(temporal, "wb");
+    if (!archivo) {
+        free(modos);
+        return -1;
+    }
+
+    int ok = fwrite(&header, sizeof(header), 1, archivo) == 1 &&
+             (num_modos == 0 || fwrite(modos, sizeof(GPU_Mode), num_modos, archivo) == (size_t)num_modos);
+    ok = (fclose(archivo) == 0) && ok;
+    free(modos);
+
+    if (!ok || rename(temporal, ruta) != 0) {
+        unlink(temporal);
+        return -1;
+    }
+    return num_modos;
+}
+
+// Mapear la caché y verificar que corresponde a esta fuente y esta versión de gx
+static int mapear(const char* ruta, const char* fuente, const struct stat* st_fuente, ModeCache* cache) {
+    int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ModeCacheHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    void* mapa = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) return -1;
+
+    const ModeCacheHeader* header = mapa;
+    int valida = header->magic == MODE_CACHE_MAGIC &&
+                 header->version == MODE_CACHE_VERSION &&
+                 header->tam_modo == sizeof(GPU_Mode) &&
+                 (size_t)st.st_size == sizeof(ModeCacheHeader) + (size_t)header->num_modos * sizeof(GPU_Mode) &&
+                 header->fuente_tamano == st_fuente->st_size;
+
+    // Mismo tamaño pero otro mtime (por ejemplo tras un "touch" o una copia):
+    // la caché sigue sirviendo si el contenido no cambió
+    if (valida && header->fuente_mtime_ns != cache_mtime_ns(st_fuente)) {
+        uint64_t hash;
+        valida = cache_hash_archivo(fuente, &hash) == 0 && hash == header->fuente_hash;
+    }
+
+    if (!valida) {
+        munmap(mapa, st.st_size);
+        return -1;
+    }
+
+    cache->mapa = mapa;
+    cache->tamano = st.st_size;
+    cache->modos = (const GPU_Mode*)((const char*)mapa + sizeof(ModeCacheHeader));
+    cache->num_modos = header->num_modos;
+    return 0;
+}
+
+int mode_cache_abrir(const char* fuente, ModeCache* cache) {
+    memset(cache, 0, sizeof(*cache));
+
+    char ruta[512];
+    struct stat st;
+    if (!ruta_cache(fuente, ruta, sizeof(ruta)) || stat(fuente, &st) != 0) return -1;
+
+    if (mapear(ruta, fuente, &st, cache) == 0) return 0;
+
+    // Falta o quedó vieja: recompilar y volver a mapear
+    if (mode_cache_compilar(fuente, NULL, 0) < 0) return -1;
+    return mapear(ruta, fuente, &st, cache);
+}
+
+const GPU_Mode* mode_cache_buscar(const ModeCache* cache, const char* nombre) {
+    for (int i = 0; i < cache->num_modos; i++) {
+        if (strcmp(cache->modos[i].name, nombre) == 0) {
+            return &cache->modos[i];
+        }
+    }
+    return NULL;
+}
+
+void mode_cache_cerrar(ModeCache* cache) {
+    if (cache->mapa) {
+        munmap(cache->mapa, cache->tamano);
+    }
+    memset(cache, 0, sizeof(*cache));
+}
+
+int mode_cache_vigente(const ModeCache* cache, const char* fuente) {
+    struct stat st;
+    if (!cache->mapa || stat(fuente, &st) != 0) return 0;
+    const ModeCacheHeader* header = cache->mapa;
+    return header->fuente_mtime_ns == cache_mtime_ns(&st) && header->fuente_tamano == st.st_size;
+}
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "../include/optimizador.h"
+#include "../include/params.h"
+#include "../include/symtab.h"
+#include "../include/salida.h"
+#include "../include/utils.h"
+#include "../include/sensores.h"
+
+typedef struct {
+    const AST* ast;
+    Arena* arena;
+    const char* archivo;
+    SymTab simbolos;
+    OptInforme* informe;
+    uint32_t ultima[PARAM_COUNT];   // Sentencia + 1 de la última declaración válida
+    uint8_t* eliminar;              // Una marca por sentencia del programa
+} Optimizador;
+
+// Error fatal ubicado en la sentencia que lo produce
+static void error_estatico(Optimizador* opt, const ASTNode* sentencia, const char* formato, ...) {
+    char mensaje[512];
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(mensaje, sizeof(mensaje), formato, args);
+    va_end(args);
+
+    salida_ubicacion(opt->archivo, sentencia->linea, sentencia->columna);
+    if (opt->archivo && sentencia->linea > 0) {
+        salida_error("\033[31m%s:%d:%d: ⛔ Error crítico: %s\033[0m\n", opt->archivo, sentencia->linea, sentencia->columna, mensaje);
+    } else {
+        salida_error("\033[31m⛔ Error crítico: %s\033[0m\n", mensaje);
+    }
+    opt->informe->errores++;
+}
+
+// Reemplazar un identificador por el valor constante de su variable; una
+// variable ligada a un sensor no es constante: se reemplaza por el sensor
+static void propagar(Optimizador* opt, ASTNode* valor, const Simbolo* var) {
+    if (var->sensor) {
+        const char* nombre = sensor_nombre(var->sensor - 1);
+        valor->type = NODE_SENSOR;
+        valor->value = arena_strndup(opt->arena, nombre, strlen(nombre));
+    } else {
+        valor->type = var->tipo == SYM_NUMERO ? NODE_NUMBER : NODE_STRING;
+        valor->value = arena_strndup(opt->arena, var->texto, strlen(var->texto));
+    }
+    opt->informe->constantes++;
+}
+
+// Un sensor desconocido aborta en ejecución; se reporta antes
+// Retorna el índice del sensor o -1
+static int validar_sensor(Optimizador* opt, const ASTNode* sentencia, const ASTNode* valor) {
+    int id = sensor_buscar(valor->value);
+    if (id < 0) {
+        const char* sugerido = sugerir_palabra(valor->value, sensores_validos, num_sensores, 2);
+        if (sugerido) error_estatico(opt, sentencia, "Sensor desconocido: %s (¿quisiste decir %s?).", valor->value, sugerido);
+        else error_estatico(opt, sentencia, "Sensor desconocido: %s.", valor->value);
+    }
+    return id;
+}
+
+// Un corte: lo declarado antes ya no se puede fusionar con lo que sigue
+static void cortar(Optimizador* opt) {
+    memset(opt->ultima, 0, sizeof(opt->ultima));
+}
+
+// Registrar una declaración válida; la anterior del mismo parámetro queda muerta
+static void declarar(Optimizador* opt, int ranura, uint32_t indice) {
+    if (opt->ultima[ranura]) {
+        opt->eliminar[opt->ultima[ranura] - 1] = 1;
+        opt->informe->eliminadas++;
+    }
+    opt->ultima[ranura] = indice + 1;
+}
+
+static void analizar_asignacion(Optimizador* opt, ASTNode* sentencia) {
+    if (sentencia->num_children == 0) return;
+    ASTNode* valor = ast_hijo(opt->ast, sentencia, 0);
+
+    if (valor->type == NODE_IDENTIFIER) {
+        Simbolo* origen = symtab_buscar(&opt->simbolos, valor->value);
+        if (!origen) {
+            error_estatico(opt, sentencia, "La variable '%s' no está definida.", valor->value);
+            return;
+        }
+        propagar(opt, valor, origen);
+    }
+
+    int sensor = -1;
+    if (valor->type == NODE_SENSOR && (sensor = validar_sensor(opt, sentencia, valor)) < 0) return;
+
+    int es_numero = sensor >= 0 ? sensor_es_numero(sensor) : valor->type == NODE_NUMBER;
+    Simbolo* var = symtab_buscar(&opt->simbolos, sentencia->value);
+    if (var && (var->tipo == SYM_NUMERO) != es_numero) {
+        error_estatico(opt, sentencia, "Conflicto de tipos al asignar a la variable '%s'. %s", sentencia->value,
+                       var->tipo == SYM_NUMERO ? "La variable fue definida como número y se intenta asignar texto."
+                                               : "La variable fue definida como texto y se intenta asignar un número.");
+        return;
+    }
+    if (!var) var = symtab_definir(&opt->simbolos, sentencia->value);
+    if (sensor >= 0) symtab_ligar_sensor(var, sensor, es_numero ? SYM_NUMERO : SYM_TEXTO, valor->value);
+    else if (es_numero) symtab_asignar_numero(var, strtoll(valor->value, NULL, 10), valor->value);
+    else symtab_asignar_texto(var, valor->value);
+}
+
+static void analizar_declaracion(Optimizador* opt, ASTNode* sentencia, uint32_t indice) {
+    if (sentencia->num_children == 0) return;
+    ASTNode* valor = ast_hijo(opt->ast, sentencia, 0);
+
+    int id = param_buscar(sentencia->value);
+    if (id < 0) {
+        // Con una sugerencia el intérprete solo avisa; sin ella aborta
+        if (!sugerir_palabra(sentencia->value, parametros_validos, num_parametros, 2)) {
+            error_estatico(opt, sentencia, "Parámetro desconocido: %s.", sentencia->value);
+        }
+        return;
+    }
+    const ParamInfo* param = &param_tabla[id];
+
+    // mode/modo abren una sección ("mode: quiet" seguido de "- parametro: valor"):
+    // no se fusionan declaraciones de secciones distintas
+    if (param->tipo == PARAM_TIPO_MODO) {
+        cortar(opt);
+        return;
+    }
+
+    if (valor->type == NODE_IDENTIFIER) {
+        Simbolo* var = symtab_buscar(&opt->simbolos, valor->value);
+        if (var) {
+            propagar(opt, valor, var);
+        } else if (param->tipo == PARAM_TIPO_ENTERO) {
+            error_estatico(opt, sentencia, "La variable '%s' no está definida.", valor->value);
+            return;
+        }
+        // Un color sin variable es el nombre del color (rgb_color: red), y
+        // lo mismo una opción (cpu_epp_p: balance_power)
+    }
+
+    // El valor de un sensor recién se conoce al ejecutar, y leerlo es un
+    // efecto visible (depende de sensor_ttl_ms): corta la secuencia
+    if (valor->type == NODE_SENSOR) {
+        validar_sensor(opt, sentencia, valor);
+        cortar(opt);
+        return;
+    }
+
+    if (param->tipo == PARAM_TIPO_COLOR) {
+        if (rgb_color_to_profile(valor->value)) declarar(opt, id, indice);
+        return;
+    }
+    if (param->tipo == PARAM_TIPO_OPCION) {
+        if (param_opcion_buscar(param, valor->value) >= 0) declarar(opt, id, indice);
+        return;
+    }
+
+    // Entero: un texto es solo una advertencia en ejecución y no escribe nada
+    if (valor->type != NODE_NUMBER) return;
+    long long val = atoi(valor->value);
+    if (val < param->min || val > param->max) {
+        error_estatico(opt, sentencia, "'%s' fuera de rango (%d-%d). Valor recibido: %lld.", param->nombre, param->min, param->max, val);
+        return;
+    }
+    declarar(opt, id, indice);
+}
+
+static void analizar_run(Optimizador* opt, ASTNode* sentencia) {
+    cortar(opt);
+    if (sentencia->num_children == 0) return;
+    ASTNode* valor = ast_hijo(opt->ast, sentencia, 0);
+
+    // Un identificador que no es variable es el nombre del modo
+    if (valor->type == NODE_IDENTIFIER) {
+        Simbolo* var = symtab_buscar(&opt->simbolos, valor->value);
+        if (var) propagar(opt, valor, var);
+    }
+    if (valor->type == NODE_SENSOR) validar_sensor(opt, sentencia, valor);
+}
+
+// Comandos que no leen ni cambian el estado del hardware
+static int comando_neutro(const char* comando) {
+    static const char* neutros[] = { "#", "-", "vars", "help", "hola", "mundo" };
+    for (size_t i = 0; i < sizeof(neutros) / sizeof(neutros[0]); i++) {
+        if (strcmp(comando, neutros[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+int optimizar_ast(AST* ast, Arena* arena, const char* archivo, OptInforme* informe) {
+    memset(informe, 0, sizeof(*informe));
+    ASTNode* programa = ast_raiz(ast);
+    if (!programa || programa->num_children == 0) return 0;
+
+    Optimizador opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.ast = ast;
+    opt.arena = arena;
+    opt.archivo = archivo;
+    opt.informe = informe;
+    opt.eliminar = calloc(programa->num_children, 1);
+
+    for (int i = 0; i < programa->num_children; i++) {
+        ASTNode* sentencia = ast_hijo(ast, programa, i);
+        switch (sentencia->type) {
+            case NODE_ASSIGNMENT:
+                analizar_asignacion(&opt, sentencia);
+                break;
+            case NODE_DECLARATION:
+                analizar_declaracion(&opt, sentencia, i);
+                break;
+            case NODE_RUN_COMMAND:
+                analizar_run(&opt, sentencia);
+                break;
+            case NODE_GPU_COMMAND:
+                if (!sentencia->value || !comando_neutro(sentencia->value)) cortar(&opt);
+                break;
+            default:
+                break;
+        }
+    }
+    salida_ubicacion(NULL, 0, 0);
+
+    // Compactar los hijos del programa sin las declaraciones muertas
+    if (informe->errores == 0 && informe->eliminadas > 0) {
+        NodeId* hijos = &ast->hijos[programa->primer_hijo];
+        int quedan = 0;
+        for (int i = 0; i < programa->num_children; i++) {
+            if (!opt.eliminar[i]) hijos[quedan++] = hijos[i];
+        }
+        programa->num_children = quedan;
+    }
+
+    free(opt.eliminar);
+    symtab_liberar(&opt.simbolos);
+    return informe->errores == 0 ? 0 : -1;
+}
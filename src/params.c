@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <string.h>
+#include "../include/params.h"
+#include "../include/knobs.h"
+#include "params_hash.h"
+
+const ParamInfo param_tabla[PARAM_COUNT] = {
+#define PARAM(nombre, tipo, min, max, formato, etiqueta, knob) \
+    [PARAM_##nombre] = { #nombre, PARAM_TIPO_##tipo, min, max, PARAM_FMT_##formato, etiqueta, knob },
+#include "../include/params.def"
+#undef PARAM
+};
+
+// Valores que acepta el kernel en energy_performance_preference y
+// scaling_governor; cada policy puede ofrecer solo una parte
+static const char* opciones_epp[] = {
+    "default", "performance", "balance_performance", "balance_power", "power"
+};
+static const char* opciones_gobernador[] = {
+    "performance", "powersave", "schedutil", "ondemand", "conservative", "userspace"
+};
+
+int param_buscar(const char* nombre) {
+    uint32_t slot = param_hash(nombre, PARAM_HASH_SEMILLA) & PARAM_HASH_MASCARA;
+    int id = param_hash_slots[slot];
+    if (id < 0 || strcmp(param_tabla[id].nombre, nombre) != 0) return -1;
+    return id;
+}
+
+uint64_t param_tabla_huella(void) {
+    return PARAM_TABLA_HUELLA;
+}
+
+const char* param_formatear(const ParamInfo* param, int valor, char* buffer, size_t size) {
+    switch (param->formato) {
+        case PARAM_FMT_PORCENTAJE:
+            snprintf(buffer, size, "%d%%", valor);
+            break;
+        case PARAM_FMT_ON_OFF:
+            snprintf(buffer, size, "%s", valor ? "ON" : "OFF");
+            break;
+        case PARAM_FMT_OFF_ON:
+            snprintf(buffer, size, "%s", valor ? "OFF" : "ON");
+            break;
+        case PARAM_FMT_MHZ:
+            snprintf(buffer, size, "%d MHz", valor);
+            break;
+        case PARAM_FMT_EPP:
+        case PARAM_FMT_GOBERNADOR: {
+            int cantidad;
+            const char** opciones = param_opciones(param, &cantidad);
+            snprintf(buffer, size, "%s", valor >= 0 && valor < cantidad ? opciones[valor] : "?");
+            break;
+        }
+        default:
+            snprintf(buffer, size, "%d", valor);
+            break;
+    }
+    return buffer;
+}
+
+const char** param_opciones(const ParamInfo* param, int* cantidad) {
+    switch (param->formato) {
+        case PARAM_FMT_EPP:
+            *cantidad = sizeof(opciones_epp) / sizeof(opciones_epp[0]);
+            return opciones_epp;
+        case PARAM_FMT_GOBERNADOR:
+            *cantidad = sizeof(opciones_gobernador) / sizeof(opciones_gobernador[0]);
+            return opciones_gobernador;
+        default:
+            *cantidad = 0;
+            return NULL;
+    }
+}
+
+int param_opcion_buscar(const ParamInfo* param, const char* texto) {
+    int cantidad;
+    const char** opciones = param_opciones(param, &cantidad);
+    for (int i = 0; i < cantidad; i++) {
+        if (strcmp(opciones[i], texto) == 0) return i;
+    }
+    return -1;
+}
@@ -4,36 +4,56 @@
 #include <ctype.h>
 #include "../include/parser.h"
 
-// Crear un nuevo nodo del AST
-ASTNode* create_node(NodeType type, const char* value) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+// Crear un nuevo nodo del AST al final del array de nodos
+static NodeId create_node(Parser* parser, NodeType type, char* value, const Token* token) {
+    NodeId id = parser->ast->num_nodos++;
+    ASTNode* node = &parser->ast->nodos[id];
     node->type = type;
-    node->value = value ? strdup(value) : NULL;
-    node->children = NULL;
+    node->value = value;
+    node->primer_hijo = 0;
     node->num_children = 0;
-    return node;
+    node->linea = token ? token->linea : 0;
+    node->columna = token ? token->columna : 0;
+    return id;
+}
+
+// Apilar un hijo del nodo que se está construyendo
+static void push_child(Parser* parser, NodeId child) {
+    parser->pila[parser->tope++] = child;
+}
+
+// Cerrar un nodo: sus hijos son los apilados desde marca y pasan contiguos a AST.hijos
+static void close_node(Parser* parser, NodeId id, uint32_t marca) {
+    AST* ast = parser->ast;
+    ASTNode* node = &ast->nodos[id];
+    node->primer_hijo = ast->num_hijos;
+    node->num_children = parser->tope - marca;
+    memcpy(&ast->hijos[ast->num_hijos], &parser->pila[marca], node->num_children * sizeof(NodeId));
+    ast->num_hijos += node->num_children;
+    parser->tope = marca;
 }
 
-// Agregar un hijo a un nodo
-void add_child(ASTNode* parent, ASTNode* child) {
-    parent->children = realloc(parent->children, (parent->num_children + 1) * sizeof(ASTNode*));
-    parent->children[parent->num_children] = child;
-    parent->num_children++;
+ASTNode* ast_raiz(const AST* ast) {
+    return &ast->nodos[0];
 }
 
-// Inicializar el parser
-Parser* init_parser(char** tokens, int num_tokens) {
-    Parser* parser = (Parser*)malloc(sizeof(Parser));
-    parser->tokens = tokens;
-    parser->num_tokens = num_tokens;
-    parser->current_pos = 0;
-    return parser;
+ASTNode* ast_hijo(const AST* ast, const ASTNode* node, int i) {
+    if (i < 0 || i >= node->num_children) return NULL;
+    return &ast->nodos[ast->hijos[node->primer_hijo + i]];
 }
 
-// Obtener el token actual
+// Obtener el texto del token actual; NULL al final de la sentencia
 char* current_token(Parser* parser) {
     if (parser->current_pos >= parser->num_tokens) return NULL;
-    return parser->tokens[parser->current_pos];
+    if (parser->tokens[parser->current_pos].tipo == TOKEN_FIN_LINEA) return NULL;
+    return parser->tokens[parser->current_pos].texto;
+}
+
+// Token siguiente al actual dentro de la misma sentencia
+static char* peek_token(Parser* parser) {
+    int pos = parser->current_pos + 1;
+    if (pos >= parser->num_tokens || parser->tokens[pos].tipo == TOKEN_FIN_LINEA) return NULL;
+    return parser->tokens[pos].texto;
 }
 
 // Avanzar al siguiente token
@@ -41,6 +61,13 @@ void advance_token(Parser* parser) {
     parser->current_pos++;
 }
 
+// Saltar todos los tokens restantes en la línea
+static void skip_line(Parser* parser) {
+    while (current_token(parser)) {
+        parser->current_pos++;
+    }
+}
+
 // Verificar si un string es un número
 int is_number(const char* str) {
     if (!str || strlen(str) == 0) return 0;
@@ -61,166 +88,173 @@ int is_number(const char* str) {
 }
 
 // Crear un nodo del tipo correcto basado en el valor
-ASTNode* create_value_node(const char* value) {
+// Números e identificadores usan el texto del token tal cual (ya está en la arena)
+static NodeId create_value_node(Parser* parser, const Token* token) {
+    char* value = token->texto;
+    size_t len = strlen(value);
     if (is_number(value)) {
-        return create_node(NODE_NUMBER, value);
-    } else if (value && value[0] == '"' && value[strlen(value)-1] == '"' && strlen(value) >= 2) {
-        // Si empieza y termina con comillas dobles, es un string
-        // Crear el string sin las comillas
-        size_t len = strlen(value);
-        if (len >= 2) {
-            char* sin_comillas = (char*)malloc(len - 1);
-            if (sin_comillas) {
-                strncpy(sin_comillas, value + 1, len - 2);
-                sin_comillas[len - 2] = '\0';
-                ASTNode* node = create_node(NODE_STRING, sin_comillas);
-                free(sin_comillas);
-                return node;
-            }
-        }
-        // Si falla malloc o len < 2, tratar como identificador
-        return create_node(NODE_IDENTIFIER, value);
+        return create_node(parser, NODE_NUMBER, value, token);
+    } else if (len >= 2 && value[0] == '"' && value[len-1] == '"') {
+        // Si empieza y termina con comillas dobles, es un string sin las comillas
+        return create_node(parser, NODE_STRING, arena_strndup(parser->arena, value + 1, len - 2), token);
     } else {
         // Si no es número ni string, es un identificador (variable)
-        return create_node(NODE_IDENTIFIER, value);
+        return create_node(parser, NODE_IDENTIFIER, value, token);
+    }
+}
+
+// "sensor:nombre" en lugar de un valor: consume los tres tokens
+// Retorna 0 si el token actual no empieza un sensor
+static int parse_sensor(Parser* parser) {
+    char* token = current_token(parser);
+    char* separador = peek_token(parser);
+    if (!token || strcmp(token, "sensor") != 0 || !separador || strcmp(separador, ":") != 0) return 0;
+    const Token* tok = &parser->tokens[parser->current_pos];
+    advance_token(parser); // Consumir "sensor"
+    advance_token(parser); // Consumir ":"
+    if (current_token(parser)) {
+        push_child(parser, create_node(parser, NODE_SENSOR, current_token(parser), tok));
+        advance_token(parser);
+    } else {
+        fprintf(stderr, "\033[33mAdvertencia: línea %d, columna %d: falta el nombre después de 'sensor:'\033[0m\n",
+               tok->linea, tok->columna);
+    }
+    return 1;
+}
+
+// Leer el valor de una declaración o asignación; avisar si falta
+static void parse_value(Parser* parser, NodeId id, const char* separador) {
+    if (parse_sensor(parser)) return;
+    if (current_token(parser)) {
+        push_child(parser, create_value_node(parser, &parser->tokens[parser->current_pos]));
+        advance_token(parser);
+    } else {
+        ASTNode* node = &parser->ast->nodos[id];
+        fprintf(stderr, "\033[33mAdvertencia: línea %d, columna %d: falta el valor después de '%s' en '%s'\033[0m\n",
+               node->linea, node->columna, separador, node->value);
     }
 }
 
 // Parsear una declaración o asignación
-ASTNode* parse_statement(Parser* parser) {
+// Retorna el nodo de la sentencia o -1 si la línea no produce nodo
+static long parse_statement(Parser* parser) {
     char* token = current_token(parser);
-    if (!token) return NULL;
+    if (!token) return -1;
+    const Token* tok = &parser->tokens[parser->current_pos];
+    uint32_t marca = parser->tope;
 
     // Ignorar comentarios (líneas que empiecen con #)
     if (strcmp(token, "#") == 0) {
-        // Saltar toda la línea (todos los tokens restantes)
-        while (parser->current_pos < parser->num_tokens) {
-            advance_token(parser);
-        }
-        return NULL; // No crear nodo para comentarios
+        skip_line(parser);
+        return -1; // No crear nodo para comentarios
     }
 
     // Verificar si es una declaración (token seguido de ":")
-    char* next_token = (parser->current_pos + 1 < parser->num_tokens) ? 
-                      parser->tokens[parser->current_pos + 1] : NULL;
+    char* next_token = peek_token(parser);
     
     if (next_token && strcmp(next_token, ":") == 0) {
         // Es una declaración
-        ASTNode* node = create_node(NODE_DECLARATION, token);
+        NodeId node = create_node(parser, NODE_DECLARATION, token, tok);
         advance_token(parser); // Consumir identificador
         advance_token(parser); // Consumir ":"
-        
-        if (parser->current_pos < parser->num_tokens) {
-            char* value = parser->tokens[parser->current_pos];
-            ASTNode* value_node = create_value_node(value);
-            add_child(node, value_node);
-            advance_token(parser);
-        }
+        parse_value(parser, node, ":");
+        close_node(parser, node, marca);
         return node;
     }
 
     // Verificar si es una asignación (token seguido de "=")
     if (next_token && strcmp(next_token, "=") == 0) {
         // Es una asignación de variable
-        ASTNode* node = create_node(NODE_ASSIGNMENT, token);
+        NodeId node = create_node(parser, NODE_ASSIGNMENT, token, tok);
         advance_token(parser); // Consumir nombre de variable
         advance_token(parser); // Consumir "="
-        
-        if (parser->current_pos < parser->num_tokens) {
-            char* value = parser->tokens[parser->current_pos];
-            ASTNode* value_node = create_value_node(value);
-            add_child(node, value_node);
-            advance_token(parser);
-        }
+        parse_value(parser, node, "=");
+        close_node(parser, node, marca);
         return node;
     }
 
     // Verificar si es un número
     if (is_number(token)) {
-        ASTNode* node = create_node(NODE_NUMBER, token);
+        NodeId node = create_node(parser, NODE_NUMBER, token, tok);
         advance_token(parser);
         return node;
     }
 
     // Verificar si es un comando "run mode:X"
     if (strcmp(token, "run") == 0) {
-        ASTNode* node = create_node(NODE_RUN_COMMAND, token);
+        NodeId node = create_node(parser, NODE_RUN_COMMAND, token, tok);
         advance_token(parser); // Consumir "run"
         
-        // Verificar que el siguiente token sea "mode"
-        if (parser->current_pos < parser->num_tokens) {
-            char* mode_token = parser->tokens[parser->current_pos];
-            if (strcmp(mode_token, "mode") == 0) {
-                advance_token(parser); // Consumir "mode"
-                
-                // Verificar que el siguiente token sea ":"
-                if (parser->current_pos < parser->num_tokens) {
-                    char* colon_token = parser->tokens[parser->current_pos];
-                    if (strcmp(colon_token, ":") == 0) {
-                        advance_token(parser); // Consumir ":"
-                        
-                        // Obtener el modo (quiet, balanced, performance)
-                        if (parser->current_pos < parser->num_tokens) {
-                            char* mode_value = parser->tokens[parser->current_pos];
-                            ASTNode* mode_node = create_node(NODE_IDENTIFIER, mode_value);
-                            add_child(node, mode_node);
-                            advance_token(parser);
-                        }
-                    }
-                }
+        // Verificar que sigan "mode" y ":"
+        char* mode_token = current_token(parser);
+        char* colon_token = peek_token(parser);
+        if (mode_token && strcmp(mode_token, "mode") == 0 && colon_token && strcmp(colon_token, ":") == 0) {
+            advance_token(parser); // Consumir "mode"
+            advance_token(parser); // Consumir ":"
+            
+            // Obtener el modo (quiet, balanced, performance)
+            if (parse_sensor(parser)) {
+                // run mode: sensor:platform_profile
+            } else if (current_token(parser)) {
+                const Token* mode_value = &parser->tokens[parser->current_pos];
+                push_child(parser, create_node(parser, NODE_IDENTIFIER, mode_value->texto, mode_value));
+                advance_token(parser);
             }
         }
-        
-        // Saltar todos los tokens restantes en la línea
-        while (parser->current_pos < parser->num_tokens) {
-            advance_token(parser);
+        if (parser->tope == marca) {
+            fprintf(stderr, "\033[33mAdvertencia: línea %d, columna %d: se esperaba 'run mode: <modo>'\033[0m\n",
+                   tok->linea, tok->columna);
         }
+        close_node(parser, node, marca);
         
+        skip_line(parser);
         return node;
     }
 
     // Por defecto, tratar como comando GPU
-    ASTNode* node = create_node(NODE_GPU_COMMAND, token);
+    NodeId node = create_node(parser, NODE_GPU_COMMAND, token, tok);
     advance_token(parser);
     
     // Para comandos GPU simples como status, reset, vars, help, ignorar tokens adicionales
     if (strcmp(token, "status") == 0 || strcmp(token, "reset") == 0 || 
         strcmp(token, "vars") == 0 || strcmp(token, "help") == 0) {
-        // Saltar todos los tokens restantes en la línea
-        while (parser->current_pos < parser->num_tokens) {
-            advance_token(parser);
-        }
+        skip_line(parser);
     }
     
     return node;
 }
 
 // Función principal de parsing
-ASTNode* parser_parse(char** tokens, int num_tokens) {
-    Parser* parser = init_parser(tokens, num_tokens);
-    ASTNode* root = create_node(NODE_PROGRAM, NULL);
-
-    // Parsear cada statement
-    while (parser->current_pos < parser->num_tokens) {
-        ASTNode* statement = parse_statement(parser);
-        if (statement) {
-            add_child(root, statement);
-        }
+AST* parser_parse(Token* tokens, int num_tokens, Arena* arena) {
+    // Cada nodo consume al menos un token de texto (salvo la raíz), así que
+    // el tamaño final se acota de antemano y no hace falta crecer nada
+    uint32_t max_nodos = 1;
+    for (int i = 0; i < num_tokens; i++) {
+        if (tokens[i].tipo == TOKEN_TEXTO) max_nodos++;
     }
+    AST* ast = arena_alloc(arena, sizeof(AST));
+    ast->nodos = arena_alloc(arena, max_nodos * sizeof(ASTNode));
+    ast->hijos = arena_alloc(arena, max_nodos * sizeof(NodeId));
+    ast->num_nodos = 0;
+    ast->num_hijos = 0;
 
-    free(parser);
-    return root;
-}
+    Parser parser = { tokens, num_tokens, 0, ast, arena, NULL, 0 };
+    parser.pila = arena_alloc(arena, max_nodos * sizeof(NodeId));
 
-// Liberar la memoria del AST
-void parser_free_ast(ASTNode* node) {
-    if (!node) return;
+    NodeId root = create_node(&parser, NODE_PROGRAM, NULL, NULL);
 
-    for (int i = 0; i < node->num_children; i++) {
-        parser_free_ast(node->children[i]);
+    // Parsear cada statement; los fines de línea solo separan sentencias
+    while (parser.current_pos < parser.num_tokens) {
+        if (parser.tokens[parser.current_pos].tipo == TOKEN_FIN_LINEA) {
+            advance_token(&parser);
+            continue;
+        }
+        long statement = parse_statement(&parser);
+        if (statement >= 0) {
+            push_child(&parser, (NodeId)statement);
+        }
     }
 
-    free(node->value);
-    free(node->children);
-    free(node);
+    close_node(&parser, root, 0);
+    return ast;
 }
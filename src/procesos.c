@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#include "../include/procesos.h"
+
+int procesos_conector_abrir(void) {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_CONNECTOR);
+    if (fd < 0) return -1;
+
+    struct sockaddr_nl direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.nl_family = AF_NETLINK;
+    direccion.nl_groups = CN_IDX_PROC;
+    if (bind(fd, (struct sockaddr*)&direccion, sizeof(direccion)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // Pedido de suscripción: nlmsghdr + cn_msg + PROC_CN_MCAST_LISTEN
+    union {
+        struct nlmsghdr alineado;
+        char bytes[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    } mensaje;
+    memset(&mensaje, 0, sizeof(mensaje));
+    struct nlmsghdr* nl = &mensaje.alineado;
+    struct cn_msg* cn = NLMSG_DATA(nl);
+    enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+    nl->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+    nl->nlmsg_type = NLMSG_DONE;
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(op);
+    memcpy(cn->data, &op, sizeof(op));
+
+    if (send(fd, nl, nl->nlmsg_len, 0) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int procesos_conector_leer(int fd, ProcesoCallback cb, void* ctx) {
+    union {
+        struct nlmsghdr alineado;
+        char bytes[8192];
+    } buffer;
+    int entregados = 0;
+    int perdidos = 0;
+
+    for (;;) {
+        // Solo se aceptan mensajes del kernel (nl_pid 0)
+        struct sockaddr_nl origen;
+        socklen_t largo_origen = sizeof(origen);
+        ssize_t n = recvfrom(fd, &buffer, sizeof(buffer), 0, (struct sockaddr*)&origen, &largo_origen);
+        if (n < 0 && errno == ENOBUFS) {
+            perdidos = 1;
+            continue;
+        }
+        if (n <= 0) break;
+        if (origen.nl_pid != 0) continue;
+
+        for (struct nlmsghdr* nl = &buffer.alineado; NLMSG_OK(nl, (size_t)n); nl = NLMSG_NEXT(nl, n)) {
+            if (nl->nlmsg_type == NLMSG_ERROR || nl->nlmsg_type == NLMSG_NOOP) continue;
+            struct cn_msg* cn = NLMSG_DATA(nl);
+            if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC) continue;
+            struct proc_event* ev = (struct proc_event*)cn->data;
+
+            ProcesoEvento evento;
+            if (ev->what == PROC_EVENT_EXEC) {
+                if (ev->event_data.exec.process_pid != ev->event_data.exec.process_tgid) continue;
+                evento.tipo = PROCESO_EXEC;
+                evento.pid = ev->event_data.exec.process_pid;
+            } else if (ev->what == PROC_EVENT_EXIT) {
+                if (ev->event_data.exit.process_pid != ev->event_data.exit.process_tgid) continue;
+                evento.tipo = PROCESO_EXIT;
+                evento.pid = ev->event_data.exit.process_pid;
+            } else {
+                continue;
+            }
+            cb(&evento, ctx);
+            entregados++;
+        }
+    }
+    return perdidos ? -1 : entregados;
+}
+
+static int comparar_pid(const void* a, const void* b) {
+    pid_t x = *(const pid_t*)a;
+    pid_t y = *(const pid_t*)b;
+    return (x > y) - (x < y);
+}
+
+int procesos_escanear(ProcesoEscaneo* escaneo, ProcesoCallback cb, void* ctx) {
+    DIR* dir = opendir("/proc");
+    if (!dir) return -1;
+
+    size_t cantidad = 0;
+    struct dirent* entrada;
+    while ((entrada = readdir(dir))) {
+        if (entrada->d_name[0] < '1' || entrada->d_name[0] > '9') continue;
+        if (cantidad == escaneo->capacidad) {
+            size_t nueva = escaneo->capacidad ? escaneo->capacidad * 2 : 512;
+            pid_t* actuales = realloc(escaneo->actuales, nueva * sizeof(pid_t));
+            pid_t* vistos = realloc(escaneo->vistos, nueva * sizeof(pid_t));
+            if (actuales) escaneo->actuales = actuales;
+            if (vistos) escaneo->vistos = vistos;
+            if (!actuales || !vistos) break;
+            escaneo->capacidad = nueva;
+        }
+        escaneo->actuales[cantidad++] = (pid_t)atoi(entrada->d_name);
+    }
+    closedir(dir);
+    qsort(escaneo->actuales, cantidad, sizeof(pid_t), comparar_pid);
+
+    // Las dos listas están ordenadas: una sola pasada encuentra altas y bajas
+    size_t i = 0;
+    size_t j = 0;
+    while (i < escaneo->num_vistos || j < cantidad) {
+        ProcesoEvento evento;
+        if (j == cantidad || (i < escaneo->num_vistos && escaneo->vistos[i] < escaneo->actuales[j])) {
+            evento.tipo = PROCESO_EXIT;
+            evento.pid = escaneo->vistos[i++];
+        } else if (i == escaneo->num_vistos || escaneo->actuales[j] < escaneo->vistos[i]) {
+            evento.tipo = PROCESO_EXEC;
+            evento.pid = escaneo->actuales[j++];
+        } else {
+            i++;
+            j++;
+            continue;
+        }
+        cb(&evento, ctx);
+    }
+
+    pid_t* anterior = escaneo->vistos;
+    escaneo->vistos = escaneo->actuales;
+    escaneo->actuales = anterior;
+    escaneo->num_vistos = cantidad;
+    return 0;
+}
+
+void procesos_escaneo_liberar(ProcesoEscaneo* escaneo) {
+    free(escaneo->vistos);
+    free(escaneo->actuales);
+    memset(escaneo, 0, sizeof(*escaneo));
+}
+
+int procesos_identificar(pid_t pid, char* comm, size_t comm_size, char* exe, size_t exe_size) {
+    char ruta[64];
+    snprintf(ruta, sizeof(ruta), "/proc/%d/comm", (int)pid);
+    int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = read(fd, comm, comm_size - 1);
+    close(fd);
+    if (n <= 0) return -1;
+    comm[n] = '\0';
+    comm[strcspn(comm, "\n")] = '\0';
+
+    snprintf(ruta, sizeof(ruta), "/proc/%d/exe", (int)pid);
+    n = readlink(ruta, exe, exe_size - 1);
+    exe[n > 0 ? n : 0] = '\0';
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/record.h"
+#include "../include/watch.h"
+
+// Nombre y escala de cada campo; el header los copia para que el archivo se describa solo
+static const RecordCampoInfo campos_info[RECORD_NUM_CAMPOS] = {
+    [RECORD_CAMPO_CPU_MAX_PERF] = { "cpu_max_perf", 1, 0 },
+    [RECORD_CAMPO_NO_TURBO] = { "no_turbo", 1, 0 },
+    [RECORD_CAMPO_AC_ONLINE] = { "ac_online", 1, 0 },
+    [RECORD_CAMPO_GPU_POTENCIA] = { "gpu_potencia_w", 100, 0 },
+    [RECORD_CAMPO_GPU_TEMPERATURA] = { "gpu_temp_c", 1, 0 },
+    [RECORD_CAMPO_GPU_RELOJ] = { "gpu_reloj_mhz", 1, 0 },
+};
+
+// Estado del codificador durante la grabación
+typedef struct {
+    FILE* archivo;
+    RecordBlock bloque;
+    int32_t ultimos[RECORD_NUM_CAMPOS];
+    long long ultimo_t_ms;
+    long bloques_escritos;
+} RecordEscritor;
+
+static int escribir_bloque(RecordEscritor* w) {
+    if (w->bloque.num_muestras == 0) return 0;
+    // Bloque completo aunque vaya incompleto: el tamaño fijo permite ubicar cualquier bloque
+    if (fwrite(&w->bloque, sizeof(w->bloque), 1, w->archivo) != 1 || fflush(w->archivo) != 0) {
+        return -1;
+    }
+    w->bloques_escritos++;
+    memset(&w->bloque, 0, sizeof(w->bloque));
+    return 0;
+}
+
+static void valores_muestra(const SystemStatus* status, const GpuSample* gpu, int32_t* valores) {
+    valores[RECORD_CAMPO_CPU_MAX_PERF] = status->cpu_max_perf;
+    valores[RECORD_CAMPO_NO_TURBO] = status->no_turbo;
+    valores[RECORD_CAMPO_AC_ONLINE] = status->ac_online;
+    valores[RECORD_CAMPO_GPU_POTENCIA] = gpu->valida && gpu->potencia_w >= 0 ? (int32_t)(gpu->potencia_w * 100 + 0.5) : -1;
+    valores[RECORD_CAMPO_GPU_TEMPERATURA] = gpu->valida ? gpu->temperatura_c : -1;
+    valores[RECORD_CAMPO_GPU_RELOJ] = gpu->valida ? gpu->reloj_mhz : -1;
+}
+
+static int grabar_muestra(long long t_ms, const SystemStatus* status, const GpuSample* gpu, void* ctx) {
+    RecordEscritor* w = ctx;
+    int32_t valores[RECORD_NUM_CAMPOS];
+    valores_muestra(status, gpu, valores);
+
+    // Si el delta no entra en 16 bits (o el bloque se llenó) se empieza un bloque nuevo
+    RecordBlock* b = &w->bloque;
+    if (b->num_muestras > 0) {
+        int cabe = b->num_muestras < RECORD_MUESTRAS_POR_BLOQUE && t_ms - w->ultimo_t_ms <= UINT16_MAX;
+        for (int i = 0; cabe && i < RECORD_NUM_CAMPOS; i++) {
+            int32_t delta = valores[i] - w->ultimos[i];
+            cabe = delta >= INT16_MIN && delta <= INT16_MAX;
+        }
+        if (!cabe && escribir_bloque(w) != 0) {
+            printf("\033[31m❌ Error: No se pudo escribir la grabación\033[0m\n");
+            return 1;
+        }
+    }
+
+    if (b->num_muestras == 0) {
+        b->magic = RECORD_BLOQUE_MAGIC;
+        b->t0_ms = t_ms;
+        memcpy(b->base, valores, sizeof(b->base));
+        // muestras[0] queda en cero: es la base misma
+    } else {
+        RecordMuestra* m = &b->muestras[b->num_muestras];
+        m->dt_ms = (uint16_t)(t_ms - w->ultimo_t_ms);
+        for (int i = 0; i < RECORD_NUM_CAMPOS; i++) {
+            m->delta[i] = (int16_t)(valores[i] - w->ultimos[i]);
+        }
+    }
+    b->num_muestras++;
+    memcpy(w->ultimos, valores, sizeof(w->ultimos));
+    w->ultimo_t_ms = t_ms;
+    return 0;
+}
+
+int record_grabar(const char* archivo, int hz, double duracion_s) {
+    RecordEscritor w;
+    memset(&w, 0, sizeof(w));
+    w.archivo = fopen(archivo, "wb");
+    if (!w.archivo) {
+        printf("\033[31m❌ Error: No se pudo crear %s\033[0m\n", archivo);
+        return 1;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    RecordHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+    header.version = RECORD_VERSION;
+    header.tam_header = sizeof(RecordHeader);
+    header.intervalo_ms = 1000 / hz;
+    header.num_campos = RECORD_NUM_CAMPOS;
+    header.muestras_por_bloque = RECORD_MUESTRAS_POR_BLOQUE;
+    header.tam_bloque = sizeof(RecordBlock);
+    header.inicio_unix_ms = (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    memcpy(header.campos, campos_info, sizeof(campos_info));
+
+    if (fwrite(&header, sizeof(header), 1, w.archivo) != 1) {
+        printf("\033[31m❌ Error: No se pudo escribir %s\033[0m\n", archivo);
+        fclose(w.archivo);
+        return 1;
+    }
+
+    printf("\033[36m⏺️  Grabando a %d Hz en %s (Ctrl+C para terminar)\033[0m\n", hz, archivo);
+    long muestras = duracion_s > 0 ? (long)(duracion_s * hz) : 0;
+    WatchResumen resumen;
+    int error = watch_muestrear(hz, muestras, grabar_muestra, &w, &resumen);
+
+    // Cerrar el último bloque aunque esté incompleto
+    if (escribir_bloque(&w) != 0) error = 1;
+    if (fclose(w.archivo) != 0) error = 1;
+
+    watch_imprimir_resumen(&resumen);
+    if (error) {
+        printf("\033[31m❌ Error: La grabación quedó incompleta\033[0m\n");
+        return 1;
+    }
+    printf("\033[36m✅ %ld bloques escritos en %s\033[0m\n", w.bloques_escritos, archivo);
+    return 0;
+}
+
+// Primer bloque que puede contener desde_ms: el último con t0_ms <= desde_ms
+static long buscar_bloque(const RecordBlock* bloques, long num_bloques, long long desde_ms) {
+    long lo = 0, hi = num_bloques - 1, resultado = 0;
+    while (lo <= hi) {
+        long medio = lo + (hi - lo) / 2;
+        if (bloques[medio].t0_ms <= desde_ms) {
+            resultado = medio;
+            lo = medio + 1;
+        } else {
+            hi = medio - 1;
+        }
+    }
+    return resultado;
+}
+
+// Imprimir un valor escalado; -1 (no disponible) sale como vacío, null o "-"
+static void imprimir_valor(int32_t valor, uint32_t escala, RecordFormato formato) {
+    if (valor < 0) {
+        printf("%s", formato == RECORD_FORMATO_JSON ? "null" : formato == RECORD_FORMATO_TABLA ? "-" : "");
+    } else if (escala > 1) {
+        printf("%.2f", (double)valor / escala);
+    } else {
+        printf("%d", valor);
+    }
+}
+
+static void imprimir_muestra(const RecordHeader* h, long long t_ms, const int32_t* valores,
+                             RecordFormato formato, long indice) {
+    switch (formato) {
+        case RECORD_FORMATO_CSV:
+            printf("%.3f", t_ms / 1000.0);
+            for (int i = 0; i < RECORD_NUM_CAMPOS; i++) {
+                putchar(',');
+                imprimir_valor(valores[i], h->campos[i].escala, formato);
+            }
+            putchar('\n');
+            break;
+        case RECORD_FORMATO_JSON:
+            printf("%s\n  {\"t\": %.3f", indice > 0 ? "," : "", t_ms / 1000.0);
+            for (int i = 0; i < RECORD_NUM_CAMPOS; i++) {
+                printf(", \"%s\": ", h->campos[i].nombre);
+                imprimir_valor(valores[i], h->campos[i].escala, formato);
+            }
+            putchar('}');
+            break;
+        case RECORD_FORMATO_TABLA:
+            printf("%8.2f", t_ms / 1000.0);
+            for (int i = 0; i < RECORD_NUM_CAMPOS; i++) {
+                putchar(' ');
+                int ancho = (int)strlen(h->campos[i].nombre);
+                // Alinear a derecha bajo el nombre del campo
+                char texto[32];
+                if (valores[i] < 0) snprintf(texto, sizeof(texto), "-");
+                else if (h->campos[i].escala > 1) snprintf(texto, sizeof(texto), "%.2f", (double)valores[i] / h->campos[i].escala);
+                else snprintf(texto, sizeof(texto), "%d", valores[i]);
+                printf("%*s", ancho, texto);
+            }
+            putchar('\n');
+            break;
+    }
+}
+
+int record_exportar(const char* archivo, RecordFormato formato, long long desde_ms, long long hasta_ms) {
+    int fd = open(archivo, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        printf("\033[31m❌ Error: No se pudo abrir %s\033[0m\n", archivo);
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(RecordHeader)) {
+        printf("\033[31m❌ Error: %s no es una grabación de GLX\033[0m\n", archivo);
+        close(fd);
+        return 1;
+    }
+    void* mapa = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        printf("\033[31m❌ Error: No se pudo mapear %s\033[0m\n", archivo);
+        return 1;
+    }
+
+    const RecordHeader* h = mapa;
+    if (memcmp(h->magic, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 || h->version != RECORD_VERSION ||
+        h->tam_header != sizeof(RecordHeader) || h->num_campos != RECORD_NUM_CAMPOS ||
+        h->tam_bloque != sizeof(RecordBlock)) {
+        printf("\033[31m❌ Error: %s no es una grabación de GLX compatible\033[0m\n", archivo);
+        munmap(mapa, st.st_size);
+        return 1;
+    }
+
+    // Un bloque truncado al final (grabación cortada) se ignora
+    const RecordBlock* bloques = (const RecordBlock*)((const char*)mapa + h->tam_header);
+    long num_bloques = (st.st_size - h->tam_header) / h->tam_bloque;
+
+    if (formato == RECORD_FORMATO_CSV) {
+        printf("t_s");
+        for (int i = 0; i < RECORD_NUM_CAMPOS; i++) printf(",%s", h->campos[i].nombre);
+        putchar('\n');
+    } else if (formato == RECORD_FORMATO_JSON) {
+        printf("{\"inicio_unix_ms\": %lld, \"intervalo_ms\": %u, \"muestras\": [",
+               (long long)h->inicio_unix_ms, h->intervalo_ms);
+    } else {
+        printf("\033[36m%8s", "t(s)");
+        for (int i = 0; i < RECORD_NUM_CAMPOS; i++) printf(" %s", h->campos[i].nombre);
+        printf("\033[0m\n");
+    }
+
+    long emitidas = 0;
+    int terminado = 0;
+    for (long b = num_bloques > 0 ? buscar_bloque(bloques, num_bloques, desde_ms) : 0; b < num_bloques && !terminado; b++) {
+        const RecordBlock* bloque = &bloques[b];
+        if (bloque->magic != RECORD_BLOQUE_MAGIC || bloque->num_muestras > RECORD_MUESTRAS_POR_BLOQUE) break;
+
+        long long t_ms = bloque->t0_ms;
+        int32_t valores[RECORD_NUM_CAMPOS];
+        memcpy(valores, bloque->base, sizeof(valores));
+
+        for (uint32_t m = 0; m < bloque->num_muestras; m++) {
+            if (m > 0) {
+                t_ms += bloque->muestras[m].dt_ms;
+                for (int i = 0; i < RECORD_NUM_CAMPOS; i++) valores[i] += bloque->muestras[m].delta[i];
+            }
+            if (hasta_ms >= 0 && t_ms > hasta_ms) {
+                terminado = 1;
+                break;
+            }
+            if (t_ms < desde_ms) continue;
+            imprimir_muestra(h, t_ms, valores, formato, emitidas++);
+        }
+    }
+
+    if (formato == RECORD_FORMATO_JSON) printf("\n]}\n");
+    munmap(mapa, st.st_size);
+    return 0;
+}
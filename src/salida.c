@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "../include/salida.h"
+
+#define SALIDA_BUFFER (64 * 1024)
+
+static SalidaNivel nivel_actual = SALIDA_NORMAL;
+static SalidaFormato formato_actual = SALIDA_TEXTO;
+static char buffer_stdout[SALIDA_BUFFER];
+
+static const char* ubicacion_archivo = NULL;
+static int ubicacion_linea = 0;
+static int ubicacion_columna = 0;
+static int campos_registro = 0;
+
+int salida_opcion(const char* arg) {
+    if (strcmp(arg, "-q") == 0 || strcmp(arg, "--quiet") == 0) {
+        nivel_actual = SALIDA_SILENCIOSA;
+    } else if (strcmp(arg, "--debug-tokens") == 0) {
+        nivel_actual = SALIDA_DEBUG_TOKENS;
+    } else if (strcmp(arg, "--debug-ast") == 0) {
+        nivel_actual = SALIDA_DEBUG_AST;
+    } else if (strncmp(arg, "--format=", 9) == 0) {
+        if (strcmp(arg + 9, "json") == 0) formato_actual = SALIDA_JSON;
+        else if (strcmp(arg + 9, "text") == 0) formato_actual = SALIDA_TEXTO;
+        else return -1;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+SalidaNivel salida_nivel(void) {
+    return nivel_actual;
+}
+
+int salida_json(void) {
+    return formato_actual == SALIDA_JSON;
+}
+
+int salida_muestra(SalidaNivel nivel) {
+    return formato_actual == SALIDA_TEXTO && nivel_actual >= nivel;
+}
+
+void salida_buffer_completo(void) {
+    setvbuf(stdout, buffer_stdout, _IOFBF, sizeof(buffer_stdout));
+}
+
+void salida_vaciar(void) {
+    fflush(stdout);
+}
+
+void salida_printf(const char* formato, ...) {
+    if (!salida_muestra(SALIDA_NORMAL)) return;
+    va_list args;
+    va_start(args, formato);
+    vprintf(formato, args);
+    va_end(args);
+}
+
+void salida_debug(SalidaNivel nivel, const char* formato, ...) {
+    if (!salida_muestra(nivel)) return;
+    va_list args;
+    va_start(args, formato);
+    vprintf(formato, args);
+    va_end(args);
+}
+
+// Escribir un string JSON escapado, sin las secuencias de color ANSI
+static void escribir_json_string(const char* texto) {
+    putchar('"');
+    for (const unsigned char* p = (const unsigned char*)texto; *p; p++) {
+        if (*p == '\033' && p[1] == '[') {
+            p += 2;
+            while (*p && !(*p >= '@' && *p <= '~')) p++;
+            if (!*p) break;
+            continue;
+        }
+        switch (*p) {
+            case '"': fputs("\\\"", stdout); break;
+            case '\\': fputs("\\\\", stdout); break;
+            case '\n': fputs("\\n", stdout); break;
+            case '\t': fputs("\\t", stdout); break;
+            default:
+                if (*p < 0x20) printf("\\u%04x", *p);
+                else putchar(*p);
+        }
+    }
+    putchar('"');
+}
+
+void salida_error(const char* formato, ...) {
+    char mensaje[1024];
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(mensaje, sizeof(mensaje), formato, args);
+    va_end(args);
+
+    if (formato_actual == SALIDA_TEXTO) {
+        fputs(mensaje, stdout);
+        return;
+    }
+
+    // Un registro por error, sin el salto de línea final
+    size_t len = strlen(mensaje);
+    while (len > 0 && mensaje[len - 1] == '\n') mensaje[--len] = '\0';
+    salida_json_inicio("error");
+    salida_json_texto("mensaje", mensaje);
+    salida_json_fin();
+}
+
+void salida_pregunta(const char* formato, ...) {
+    FILE* destino = formato_actual == SALIDA_TEXTO ? stdout : stderr;
+    va_list args;
+    va_start(args, formato);
+    vfprintf(destino, formato, args);
+    va_end(args);
+    fflush(stdout);
+    fflush(destino);
+}
+
+void salida_ubicacion(const char* archivo, int linea, int columna) {
+    ubicacion_archivo = archivo;
+    ubicacion_linea = linea;
+    ubicacion_columna = columna;
+}
+
+static void separar_campo(void) {
+    if (campos_registro++ > 0) putchar(',');
+}
+
+void salida_json_inicio(const char* evento) {
+    if (formato_actual != SALIDA_JSON) return;
+    campos_registro = 0;
+    putchar('{');
+    salida_json_texto("evento", evento);
+    if (ubicacion_archivo && ubicacion_linea > 0) {
+        salida_json_texto("archivo", ubicacion_archivo);
+        salida_json_entero("linea", ubicacion_linea);
+        salida_json_entero("columna", ubicacion_columna);
+    }
+}
+
+void salida_json_texto(const char* clave, const char* valor) {
+    if (formato_actual != SALIDA_JSON) return;
+    separar_campo();
+    escribir_json_string(clave);
+    putchar(':');
+    if (valor) escribir_json_string(valor);
+    else fputs("null", stdout);
+}
+
+void salida_json_entero(const char* clave, long long valor) {
+    if (formato_actual != SALIDA_JSON) return;
+    separar_campo();
+    escribir_json_string(clave);
+    printf(":%lld", valor);
+}
+
+void salida_json_fin(void) {
+    if (formato_actual != SALIDA_JSON) return;
+    fputs("}\n", stdout);
+}
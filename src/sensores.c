@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+#include "../include/sensores.h"
+#include "../include/status.h"
+#include "../include/gpu_telemetry.h"
+#include "../include/salida.h"
+
+// Intervalo del productor de GPU y espera máxima por la muestra (como "status")
+#define GPU_INTERVALO_SENSOR_MS 500
+#define GPU_TIMEOUT_SENSOR_MS 3000
+
+typedef enum {
+    SENSOR_ESTADO_INT,          // Campo int de SystemStatus
+    SENSOR_ESTADO_LONG,         // Campo long de SystemStatus
+    SENSOR_ESTADO_TEXTO,        // Campo char[] de SystemStatus
+    SENSOR_GPU_TEMPERATURA,
+    SENSOR_GPU_POTENCIA,
+    SENSOR_GPU_RELOJ
+} SensorLectura;
+
+typedef struct {
+    int fuente;                 // StatusSourceId (-1 para la GPU)
+    SensorLectura lectura;
+    size_t campo;               // offsetof del campo en SystemStatus
+} Sensor;
+
+// Mismo orden en los nombres y en la tabla
+const char* sensores_validos[] = {
+    "ac_online", "cpu_max_perf", "cpu_min_perf", "dynamic_boost", "no_turbo",
+    "mem_available_kb", "platform_profile", "gpu_temp", "gpu_power", "gpu_clock"
+};
+
+static const Sensor sensores[] = {
+    { STATUS_SRC_AC_ONLINE, SENSOR_ESTADO_INT, offsetof(SystemStatus, ac_online) },
+    { STATUS_SRC_MAX_PERF, SENSOR_ESTADO_INT, offsetof(SystemStatus, cpu_max_perf) },
+    { STATUS_SRC_MIN_PERF, SENSOR_ESTADO_INT, offsetof(SystemStatus, cpu_min_perf) },
+    { STATUS_SRC_DYNAMIC_BOOST, SENSOR_ESTADO_INT, offsetof(SystemStatus, dynamic_boost) },
+    { STATUS_SRC_NO_TURBO, SENSOR_ESTADO_INT, offsetof(SystemStatus, no_turbo) },
+    { STATUS_SRC_MEMINFO, SENSOR_ESTADO_LONG, offsetof(SystemStatus, mem_disponible_kb) },
+    { STATUS_SRC_PLATFORM_PROFILE, SENSOR_ESTADO_TEXTO, offsetof(SystemStatus, platform_profile) },
+    { -1, SENSOR_GPU_TEMPERATURA, 0 },
+    { -1, SENSOR_GPU_POTENCIA, 0 },
+    { -1, SENSOR_GPU_RELOJ, 0 },
+};
+
+#define NUM_SENSORES (int)(sizeof(sensores) / sizeof(sensores[0]))
+
+_Static_assert(sizeof(sensores_validos) / sizeof(sensores_validos[0]) == sizeof(sensores) / sizeof(sensores[0]),
+               "sensores_validos y sensores deben tener las mismas entradas");
+
+const int num_sensores = NUM_SENSORES;
+
+// Última lectura de cada sensor
+typedef struct {
+    int valida;
+    long long leido_ms;
+    long long numero;
+    char texto[64];
+} SensorCache;
+
+static SensorCache cache[NUM_SENSORES];
+static int ttl_ms = SENSORES_TTL_DEFECTO_MS;
+
+static long long ahora_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int sensor_buscar(const char* nombre) {
+    for (int i = 0; i < NUM_SENSORES; i++) {
+        if (strcmp(sensores_validos[i], nombre) == 0) return i;
+    }
+    return -1;
+}
+
+const char* sensor_nombre(int id) {
+    if (id < 0 || id >= NUM_SENSORES) return "desconocido";
+    return sensores_validos[id];
+}
+
+int sensor_es_numero(int id) {
+    return id >= 0 && id < NUM_SENSORES && sensores[id].lectura != SENSOR_ESTADO_TEXTO;
+}
+
+// Última muestra de GPU: la del productor que ya esté corriendo (watch,
+// shell) o la de uno lanzado solo para esta lectura
+static int leer_gpu(GpuSample* gpu) {
+    int productor_propio = !gpu_telemetry_activa();
+    if (productor_propio) gpu_telemetry_iniciar(GPU_INTERVALO_SENSOR_MS);
+    int ok = gpu_telemetry_esperar(gpu, GPU_TIMEOUT_SENSOR_MS);
+    if (productor_propio) gpu_telemetry_detener();
+    return ok;
+}
+
+// Leer la fuente del sensor; retorna 0 si no está disponible
+static int leer_fuente(const Sensor* sensor, SensorCache* destino) {
+    if (sensor->fuente >= 0) {
+        SystemStatus status;
+        if (!status_leer_fuente(sensor->fuente, &status)) return 0;
+
+        const char* base = (const char*)&status + sensor->campo;
+        if (sensor->lectura == SENSOR_ESTADO_TEXTO) {
+            snprintf(destino->texto, sizeof(destino->texto), "%s", base);
+            destino->numero = 0;
+            return destino->texto[0] != '\0';
+        }
+        destino->numero = sensor->lectura == SENSOR_ESTADO_INT ? *(const int*)base : *(const long*)base;
+    } else {
+        GpuSample gpu;
+        if (!leer_gpu(&gpu)) return 0;
+        if (sensor->lectura == SENSOR_GPU_TEMPERATURA) destino->numero = gpu.temperatura_c;
+        else if (sensor->lectura == SENSOR_GPU_RELOJ) destino->numero = gpu.reloj_mhz;
+        else destino->numero = gpu.potencia_w < 0 ? -1 : (long long)(gpu.potencia_w + 0.5);
+    }
+    if (destino->numero < 0) return 0;
+    snprintf(destino->texto, sizeof(destino->texto), "%lld", destino->numero);
+    return 1;
+}
+
+const char* sensor_leer(int id, long long* numero) {
+    if (id < 0 || id >= NUM_SENSORES) return NULL;
+    SensorCache* c = &cache[id];
+    long long ahora = ahora_ms();
+
+    if (!c->valida || ahora - c->leido_ms >= ttl_ms) {
+        // Una lectura fallida no se guarda: el próximo uso vuelve a intentar
+        SensorCache nueva;
+        memset(&nueva, 0, sizeof(nueva));
+        if (!leer_fuente(&sensores[id], &nueva)) {
+            salida_debug(SALIDA_DEBUG_TOKENS, "🌡️  sensor:%s no disponible\n", sensores_validos[id]);
+            return NULL;
+        }
+        nueva.valida = 1;
+        nueva.leido_ms = ahora_ms();
+        *c = nueva;
+        salida_debug(SALIDA_DEBUG_TOKENS, "🌡️  sensor:%s leído: %s (válido %d ms)\n", sensores_validos[id], c->texto, ttl_ms);
+    }
+    if (numero) *numero = c->numero;
+    return c->texto;
+}
+
+const char* sensor_cacheado(int id) {
+    if (id < 0 || id >= NUM_SENSORES || !cache[id].valida) return NULL;
+    return cache[id].texto;
+}
+
+void sensores_set_ttl(int nuevo_ttl_ms) {
+    ttl_ms = nuevo_ttl_ms < 0 ? 0 : nuevo_ttl_ms;
+}
+
+void sensores_reiniciar(void) {
+    memset(cache, 0, sizeof(cache));
+    ttl_ms = SENSORES_TTL_DEFECTO_MS;
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include "../include/shell.h"
+#include "../include/lexer.h"
+#include "../include/parser.h"
+#include "../include/interpreter.h"
+#include "../include/status.h"
+#include "../include/knobs.h"
+#include "../include/gpu_telemetry.h"
+#include "../include/salida.h"
+
+static volatile sig_atomic_t interrumpido = 0;
+static volatile sig_atomic_t terminar = 0;
+
+static void manejar_senal(int sig) {
+    if (sig == SIGINT) interrumpido = 1;
+    else terminar = 1;
+}
+
+static void mostrar_prompt(int interactivo) {
+    if (interactivo) salida_pregunta("\033[36mgx>\033[0m ");
+}
+
+// Consumir lo que queda de una línea que no entró en el buffer
+// Retorna cuántos caracteres se descartaron (0 si stdin ya estaba en EOF)
+static size_t descartar_resto(void) {
+    char resto[256];
+    size_t descartados = 0;
+    while (fgets(resto, sizeof(resto), stdin)) {
+        size_t largo = strlen(resto);
+        descartados += largo;
+        if (largo > 0 && resto[largo - 1] == '\n') break;
+    }
+    clearerr(stdin);
+    return descartados;
+}
+
+// Esperar una línea de stdin; mientras tanto se consume la salida de
+// nvidia-smi para que "status" y los sensores de GPU vean una muestra fresca
+// Retorna 1 si hay una línea, 0 al terminar (EOF o SIGTERM) y -1 si la línea
+// no entraba en el buffer (se descarta entera)
+static int leer_linea(char* linea, size_t size, int interactivo) {
+    for (;;) {
+        if (terminar) return 0;
+        if (interrumpido) {
+            // Ctrl+C descarta la línea a medio escribir, como en un shell
+            interrumpido = 0;
+            salida_pregunta("\n");
+            mostrar_prompt(interactivo);
+        }
+
+        struct pollfd fds[2] = {
+            { STDIN_FILENO, POLLIN, 0 },
+            { gpu_telemetry_fd(), POLLIN, 0 },     // poll ignora un fd negativo
+        };
+        int listos = poll(fds, 2, SHELL_ESPERA_MS);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        if (listos == 0 || fds[1].revents) gpu_telemetry_actualizar();
+        if (!fds[0].revents) continue;
+
+        if (fgets(linea, size, stdin)) {
+            // Sin '\n' y con el buffer lleno el resto seguiría como otra
+            // sentencia; solo vale si era la última línea, justo de ese largo
+            size_t largo = strlen(linea);
+            if (largo + 1 < size || linea[largo - 1] == '\n' || descartar_resto() == 0) return 1;
+            return -1;
+        }
+        if (ferror(stdin) && errno == EINTR) {
+            clearerr(stdin);
+            continue;
+        }
+        return 0;
+    }
+}
+
+// Ejecutar una línea como un programa de una sentencia
+static void ejecutar_linea(const char* linea, jmp_buf* recuperacion) {
+    Arena arena;
+    arena_init(&arena);
+    int cantidad_tokens = 0;
+    Token* tokens = lexer_tokenize(linea, strlen(linea), &cantidad_tokens, &arena);
+
+    if (salida_muestra(SALIDA_DEBUG_TOKENS)) {
+        for (int i = 0; i < cantidad_tokens; i++) {
+            if (tokens[i].tipo == TOKEN_FIN_LINEA) continue;
+            printf("  Token[%d] (%d:%d): %s\n", i, tokens[i].linea, tokens[i].columna, tokens[i].texto);
+        }
+    }
+
+    AST* ast = parser_parse(tokens, cantidad_tokens, &arena);
+
+    // Un error crítico vuelve acá: se pierde la sentencia, no la sesión
+    if (setjmp(*recuperacion) == 0) {
+        interpret_ast(ast);
+    }
+
+    liberar_tokens(tokens, cantidad_tokens);
+    arena_liberar(&arena);
+}
+
+int shell_ejecutar(void) {
+    int interactivo = isatty(STDIN_FILENO);
+
+    // Sin buffer en stdin: poll ve todo lo pendiente (stdio no adelanta
+    // líneas) y la confirmación de sobrescritura lee del mismo stdin
+    setvbuf(stdin, NULL, _IONBF, 0);
+
+    // Lo que un "gx" por comando vuelve a abrir cada vez queda abierto
+    StatusSampler sampler;
+    status_sampler_abrir(&sampler);
+    status_usar_sampler(&sampler);
+    knobs_sesion_abrir();
+    gpu_telemetry_iniciar(SHELL_GPU_INTERVALO_MS);
+
+    jmp_buf recuperacion;
+    interpret_set_sesion(&recuperacion);
+
+    // Sin SA_RESTART: Ctrl+C corta el poll en curso
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = manejar_senal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    interrumpido = 0;
+    terminar = 0;
+
+    if (interactivo) {
+        salida_printf("\033[36m🐚 GLX shell: 'help' para ver los comandos, 'salir' o Ctrl+D para terminar\033[0m\n");
+    }
+
+    char linea[SHELL_LINEA_MAX];
+    mostrar_prompt(interactivo);
+    int leida;
+    while ((leida = leer_linea(linea, sizeof(linea), interactivo)) != 0) {
+        if (leida < 0) {
+            salida_error("\033[31m❌ Error: línea de más de %d caracteres; no se ejecuta\033[0m\n", SHELL_LINEA_MAX - 2);
+            salida_vaciar();
+            mostrar_prompt(interactivo);
+            continue;
+        }
+        size_t inicio = strspn(linea, " \t");
+        size_t largo = strcspn(linea + inicio, "\r\n");
+        while (largo > 0 && (linea[inicio + largo - 1] == ' ' || linea[inicio + largo - 1] == '\t')) largo--;
+        linea[inicio + largo] = '\0';
+        const char* sentencia = linea + inicio;
+
+        if (strcmp(sentencia, "salir") == 0 || strcmp(sentencia, "exit") == 0 || strcmp(sentencia, "quit") == 0) break;
+        if (*sentencia) {
+            ejecutar_linea(sentencia, &recuperacion);
+            salida_vaciar();
+        }
+        mostrar_prompt(interactivo);
+    }
+    if (interactivo) salida_pregunta("\n");
+
+    interpret_set_sesion(NULL);
+    gpu_telemetry_detener();
+    knobs_sesion_cerrar();
+    status_usar_sampler(NULL);
+    status_sampler_cerrar(&sampler);
+    salida_vaciar();
+    return 0;
+}
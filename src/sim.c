@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "../include/sim.h"
+#include "../include/knobs.h"
+
+#define MAX_REGLAS_SIM 32
+
+typedef struct {
+    char nombre[32];
+    double latencia_ms;
+    double prob_falla;
+} SimRegla;
+
+static SimRegla reglas[MAX_REGLAS_SIM];
+static int num_reglas = 0;
+static int cargado = 0;
+static int activo = 0;
+static unsigned int semilla = 1;
+// Las escrituras de knobs corren en varios hilos (ejecutor.c)
+static pthread_mutex_t mutex_semilla = PTHREAD_MUTEX_INITIALIZER;
+
+static SimRegla* regla(const char* nombre, int crear) {
+    for (int i = 0; i < num_reglas; i++) {
+        if (strcmp(reglas[i].nombre, nombre) == 0) return &reglas[i];
+    }
+    if (!crear || num_reglas >= MAX_REGLAS_SIM) return NULL;
+
+    SimRegla* nueva = &reglas[num_reglas++];
+    memset(nueva, 0, sizeof(*nueva));
+    snprintf(nueva->nombre, sizeof(nueva->nombre), "%s", nombre);
+    return nueva;
+}
+
+// Parsear "nombre=valor,nombre=valor"; un nombre sin valor vale 1
+static void cargar_lista(const char* variable, int es_latencia) {
+    const char* lista = getenv(variable);
+    if (!lista) return;
+
+    char copia[512];
+    snprintf(copia, sizeof(copia), "%s", lista);
+    char* guardado;
+    for (char* item = strtok_r(copia, ",", &guardado); item; item = strtok_r(NULL, ",", &guardado)) {
+        char* igual = strchr(item, '=');
+        double valor = 1;
+        if (igual) {
+            *igual = '\0';
+            valor = atof(igual + 1);
+        }
+        SimRegla* r = regla(item, 1);
+        if (!r) break;
+        if (es_latencia) r->latencia_ms = valor;
+        else r->prob_falla = valor;
+    }
+}
+
+// La configuración se lee una sola vez, en la primera operación; así glxd
+// también la toma del entorno con que se lo lanzó
+static void cargar(void) {
+    cargado = 1;
+    const char* dir = getenv("GLX_SIM");
+    if (!dir || !*dir) return;
+    activo = 1;
+
+    cargar_lista("GLX_SIM_LATENCIA", 1);
+    cargar_lista("GLX_SIM_FALLAS", 0);
+    const char* valor_semilla = getenv("GLX_SIM_SEMILLA");
+    semilla = valor_semilla ? (unsigned int)strtoul(valor_semilla, NULL, 10) : (unsigned int)getpid();
+}
+
+int sim_activar(const char* dir) {
+    char ruta[512];
+    struct stat st;
+    snprintf(ruta, sizeof(ruta), "%s/sys", dir);
+    if (stat(ruta, &st) != 0 || !S_ISDIR(st.st_mode)) return -1;
+
+    setenv("GLX_SIM", dir, 1);
+    knobs_set_root(dir);
+
+    // nvidia-smi, legion_cli y sudo se resuelven primero en DIR/bin
+    const char* path = getenv("PATH");
+    char nuevo_path[4096];
+    snprintf(nuevo_path, sizeof(nuevo_path), "%s/bin%s%s", dir, path ? ":" : "", path ? path : "");
+    setenv("PATH", nuevo_path, 1);
+
+    snprintf(ruta, sizeof(ruta), "%s/bin/nvidia-smi", dir);
+    setenv("GLX_NVIDIA_SMI", ruta, 0);
+
+    // Sin esto un glxd real aplicaría los cambios al hardware
+    snprintf(ruta, sizeof(ruta), "%s/glxd.sock", dir);
+    setenv("GLX_SOCKET", ruta, 0);
+
+    cargado = 0;
+    num_reglas = 0;
+    cargar();
+    return 0;
+}
+
+int sim_activo(void) {
+    if (!cargado) cargar();
+    return activo;
+}
+
+int sim_operacion(const char* nombre, const char* clase) {
+    if (!cargado) cargar();
+    if (!activo || num_reglas == 0) return 0;
+
+    SimRegla* r = regla(nombre, 0);
+    if (!r && clase) r = regla(clase, 0);
+    if (!r) r = regla("*", 0);
+    if (!r) return 0;
+
+    if (r->latencia_ms > 0) {
+        struct timespec espera;
+        espera.tv_sec = (time_t)(r->latencia_ms / 1000);
+        espera.tv_nsec = (long)((r->latencia_ms - espera.tv_sec * 1000.0) * 1e6);
+        while (nanosleep(&espera, &espera) != 0 && errno == EINTR) {}
+    }
+
+    int falla = r->prob_falla >= 1;
+    if (!falla && r->prob_falla > 0) {
+        pthread_mutex_lock(&mutex_semilla);
+        falla = (double)rand_r(&semilla) / RAND_MAX < r->prob_falla;
+        pthread_mutex_unlock(&mutex_semilla);
+    }
+    if (falla) {
+        errno = EIO;
+        return -1;
+    }
+    return 0;
+}
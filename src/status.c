@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/status.h"
+#include "../include/knobs.h"
+#include "../include/utils.h"
+#include "../include/gpu_telemetry.h"
+#include "../include/salida.h"
+#include "../include/sim.h"
+
+// Intervalo del productor de GPU y espera máxima por la primera muestra en "status"
+#define GPU_INTERVALO_STATUS_MS 500
+#define GPU_TIMEOUT_STATUS_MS 3000
+
+// Rutas candidatas de cada fuente, en orden de preferencia
+typedef struct {
+    const char* nombre;
+    const char* rutas[3];
+} StatusSource;
+
+static const StatusSource status_fuentes[STATUS_SRC_COUNT] = {
+    [STATUS_SRC_CPUINFO] = { "cpuinfo", { "/proc/cpuinfo", NULL, NULL } },
+    [STATUS_SRC_MEMINFO] = { "meminfo", { "/proc/meminfo", NULL, NULL } },
+    [STATUS_SRC_MAX_PERF] = { "max_perf", { INTEL_PSTATE_DIR "/max_perf_pct", NULL, NULL } },
+    [STATUS_SRC_MIN_PERF] = { "min_perf", { INTEL_PSTATE_DIR "/min_perf_pct", NULL, NULL } },
+    [STATUS_SRC_DYNAMIC_BOOST] = { "dynamic_boost", { INTEL_PSTATE_DIR "/hwp_dynamic_boost", NULL, NULL } },
+    [STATUS_SRC_NO_TURBO] = { "no_turbo", { INTEL_PSTATE_DIR "/no_turbo", NULL, NULL } },
+    [STATUS_SRC_AC_ONLINE] = { "ac_online", { "/sys/class/power_supply/AC/online",
+                                              "/sys/class/power_supply/ADP1/online",
+                                              "/sys/class/power_supply/ACAD/online" } },
+    [STATUS_SRC_PLATFORM_PROFILE] = { "platform_profile", { PLATFORM_PROFILE_PATH, PLATFORM_PROFILE_LEGACY_PATH, NULL } },
+};
+
+// Buffer reutilizado por todas las lecturas; el modelo de CPU está en el
+// primer bloque de /proc/cpuinfo, así que no hace falta leer el archivo entero
+static char buffer_lectura[8192];
+
+const char* status_fuente_nombre(StatusSourceId id) {
+    if (id < 0 || id >= STATUS_SRC_COUNT) return "desconocida";
+    return status_fuentes[id].nombre;
+}
+
+int status_fuente_ruta(StatusSourceId id, char* buffer, size_t size) {
+    if (id < 0 || id >= STATUS_SRC_COUNT) return 0;
+    for (int i = 0; i < 3; i++) {
+        const char* ruta = status_fuentes[id].rutas[i];
+        if (!ruta) continue;
+        snprintf(buffer, size, "%s%s", knobs_get_root(), ruta);
+        if (access(buffer, R_OK) == 0) return 1;
+    }
+    return 0;
+}
+
+// Muestreador de la sesión (gx shell); NULL fuera de ella
+static StatusSampler* sampler_sesion = NULL;
+
+void status_usar_sampler(StatusSampler* sampler) {
+    sampler_sesion = sampler;
+}
+
+// Releer una fuente ya abierta en buffer_lectura
+// sysfs regenera el contenido en cada lectura desde el offset 0
+static const char* releer_fuente(int fd, StatusSourceId id) {
+    if (sim_operacion(status_fuentes[id].nombre, "sysfs") != 0) return NULL;
+    ssize_t n = pread(fd, buffer_lectura, sizeof(buffer_lectura) - 1, 0);
+    if (n <= 0) return NULL;
+    buffer_lectura[n] = '\0';
+    return buffer_lectura;
+}
+
+// Leer una fuente completa en buffer_lectura; NULL si no está disponible
+static const char* leer_fuente(StatusSourceId id) {
+    if (sampler_sesion && sampler_sesion->fds[id] >= 0) {
+        return releer_fuente(sampler_sesion->fds[id], id);
+    }
+
+    char ruta[512];
+    if (!status_fuente_ruta(id, ruta, sizeof(ruta))) return NULL;
+    if (sim_operacion(status_fuentes[id].nombre, "sysfs") != 0) return NULL;
+
+    int fd = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    ssize_t n = read(fd, buffer_lectura, sizeof(buffer_lectura) - 1);
+    close(fd);
+    if (n <= 0) return NULL;
+
+    buffer_lectura[n] = '\0';
+    return buffer_lectura;
+}
+
+// Buscar "clave: valor" en un archivo tipo /proc y devolver el inicio del valor
+static const char* buscar_campo(const char* contenido, const char* clave) {
+    size_t len = strlen(clave);
+    const char* linea = contenido;
+    while (linea && *linea) {
+        if (strncmp(linea, clave, len) == 0 && (linea[len] == ':' || linea[len] == ' ' || linea[len] == '\t')) {
+            const char* valor = strchr(linea + len, ':');
+            if (!valor) return NULL;
+            valor++;
+            while (*valor == ' ' || *valor == '\t') valor++;
+            return valor;
+        }
+        linea = strchr(linea, '\n');
+        if (linea) linea++;
+    }
+    return NULL;
+}
+
+void status_parsear_fuente(SystemStatus* status, StatusSourceId id, const char* contenido) {
+    const char* valor;
+    switch (id) {
+        case STATUS_SRC_CPUINFO:
+            valor = buscar_campo(contenido, "model name");
+            if (valor) {
+                size_t len = strcspn(valor, "\n");
+                if (len >= sizeof(status->cpu_modelo)) len = sizeof(status->cpu_modelo) - 1;
+                memcpy(status->cpu_modelo, valor, len);
+                status->cpu_modelo[len] = '\0';
+            }
+            break;
+        case STATUS_SRC_MEMINFO:
+            if ((valor = buscar_campo(contenido, "MemTotal"))) status->mem_total_kb = atol(valor);
+            if ((valor = buscar_campo(contenido, "MemFree"))) status->mem_libre_kb = atol(valor);
+            if ((valor = buscar_campo(contenido, "MemAvailable"))) status->mem_disponible_kb = atol(valor);
+            break;
+        case STATUS_SRC_MAX_PERF: status->cpu_max_perf = atoi(contenido); break;
+        case STATUS_SRC_MIN_PERF: status->cpu_min_perf = atoi(contenido); break;
+        case STATUS_SRC_DYNAMIC_BOOST: status->dynamic_boost = atoi(contenido); break;
+        case STATUS_SRC_NO_TURBO: status->no_turbo = atoi(contenido); break;
+        case STATUS_SRC_AC_ONLINE: status->ac_online = atoi(contenido); break;
+        case STATUS_SRC_PLATFORM_PROFILE: {
+            size_t len = strcspn(contenido, "\n");
+            if (len >= sizeof(status->platform_profile)) len = sizeof(status->platform_profile) - 1;
+            memcpy(status->platform_profile, contenido, len);
+            status->platform_profile[len] = '\0';
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void status_inicializar(SystemStatus* status) {
+    memset(status, 0, sizeof(*status));
+    status->mem_total_kb = -1;
+    status->mem_libre_kb = -1;
+    status->mem_disponible_kb = -1;
+    status->cpu_max_perf = -1;
+    status->cpu_min_perf = -1;
+    status->dynamic_boost = -1;
+    status->no_turbo = -1;
+    status->ac_online = -1;
+}
+
+void status_recolectar(SystemStatus* status) {
+    if (sampler_sesion) {
+        status_sampler_leer(sampler_sesion, status);
+        return;
+    }
+    status_inicializar(status);
+
+    for (int i = 0; i < STATUS_SRC_COUNT; i++) {
+        const char* contenido = leer_fuente(i);
+        if (contenido) {
+            status_parsear_fuente(status, i, contenido);
+        }
+    }
+}
+
+int status_leer_fuente(StatusSourceId id, SystemStatus* status) {
+    status_inicializar(status);
+    const char* contenido = leer_fuente(id);
+    if (!contenido) return 0;
+    status_parsear_fuente(status, id, contenido);
+    return 1;
+}
+
+int status_sampler_abrir(StatusSampler* sampler) {
+    int abiertas = 0;
+    sampler->cpu_modelo[0] = '\0';
+
+    for (int i = 0; i < STATUS_SRC_COUNT; i++) {
+        sampler->fds[i] = -1;
+
+        // El modelo de CPU no cambia: se lee una vez y no se deja abierto
+        if (i == STATUS_SRC_CPUINFO) {
+            const char* contenido = leer_fuente(i);
+            if (contenido) {
+                SystemStatus tmp;
+                status_inicializar(&tmp);
+                status_parsear_fuente(&tmp, i, contenido);
+                memcpy(sampler->cpu_modelo, tmp.cpu_modelo, sizeof(sampler->cpu_modelo));
+                abiertas++;
+            }
+            continue;
+        }
+
+        char ruta[512];
+        if (!status_fuente_ruta(i, ruta, sizeof(ruta))) continue;
+        sampler->fds[i] = open(ruta, O_RDONLY | O_CLOEXEC);
+        if (sampler->fds[i] >= 0) abiertas++;
+    }
+    return abiertas;
+}
+
+void status_sampler_leer(StatusSampler* sampler, SystemStatus* status) {
+    status_inicializar(status);
+    memcpy(status->cpu_modelo, sampler->cpu_modelo, sizeof(status->cpu_modelo));
+
+    for (int i = 0; i < STATUS_SRC_COUNT; i++) {
+        if (sampler->fds[i] < 0) continue;
+        const char* contenido = releer_fuente(sampler->fds[i], i);
+        if (contenido) status_parsear_fuente(status, i, contenido);
+    }
+}
+
+void status_sampler_cerrar(StatusSampler* sampler) {
+    for (int i = 0; i < STATUS_SRC_COUNT; i++) {
+        if (sampler->fds[i] >= 0) {
+            close(sampler->fds[i]);
+            sampler->fds[i] = -1;
+        }
+    }
+}
+
+// Formatear kB como lo hace "free -h" (15Gi, 5.2Gi, 512Mi)
+static void formatear_memoria(long kb, char* buffer, size_t size) {
+    double mib = kb / 1024.0;
+    if (mib >= 1024.0) {
+        double gib = mib / 1024.0;
+        snprintf(buffer, size, gib < 10.0 ? "%.1fGi" : "%.0fGi", gib);
+    } else {
+        snprintf(buffer, size, "%.0fMi", mib);
+    }
+}
+
+void status_mostrar(void) {
+    salida_printf("\033[36mEstado actual del sistema:\033[0m\n");
+
+    // Obtener información de GPU: si ya hay un productor corriendo (watch, shell)
+    // se usa su última muestra; si no, se lanza uno solo para esta consulta
+    GpuSample gpu;
+    int productor_propio = !gpu_telemetry_activa();
+    if (productor_propio) {
+        gpu_telemetry_iniciar(GPU_INTERVALO_STATUS_MS);
+    }
+    int gpu_ok = gpu_telemetry_esperar(&gpu, GPU_TIMEOUT_STATUS_MS);
+    if (gpu_ok) {
+        salida_printf("   GPU: %s\n", gpu.linea);
+    } else {
+        salida_printf("   Advertencia: GPU: No se pudo obtener información\033[0m\n");
+    }
+    if (productor_propio) {
+        gpu_telemetry_detener();
+    }
+
+    SystemStatus status;
+    status_recolectar(&status);
+
+    if (salida_json()) {
+        // -1 (no disponible) se deja tal cual para que el consumidor lo distinga
+        salida_json_inicio("status");
+        salida_json_texto("gpu", gpu_ok ? gpu.linea : NULL);
+        salida_json_texto("cpu_modelo", status.cpu_modelo[0] ? status.cpu_modelo : NULL);
+        salida_json_entero("mem_total_kb", status.mem_total_kb);
+        salida_json_entero("mem_libre_kb", status.mem_libre_kb);
+        salida_json_entero("mem_disponible_kb", status.mem_disponible_kb);
+        salida_json_entero("cpu_max_perf", status.cpu_max_perf);
+        salida_json_entero("cpu_min_perf", status.cpu_min_perf);
+        salida_json_entero("dynamic_boost", status.dynamic_boost);
+        salida_json_entero("no_turbo", status.no_turbo);
+        salida_json_entero("ac_online", status.ac_online);
+        salida_json_texto("platform_profile", status.platform_profile[0] ? status.platform_profile : NULL);
+        salida_json_fin();
+        return;
+    }
+
+    if (status.cpu_modelo[0]) {
+        salida_printf("   CPU: %s\n", status.cpu_modelo);
+    }
+
+    if (status.mem_total_kb >= 0 && status.mem_libre_kb >= 0) {
+        char total[16], usado[16], libre[16];
+        long disponible = status.mem_disponible_kb >= 0 ? status.mem_disponible_kb : status.mem_libre_kb;
+        formatear_memoria(status.mem_total_kb, total, sizeof(total));
+        formatear_memoria(status.mem_total_kb - disponible, usado, sizeof(usado));
+        formatear_memoria(status.mem_libre_kb, libre, sizeof(libre));
+        salida_printf("   Memoria: %s total, %s usado, %s libre\n", total, usado, libre);
+    }
+
+    int completo = 1;
+    if (status.cpu_max_perf >= 0) salida_printf("   CPU Max Performance: %d%%\n", status.cpu_max_perf);
+    else completo = 0;
+    if (status.cpu_min_perf >= 0) salida_printf("   CPU Min Performance: %d%%\n", status.cpu_min_perf);
+    else completo = 0;
+    if (status.dynamic_boost >= 0) salida_printf("   Dynamic Boost: %s\n", status.dynamic_boost == 1 ? "ON" : "OFF");
+    else completo = 0;
+    if (status.no_turbo >= 0) salida_printf("   Turbo Boost: %s\n", status.no_turbo == 1 ? "OFF" : "ON");
+    else completo = 0;
+    if (status.ac_online >= 0) salida_printf("   Estado de batería: %s\n", status.ac_online == 1 ? "Enchufada" : "Con batería");
+    else completo = 0;
+    salida_printf("   Color del botón de encendido: %s\n", profile_to_color_name(status.platform_profile));
+
+    if (!completo) {
+        salida_printf("   Advertencia: CPU/Sistema: No se pudo obtener información completa\033[0m\n");
+    }
+}
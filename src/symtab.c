@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/symtab.h"
+
+static uint32_t hash_nombre(const char* nombre) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)nombre; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Slot del índice donde está (o iría) un nombre con ese hash
+static uint32_t buscar_slot(const SymTab* tabla, const char* nombre, uint32_t hash) {
+    uint32_t mascara = tabla->cap_indice - 1;
+    uint32_t slot = hash & mascara;
+    while (tabla->indice[slot]) {
+        const Simbolo* s = &tabla->simbolos[tabla->indice[slot] - 1];
+        if (s->hash == hash && strcmp(s->nombre, nombre) == 0) break;
+        slot = (slot + 1) & mascara;
+    }
+    return slot;
+}
+
+// Duplicar el índice y reubicar los símbolos (se mantiene la carga <= 1/2)
+static void crecer_indice(SymTab* tabla) {
+    free(tabla->indice);
+    tabla->cap_indice = tabla->cap_indice ? tabla->cap_indice * 2 : 64;
+    tabla->indice = calloc(tabla->cap_indice, sizeof(uint32_t));
+
+    uint32_t mascara = tabla->cap_indice - 1;
+    for (uint32_t i = 0; i < tabla->cantidad; i++) {
+        uint32_t slot = tabla->simbolos[i].hash & mascara;
+        while (tabla->indice[slot]) slot = (slot + 1) & mascara;
+        tabla->indice[slot] = i + 1;
+    }
+}
+
+Simbolo* symtab_buscar(SymTab* tabla, const char* nombre) {
+    if (tabla->cantidad == 0) return NULL;
+    uint32_t slot = buscar_slot(tabla, nombre, hash_nombre(nombre));
+    return tabla->indice[slot] ? &tabla->simbolos[tabla->indice[slot] - 1] : NULL;
+}
+
+Simbolo* symtab_definir(SymTab* tabla, const char* nombre) {
+    if ((tabla->cantidad + 1) * 2 > tabla->cap_indice) {
+        crecer_indice(tabla);
+    }
+    if (tabla->cantidad == tabla->cap_simbolos) {
+        tabla->cap_simbolos = tabla->cap_simbolos ? tabla->cap_simbolos * 2 : 32;
+        tabla->simbolos = realloc(tabla->simbolos, tabla->cap_simbolos * sizeof(Simbolo));
+    }
+
+    uint32_t hash = hash_nombre(nombre);
+    uint32_t slot = buscar_slot(tabla, nombre, hash);
+
+    Simbolo* s = &tabla->simbolos[tabla->cantidad];
+    memset(s, 0, sizeof(*s));
+    s->nombre = arena_strndup(&tabla->nombres, nombre, strlen(nombre));
+    s->hash = hash;
+    tabla->indice[slot] = ++tabla->cantidad;
+    return s;
+}
+
+static void guardar_texto(Simbolo* simbolo, const char* texto, size_t len) {
+    if (len + 1 > simbolo->cap_texto) {
+        simbolo->cap_texto = len + 1 > 16 ? len + 1 : 16;
+        simbolo->texto = realloc(simbolo->texto, simbolo->cap_texto);
+    }
+    memmove(simbolo->texto, texto, len);  // texto puede ser el valor actual
+    simbolo->texto[len] = '\0';
+}
+
+void symtab_asignar_numero(Simbolo* simbolo, long long numero, const char* texto) {
+    simbolo->tipo = SYM_NUMERO;
+    simbolo->numero = numero;
+    simbolo->sensor = 0;
+    guardar_texto(simbolo, texto, strlen(texto));
+}
+
+void symtab_asignar_texto(Simbolo* simbolo, const char* texto) {
+    simbolo->tipo = SYM_TEXTO;
+    simbolo->numero = 0;
+    simbolo->sensor = 0;
+    guardar_texto(simbolo, texto, strlen(texto));
+}
+
+void symtab_ligar_sensor(Simbolo* simbolo, int sensor, SymTipo tipo, const char* nombre_sensor) {
+    char texto[96];
+    snprintf(texto, sizeof(texto), "sensor:%s", nombre_sensor);
+    simbolo->tipo = tipo;
+    simbolo->numero = 0;
+    simbolo->sensor = sensor + 1;
+    guardar_texto(simbolo, texto, strlen(texto));
+}
+
+void symtab_refrescar(Simbolo* simbolo, long long numero, const char* texto) {
+    simbolo->numero = numero;
+    guardar_texto(simbolo, texto, strlen(texto));
+}
+
+void symtab_liberar(SymTab* tabla) {
+    for (uint32_t i = 0; i < tabla->cantidad; i++) {
+        free(tabla->simbolos[i].texto);
+    }
+    free(tabla->simbolos);
+    free(tabla->indice);
+    arena_liberar(&tabla->nombres);
+    memset(tabla, 0, sizeof(*tabla));
+}
@@ -1,29 +1,28 @@
+#define _GNU_SOURCE
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include "utils.h"
+#include "knobs.h"
+#include "modos_default.h"
 
 // Listas de palabras válidas para fuzzy match
-const char* modos_validos[] = {"quiet", "balanced", "performance"};
-const int num_modos = 3;
+// (los modos no son fijos: salen de modos_default y de modelo.txt)
 
-// Parámetros válidos basados en modelo.txt (solo los que realmente funcionan)
+// Parámetros válidos (los nombres de params.def, en el orden de ParamId)
 const char* parametros_validos[] = {
-    "dynamic_boost", 
-    "cpu_max_perf", 
-    "cpu_min_perf", 
-    "turbo_boost", 
-    "persist_mode", 
-    "battery_conservation", 
-    "fnlock", 
-    "rgb_color",
-    "rgb_brightness",
-    "mode", 
-    "modo"
+#define PARAM(nombre, tipo, min, max, formato, etiqueta, knob) #nombre,
+#include "params.def"
+#undef PARAM
 };
-const int num_parametros = 11;
+const int num_parametros = PARAM_COUNT;
 
 // Comandos GPU válidos (solo los que realmente funcionan)
 const char* comandos_gpu_validos[] = {
@@ -44,45 +43,212 @@ static int min3(int a, int b, int c) {
     return c;
 }
 
-// Distancia de Levenshtein para fuzzy match
-int levenshtein(const char* s1, const char* s2) {
-    int len1 = strlen(s1), len2 = strlen(s2);
-    int* prev = calloc(len2 + 1, sizeof(int));
-    int* curr = calloc(len2 + 1, sizeof(int));
-    for (int j = 0; j <= len2; j++) prev[j] = j;
+// Largo máximo de la palabra más corta que se compara por programación
+// dinámica; nombres de parámetros, comandos y modos quedan muy por debajo
+#define DISTANCIA_MAX_LARGO 256
+
+// Distancia de Levenshtein con el algoritmo bit-paralelo de Myers (variante
+// de Hyyrö): una columna de la matriz por carácter del texto, sin reservas.
+// El patrón (la palabra más corta) debe tener entre 1 y 64 caracteres.
+// Corta antes si la distancia ya no puede quedar <= max_distancia
+static int distancia_myers(const unsigned char* patron, int m, const unsigned char* texto, int n, int max_distancia) {
+    uint64_t peq[256] = {0};
+    for (int i = 0; i < m; i++) {
+        peq[patron[i]] |= 1ull << i;
+    }
+
+    uint64_t pv = ~0ull, mv = 0;
+    uint64_t ultimo = 1ull << (m - 1);
+    int distancia = m;
+    for (int j = 0; j < n; j++) {
+        uint64_t eq = peq[texto[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & ultimo) distancia++;
+        else if (mh & ultimo) distancia--;
+        // La fila 0 vale j: siempre suma uno en horizontal
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // Cada carácter restante baja la distancia a lo sumo en uno
+        if (distancia - (n - j - 1) > max_distancia) return max_distancia + 1;
+    }
+    return distancia;
+}
+
+// Programación dinámica por filas para palabras de más de 64 caracteres.
+// Solo se calcula la banda de celdas a max_distancia o menos de la
+// diagonal; lo que queda afuera vale max_distancia + 1. La fila va en la
+// pila: la palabra más corta (s2) tiene a lo sumo DISTANCIA_MAX_LARGO
+static int distancia_dp(const char* s1, int len1, const char* s2, int len2, int max_distancia) {
+    int fila[DISTANCIA_MAX_LARGO + 1];
+    int k = max_distancia < len1 ? max_distancia : len1;
+    int fuera = k + 1;
+    for (int j = 0; j <= len2; j++) fila[j] = j <= k ? j : fuera;
     for (int i = 1; i <= len1; i++) {
-        curr[0] = i;
-        for (int j = 1; j <= len2; j++) {
+        int desde = i - k > 1 ? i - k : 1;
+        int hasta = i + k < len2 ? i + k : len2;
+        int diagonal = fila[desde - 1];
+        fila[desde - 1] = desde == 1 && i <= k ? i : fuera;
+        int minimo = fila[desde - 1];
+        for (int j = desde; j <= hasta; j++) {
+            int arriba = fila[j];
             int cost = (s1[i-1] == s2[j-1]) ? 0 : 1;
-            curr[j] = min3(
-                curr[j-1] + 1,
-                prev[j] + 1,
-                prev[j-1] + cost
-            );
+            int valor = min3(fila[j-1] + 1, arriba + 1, diagonal + cost);
+            fila[j] = valor < fuera ? valor : fuera;
+            diagonal = arriba;
+            if (fila[j] < minimo) minimo = fila[j];
         }
-        int* tmp = prev; prev = curr; curr = tmp;
+        // Toda la banda ya se pasó: la distancia final también
+        if (minimo > k) return max_distancia + 1;
     }
-    int dist = prev[len2];
-    free(prev); free(curr);
-    return dist;
+    return fila[len2] <= k ? fila[len2] : max_distancia + 1;
 }
 
-// Sugerir palabra similar si la distancia es baja
-const char* sugerir_palabra(const char* palabra, const char** lista, int cantidad, int max_distancia) {
-    int mejor_dist = max_distancia + 1;
-    const char* sugerencia = NULL;
+// Distancia acotada: el valor exacto si es <= max_distancia, si no algo mayor.
+// Si la palabra más corta pasa de DISTANCIA_MAX_LARGO caracteres no se mide
+static int levenshtein_acotada(const char* s1, const char* s2, int max_distancia) {
+    int len1 = strlen(s1), len2 = strlen(s2);
+    if (len1 > len2) {
+        const char* t = s1; s1 = s2; s2 = t;
+        int l = len1; len1 = len2; len2 = l;
+    }
+    if (len2 - len1 > max_distancia) return max_distancia + 1;
+    if (len1 == 0) return len2;
+    if (len1 <= 64) {
+        return distancia_myers((const unsigned char*)s1, len1, (const unsigned char*)s2, len2, max_distancia);
+    }
+    if (len1 > DISTANCIA_MAX_LARGO) return max_distancia + 1;
+    return distancia_dp(s2, len2, s1, len1, max_distancia);
+}
+
+// Distancia de Levenshtein para fuzzy match
+int levenshtein(const char* s1, const char* s2) {
+    return levenshtein_acotada(s1, s2, INT_MAX - 1);
+}
+
+// Índice de un vocabulario para sugerencias: un BK-tree sobre las palabras
+// de la lista. Se arma una vez por lista (la primera vez que se pide una
+// sugerencia) y cada búsqueda solo mide la distancia a los nodos cuyo
+// rango puede contener palabras a max_distancia o menos.
+typedef struct {
+    int indice;         // Posición de la palabra en la lista
+    int distancia;      // Distancia al padre
+    int hijo;           // Primer hijo (-1 si no tiene)
+    int hermano;        // Siguiente hijo del mismo padre
+} NodoBK;
+
+typedef struct {
+    const char** lista;
+    int cantidad;
+    NodoBK* nodos;
+} IndiceDifuso;
+
+#define MAX_INDICES_DIFUSOS 16
+static IndiceDifuso indices_difusos[MAX_INDICES_DIFUSOS];
+static int num_indices_difusos = 0;
+
+static const IndiceDifuso* indice_difuso(const char** lista, int cantidad) {
+    for (int i = 0; i < num_indices_difusos; i++) {
+        if (indices_difusos[i].lista == lista && indices_difusos[i].cantidad == cantidad) {
+            return &indices_difusos[i];
+        }
+    }
+    if (num_indices_difusos == MAX_INDICES_DIFUSOS || cantidad <= 0) return NULL;
+
+    IndiceDifuso* indice = &indices_difusos[num_indices_difusos++];
+    indice->lista = lista;
+    indice->cantidad = cantidad;
+    indice->nodos = malloc(cantidad * sizeof(NodoBK));
+    if (!indice->nodos) {
+        // Sin memoria se recorre la lista entera (ver sugerir)
+        num_indices_difusos--;
+        return NULL;
+    }
     for (int i = 0; i < cantidad; i++) {
-        int dist = levenshtein(palabra, lista[i]);
-        if (dist == 0) {
-            // Si la distancia es 0, la palabra ya está en la lista, no sugerir nada
-            return NULL;
+        NodoBK* nodo = &indice->nodos[i];
+        nodo->indice = i;
+        nodo->distancia = 0;
+        nodo->hijo = -1;
+        nodo->hermano = -1;
+        if (i == 0) continue;
+
+        // Bajar desde la raíz por el hijo que está a la misma distancia
+        int actual = 0;
+        while (1) {
+            int d = levenshtein(lista[i], lista[indice->nodos[actual].indice]);
+            int h = indice->nodos[actual].hijo;
+            while (h >= 0 && indice->nodos[h].distancia != d) h = indice->nodos[h].hermano;
+            if (h < 0) {
+                nodo->distancia = d;
+                nodo->hermano = indice->nodos[actual].hijo;
+                indice->nodos[actual].hijo = i;
+                break;
+            }
+            actual = h;
+        }
+    }
+    return indice;
+}
+
+// Mejor candidato dentro de max_distancia: menor distancia y, a igual
+// distancia, la que aparece primero en la lista
+typedef struct {
+    int distancia;
+    int indice;
+} CandidatoDifuso;
+
+static void buscar_bk(const IndiceDifuso* indice, int nodo, const char* palabra, int max_distancia, CandidatoDifuso* mejor) {
+    const NodoBK* n = &indice->nodos[nodo];
+    int d = levenshtein(palabra, indice->lista[n->indice]);
+    if (d <= max_distancia &&
+        (d < mejor->distancia || (d == mejor->distancia && n->indice < mejor->indice))) {
+        mejor->distancia = d;
+        mejor->indice = n->indice;
+    }
+    for (int h = n->hijo; h >= 0; h = indice->nodos[h].hermano) {
+        int dh = indice->nodos[h].distancia;
+        if (dh >= d - max_distancia && dh <= d + max_distancia) {
+            buscar_bk(indice, h, palabra, max_distancia, mejor);
         }
-        if (dist < mejor_dist) {
-            mejor_dist = dist;
-            sugerencia = lista[i];
+    }
+}
+
+// Sugerir palabra similar si la distancia es baja
+// Si la palabra ya está en la lista no se sugiere nada
+static const char* sugerir(const char* palabra, const char** lista, int cantidad, int max_distancia, int indexar) {
+    if (max_distancia < 0) max_distancia = 0;
+    // Una palabra tan larga no es un nombre mal escrito
+    if (strlen(palabra) > DISTANCIA_MAX_LARGO) return NULL;
+    CandidatoDifuso mejor = { max_distancia + 1, cantidad };
+
+    const IndiceDifuso* indice = indexar ? indice_difuso(lista, cantidad) : NULL;
+    if (indice) {
+        buscar_bk(indice, 0, palabra, max_distancia, &mejor);
+    } else {
+        for (int i = 0; i < cantidad; i++) {
+            int d = levenshtein_acotada(palabra, lista[i], max_distancia);
+            if (d < mejor.distancia) {
+                mejor.distancia = d;
+                mejor.indice = i;
+            }
         }
     }
-    return (mejor_dist <= max_distancia) ? sugerencia : NULL;
+
+    if (mejor.distancia == 0 || mejor.distancia > max_distancia) return NULL;
+    return lista[mejor.indice];
+}
+
+const char* sugerir_palabra(const char* palabra, const char** lista, int cantidad, int max_distancia) {
+    return sugerir(palabra, lista, cantidad, max_distancia, 1);
+}
+
+const char* sugerir_palabra_variable(const char* palabra, const char** lista, int cantidad, int max_distancia) {
+    return sugerir(palabra, lista, cantidad, max_distancia, 0);
 }
 
 // Función para ejecutar comandos del sistema y capturar su salida
@@ -107,8 +273,153 @@ char* execute_system_command(const char* command) {
     return result;
 }
 
+// Ejecutar un comando descartando su salida y devolver su código de salida
+// Retorna: 0 si el comando terminó bien, distinto de 0 en cualquier otro caso
+int execute_system_command_status(const char* command) {
+    FILE* pipe = popen(command, "r");
+    if (!pipe) {
+        return -1;
+    }
+
+    char buffer[128];
+    while (fgets(buffer, sizeof(buffer), pipe) != NULL) {
+        // Descartar la salida, solo interesa el código de salida
+    }
+
+    int status = pclose(pipe);
+    if (status == -1 || !WIFEXITED(status)) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+// Escritura privilegiada: pasar el valor por stdin a "sudo tee ruta..." sin
+// shell (execvp con las rutas como argumentos, sin interpretar nada en ellas)
+KnobResult write_sysfs_knob_sudo(const char* const* paths, int cantidad, const char* value) {
+    const char** argv = malloc((cantidad + 3) * sizeof(char*));
+    if (!argv || cantidad <= 0) {
+        free(argv);
+        return KNOB_ERROR;
+    }
+    argv[0] = "sudo";
+    argv[1] = "tee";
+    for (int i = 0; i < cantidad; i++) argv[i + 2] = paths[i];
+    argv[cantidad + 2] = NULL;
+
+    int pipefd[2];
+    if (pipe2(pipefd, O_CLOEXEC) != 0) {
+        free(argv);
+        return KNOB_ERROR;
+    }
+
+    fflush(stdout);  // sudo puede pedir la contraseña: mostrar antes lo pendiente
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(pipefd[0], STDIN_FILENO);
+        int nulo = open("/dev/null", O_WRONLY);
+        if (nulo >= 0) dup2(nulo, STDOUT_FILENO);
+        execvp(argv[0], (char* const*)argv);
+        _exit(127);
+    }
+    free(argv);
+    close(pipefd[0]);
+    if (pid < 0) {
+        close(pipefd[1]);
+        return KNOB_ERROR;
+    }
+
+    dprintf(pipefd[1], "%s\n", value);
+    close(pipefd[1]);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return KNOB_ERROR;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        errno = EACCES;
+        return KNOB_ERROR;
+    }
+    return KNOB_OK_PRIVILEGED;
+}
+
+// Escribir un valor en un atributo de sysfs (intel_pstate, platform_profile, kbd_backlight...)
+// Primero intenta open/write/close directamente; solo si el kernel responde EACCES
+// se recurre a sudo. Cualquier otro error se reporta tal cual, sin reintentar.
+KnobResult write_sysfs_knob(const char* path, const char* value) {
+    KnobResult result = write_sysfs_knob_directo(path, value);
+    if (result == KNOB_ERROR && errno == EACCES) {
+        return write_sysfs_knob_sudo(&path, 1, value);
+    }
+    return result;
+}
+
+KnobResult write_sysfs_knob_directo(const char* path, const char* value) {
+    // O_TRUNC no cambia nada en sysfs y deja bien los árboles falsos (archivos comunes)
+    int fd = open(path, O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (fd < 0) {
+        return KNOB_ERROR;
+    }
+
+    size_t len = strlen(value);
+    ssize_t written = write(fd, value, len);
+    int write_errno = errno;
+    int closed = close(fd); // sysfs puede reportar el error recién al cerrar
+
+    if (written != (ssize_t)len) {
+        errno = write_errno;
+        return KNOB_ERROR;
+    }
+    return closed == 0 ? KNOB_OK : KNOB_ERROR;
+}
+
+// Variante numérica de write_sysfs_knob
+KnobResult write_sysfs_knob_int(const char* path, int value) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%d", value);
+    return write_sysfs_knob(path, buffer);
+}
+
+// Texto corto para mostrar cómo se aplicó un knob
+const char* knob_result_str(KnobResult result) {
+    switch (result) {
+        case KNOB_OK: return "directo";
+        case KNOB_OK_PRIVILEGED: return "sudo";
+        case KNOB_OK_DAEMON: return "glxd";
+        case KNOB_UNCHANGED: return "sin cambios";
+        case KNOB_ERROR: return "error";
+    }
+    return "error";
+}
+
+// Buscar modelo.txt: primero la instalación del sistema y luego junto al ejecutable
+// Usa stat en vez de abrir los archivos; retorna 0 si no se encontró ninguno
+int find_modelo_path(char* buffer, size_t size) {
+    struct stat st;
+    snprintf(buffer, size, "%s", "/usr/local/share/glx/modelo.txt");
+    if (stat(buffer, &st) == 0) return 1;
+
+    char exec_path[512];
+    ssize_t len = readlink("/proc/self/exe", exec_path, sizeof(exec_path) - 1);
+    if (len != -1) {
+        exec_path[len] = '\0';
+        char* last_slash = strrchr(exec_path, '/');
+        if (last_slash) {
+            *last_slash = '\0';
+            const char* relativas[] = { "/../../modelo.txt", "/../modelo.txt" };
+            for (int i = 0; i < 2; i++) {
+                snprintf(buffer, size, "%.400s%s", exec_path, relativas[i]);
+                if (stat(buffer, &st) == 0) return 1;
+            }
+        }
+    }
+
+    snprintf(buffer, size, "%s", "modelo.txt");
+    return stat(buffer, &st) == 0;
+}
+
 // Función para cargar modos GPU desde archivo
-GPU_Mode* load_gpu_modes(const char* filename, int* num_modes) {
+// verbose = 0 evita imprimir cada campo (por ejemplo al compilar la caché)
+GPU_Mode* load_gpu_modes_ex(const char* filename, int* num_modes, int verbose) {
     FILE* file = fopen(filename, "r");
     if (!file) {
         printf("Error: No se pudo abrir el archivo %s\n", filename);
@@ -145,7 +456,7 @@ GPU_Mode* load_gpu_modes(const char* filename, int* num_modes) {
             current_mode->name[sizeof(current_mode->name) - 1] = '\0';
             
             (*num_modes)++;
-            printf("Modo encontrado: %s\n", current_mode->name);
+            if (verbose) printf("Modo encontrado: %s\n", current_mode->name);
         }
         // Buscar configuraciones: "- parametro: valor"
         else if (current_mode && line[0] == '-' && strstr(line, ":")) {
@@ -158,158 +469,131 @@ GPU_Mode* load_gpu_modes(const char* filename, int* num_modes) {
                 char* value = colon + 1;
                 while (*value == ' ') value++; // Saltar espacios después de los dos puntos
                 
-                // Parsear según el parámetro
-                if (strcmp(param_start, "dynamic_boost") == 0) {
-                    current_mode->dynamic_boost = atoi(value);
-                    printf("   Dynamic Boost: %d\n", current_mode->dynamic_boost);
-                }
-                else if (strcmp(param_start, "cpu_max_perf") == 0) {
-                    current_mode->cpu_max_perf = atoi(value);
-                    printf("   CPU Max Performance: %d%%\n", current_mode->cpu_max_perf);
-                }
-                else if (strcmp(param_start, "cpu_min_perf") == 0) {
-                    current_mode->cpu_min_perf = atoi(value);
-                    printf("   CPU Min Performance: %d%%\n", current_mode->cpu_min_perf);
-                }
-                else if (strcmp(param_start, "turbo_boost") == 0) {
-                    current_mode->turbo_boost = atoi(value);
-                    printf("   Turbo Boost: %s\n", current_mode->turbo_boost ? "OFF" : "ON");
-                }
-                else if (strcmp(param_start, "persist_mode") == 0) {
-                    current_mode->persist_mode = atoi(value);
-                    printf("   Persist Mode: %s\n", current_mode->persist_mode ? "ON" : "OFF");
-                }
-                else if (strcmp(param_start, "battery_conservation") == 0) {
-                    current_mode->battery_conservation = atoi(value);
-                    printf("   Battery Conservation: %s\n", current_mode->battery_conservation ? "ON" : "OFF");
-                }
-                else if (strcmp(param_start, "fnlock") == 0) {
-                    current_mode->fnlock = atoi(value);
-                    printf("   FnLock: %s\n", current_mode->fnlock ? "ON" : "OFF");
-                }
-                else if (strcmp(param_start, "rgb_color") == 0) {
+                // Parsear según la tabla de parámetros
+                int id = param_buscar(param_start);
+                const ParamInfo* param = id >= 0 ? &param_tabla[id] : NULL;
+                if (param && param->tipo == PARAM_TIPO_COLOR) {
                     strncpy(current_mode->rgb_color, value, sizeof(current_mode->rgb_color) - 1);
                     current_mode->rgb_color[sizeof(current_mode->rgb_color) - 1] = '\0';
-                    printf("   RGB Color: %s\n", current_mode->rgb_color);
+                    current_mode->definidos |= 1ull << id;
+                    if (verbose) printf("   %s: %s\n", param->etiqueta, current_mode->rgb_color);
+                }
+                else if (param && param->tipo == PARAM_TIPO_ENTERO) {
+                    current_mode->valores[id] = atoi(value);
+                    current_mode->definidos |= 1ull << id;
+                    char texto[16];
+                    if (verbose) printf("   %s: %s\n", param->etiqueta, param_formatear(param, current_mode->valores[id], texto, sizeof(texto)));
                 }
-                else if (strcmp(param_start, "rgb_brightness") == 0) {
-                    current_mode->rgb_brightness = atoi(value);
-                    printf("   RGB Brightness: %d%%\n", current_mode->rgb_brightness);
+                else if (param && param->tipo == PARAM_TIPO_OPCION) {
+                    int indice = param_opcion_buscar(param, value);
+                    if (indice >= 0) {
+                        current_mode->valores[id] = indice;
+                        current_mode->definidos |= 1ull << id;
+                    }
+                    if (verbose) printf("   %s: %s%s\n", param->etiqueta, value, indice >= 0 ? "" : " (no válido, se ignora)");
                 }
             }
         }
     }
     
     fclose(file);
-    printf("Cargados %d modos desde %s\n", *num_modes, filename);
+    if (verbose) printf("Cargados %d modos desde %s\n", *num_modes, filename);
     return modes;
 }
 
+GPU_Mode* load_gpu_modes(const char* filename, int* num_modes) {
+    return load_gpu_modes_ex(filename, num_modes, 1);
+}
+
+int num_modos_integrados(void) {
+    return NUM_MODOS_DEFAULT;
+}
+
+const GPU_Mode* modo_integrado(int indice) {
+    return indice >= 0 && indice < NUM_MODOS_DEFAULT ? &modos_default[indice] : NULL;
+}
+
+const GPU_Mode* buscar_modo_integrado(const char* nombre) {
+    for (int i = 0; i < NUM_MODOS_DEFAULT; i++) {
+        if (strcmp(modos_default[i].name, nombre) == 0) {
+            return &modos_default[i];
+        }
+    }
+    return NULL;
+}
+
+// Perfil de platform_profile asociado a cada color del botón de encendido
+const char* rgb_color_to_profile(const char* color) {
+    if (strcmp(color, "blue") == 0) return "low-power";
+    if (strcmp(color, "white") == 0) return "balanced";
+    if (strcmp(color, "red") == 0) return "performance";
+    return NULL;
+}
+
 // Función para controlar RGB del teclado
 int set_rgb_color(const char* color, int brightness) {
     printf("\033[36m🎨 Configurando RGB: %s con brillo %d%%\033[0m\n", color, brightness);
     
     // El color del botón de encendido está vinculado al platform-profile
     // Cambiamos el perfil para cambiar el color automáticamente
-    char cmd[256];
-    const char* profile = NULL;
+    const char* profile = rgb_color_to_profile(color);
     
     if (strcmp(color, "blue") == 0) {
         printf("   🔵 Aplicando color azul (modo quiet)\n");
-        profile = "low-power";
     }
     else if (strcmp(color, "white") == 0) {
         printf("   ⚪ Aplicando color blanco (modo balanced)\n");
-        profile = "balanced";
     }
     else if (strcmp(color, "red") == 0) {
         printf("   🔴 Aplicando color rojo (modo performance)\n");
-        profile = "performance";
     }
     else {
         printf("   ⚠️  Color no reconocido: %s\n", color);
         return 0;
     }
     
-    // Cambiar platform-profile para cambiar el color del botón de encendido
-    // Intentar primero la ruta moderna (kernel 6.x+)
-    char path[256] = "/sys/firmware/acpi/platform_profile";
-    
-    // Si no existe, intentar la ruta legacy
-    if (access(path, F_OK) == -1) {
-        strcpy(path, "/sys/devices/pci0000:00/0000:00:1f.0/PNP0C09:00/platform-profile/platform-profile-0/profile");
-    }
+    // Cambiar platform-profile (cambia el color del botón de encendido) y ajustar
+    // el brillo del backlight del teclado en un solo lote
+    int max_brightness = 100; // Valor típico para backlight
+    int actual_brightness = (brightness * max_brightness) / 100;
 
-    snprintf(cmd, sizeof(cmd), "echo %s | sudo tee %s", profile, path);
-    
-    char* result = execute_system_command(cmd);
-    if (result) {
-        printf("   🎯 Platform-profile cambiado a '%s' - Color del botón de encendido: %s\n", profile, color);
-        free(result);
+    KnobWrite writes[2];
+    knob_write_init(&writes[0], KNOB_PLATFORM_PROFILE, profile);
+    knob_write_init_int(&writes[1], KNOB_KBD_BACKLIGHT, actual_brightness);
+    knobs_aplicar(writes, 2);
+
+    char error[128];
+    if (writes[0].resultado != KNOB_ERROR) {
+        printf("   🎯 Platform-profile cambiado a '%s' (%s) - Color del botón de encendido: %s\n", profile, knob_result_str(writes[0].resultado), color);
     } else {
-        printf("   ⚠️  Error al cambiar platform-profile\n");
+        printf("   ⚠️  Error al cambiar platform-profile: %s\n", knob_error_str(&writes[0], error, sizeof(error)));
         return 0;
     }
     
-    // Ajustar brillo del backlight del teclado
-    int max_brightness = 100; // Valor típico para backlight
-    
-    // Calcular brillo basado en el porcentaje
-    int actual_brightness = (brightness * max_brightness) / 100;
-    
-    snprintf(cmd, sizeof(cmd), "echo %d | sudo tee /sys/devices/pci0000:00/0000:00:1f.0/PNP0C09:00/VPC2004:00/leds/platform::kbd_backlight/brightness", actual_brightness);
-    
-    result = execute_system_command(cmd);
-    if (result) {
-        printf("   💡 Brillo del teclado ajustado a %d%%\n", brightness);
-        free(result);
+    if (writes[1].resultado != KNOB_ERROR) {
+        printf("   💡 Brillo del teclado ajustado a %d%% (%s)\n", brightness, knob_result_str(writes[1].resultado));
         return 1;
     } else {
-        printf("   ⚠️  Error al ajustar brillo del teclado\n");
+        printf("   ⚠️  Error al ajustar brillo del teclado: %s\n", knob_error_str(&writes[1], error, sizeof(error)));
         return 0;
     }
 }
 
+// Nombre del color del botón de encendido para un platform-profile
+const char* profile_to_color_name(const char* profile) {
+    if (!profile) return "desconocido";
+    if (strcmp(profile, "low-power") == 0 || strcmp(profile, "quiet") == 0) return "azul";
+    if (strcmp(profile, "balanced") == 0) return "blanco";
+    if (strcmp(profile, "performance") == 0) return "rojo";
+    return "desconocido";
+}
+
 // Función para obtener el color actual del botón de encendido
 const char* get_current_power_button_color(void) {
-    // Intentar leer de múltiples ubicaciones posibles
-    const char* paths[] = {
-        "/sys/firmware/acpi/platform_profile",
-        "/sys/devices/pci0000:00/0000:00:1f.0/PNP0C09:00/platform-profile/platform-profile-0/profile"
-    };
-    
-    char* result = NULL;
-    for (int i = 0; i < 2; i++) {
-        if (access(paths[i], R_OK) == 0) {
-            char cmd[512];
-            snprintf(cmd, sizeof(cmd), "cat %s 2>/dev/null", paths[i]);
-            result = execute_system_command(cmd);
-            if (result) break;
-        }
-    }
-    
-    if (!result) {
-        return "desconocido";
-    }
-    
-    // Eliminar salto de línea si existe
-    size_t len = strlen(result);
-    if (len > 0 && result[len-1] == '\n') {
-        result[len-1] = '\0';
-    }
-    
-    // Mapear perfil a color
-    if (strcmp(result, "low-power") == 0 || strcmp(result, "quiet") == 0) {
-        free(result);
-        return "azul";
-    } else if (strcmp(result, "balanced") == 0) {
-        free(result);
-        return "blanco";
-    } else if (strcmp(result, "performance") == 0) {
-        free(result);
-        return "rojo";
-    } else {
-        free(result);
+    // Lectura directa del platform-profile (ruta moderna o legacy)
+    char profile[32];
+    if (!knob_leer_local(KNOB_PLATFORM_PROFILE, profile, sizeof(profile))) {
         return "desconocido";
     }
-}
\ No newline at end of file
+    return profile_to_color_name(profile);
+}
@@ -0,0 +1,176 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "../include/watch.h"
+#include "../include/status.h"
+#include "../include/gpu_telemetry.h"
+
+// nvidia-smi no tiene sentido más rápido que esto y a 100 Hz dominaría el costo
+#define GPU_INTERVALO_MIN_MS 100
+
+// Cada cuántas filas se repite el encabezado
+#define FILAS_POR_ENCABEZADO 40
+
+static volatile sig_atomic_t detener = 0;
+
+static void manejar_senal(int sig) {
+    (void)sig;
+    detener = 1;
+}
+
+static long long timespec_ns(const struct timespec* ts) {
+    return (long long)ts->tv_sec * 1000000000ll + ts->tv_nsec;
+}
+
+static struct timespec ns_timespec(long long ns) {
+    struct timespec ts = { ns / 1000000000ll, ns % 1000000000ll };
+    return ts;
+}
+
+static long long cpu_propio_ns(void) {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return ((long long)uso.ru_utime.tv_sec + uso.ru_stime.tv_sec) * 1000000000ll +
+           ((long long)uso.ru_utime.tv_usec + uso.ru_stime.tv_usec) * 1000ll;
+}
+
+static void imprimir_encabezado(void) {
+    printf("\033[36m%8s %4s %4s %5s %5s %3s %-12s %7s %5s %5s\033[0m\n",
+           "t(s)", "max", "min", "boost", "turbo", "ac", "perfil", "gpu_w", "gpu_c", "mhz");
+}
+
+// Entero o "-" si la fuente no está disponible
+static const char* campo(int valor, char* buffer, size_t size) {
+    if (valor < 0) return "-";
+    snprintf(buffer, size, "%d", valor);
+    return buffer;
+}
+
+static void imprimir_fila(double t, const SystemStatus* s, const GpuSample* gpu) {
+    char max[12], min[12], boost[12], temp[12], reloj[12], potencia[16];    // un int entra en 12
+    const char* turbo = s->no_turbo < 0 ? "-" : (s->no_turbo ? "OFF" : "ON");
+    const char* ac = s->ac_online < 0 ? "-" : (s->ac_online ? "si" : "no");
+    const char* perfil = s->platform_profile[0] ? s->platform_profile : "-";
+
+    if (gpu->valida && gpu->potencia_w >= 0) {
+        snprintf(potencia, sizeof(potencia), "%.2f", gpu->potencia_w);
+    } else {
+        strcpy(potencia, "-");
+    }
+
+    printf("%8.2f %4s %4s %5s %5s %3s %-12s %7s %5s %5s\n",
+           t,
+           campo(s->cpu_max_perf, max, sizeof(max)),
+           campo(s->cpu_min_perf, min, sizeof(min)),
+           campo(s->dynamic_boost, boost, sizeof(boost)),
+           turbo, ac, perfil, potencia,
+           campo(gpu->valida ? gpu->temperatura_c : -1, temp, sizeof(temp)),
+           campo(gpu->valida ? gpu->reloj_mhz : -1, reloj, sizeof(reloj)));
+}
+
+int watch_muestrear(int hz, long muestras, WatchCallback cb, void* ctx, WatchResumen* resumen) {
+    if (hz < 1) hz = 1;
+    if (hz > WATCH_HZ_MAX) hz = WATCH_HZ_MAX;
+    long long periodo_ns = 1000000000ll / hz;
+    memset(resumen, 0, sizeof(*resumen));
+
+    StatusSampler sampler;
+    if (status_sampler_abrir(&sampler) == 0) {
+        printf("\033[31m❌ Error: No se pudo abrir ninguna fuente de sysfs/procfs\033[0m\n");
+        return 1;
+    }
+
+    int intervalo_gpu_ms = (int)(periodo_ns / 1000000);
+    if (intervalo_gpu_ms < GPU_INTERVALO_MIN_MS) intervalo_gpu_ms = GPU_INTERVALO_MIN_MS;
+    gpu_telemetry_iniciar(intervalo_gpu_ms);
+
+    // Sin SA_RESTART: Ctrl+C corta el clock_nanosleep en curso
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = manejar_senal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    detener = 0;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    long long inicio_ns = timespec_ns(&ts);
+    long long proxima_ns = inicio_ns;
+    long long cpu_inicio_ns = cpu_propio_ns();
+    int error = 0;
+
+    while (!detener && (muestras <= 0 || resumen->tomadas < muestras)) {
+        SystemStatus status;
+        GpuSample gpu;
+        status_sampler_leer(&sampler, &status);
+        gpu_telemetry_ultima(&gpu);
+
+        if (cb((proxima_ns - inicio_ns) / 1000000, &status, &gpu, ctx) != 0) {
+            error = 1;
+            break;
+        }
+        resumen->tomadas++;
+
+        // Plazos absolutos: el error no se acumula; si una muestra se atrasó
+        // más de un período se saltan los plazos perdidos en vez de ráfagas
+        proxima_ns += periodo_ns;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        long long ahora_ns = timespec_ns(&ts);
+        if (ahora_ns - proxima_ns > periodo_ns) {
+            long long perdidos = (ahora_ns - proxima_ns) / periodo_ns;
+            resumen->saltadas += perdidos;
+            proxima_ns += perdidos * periodo_ns;
+        }
+
+        if (muestras > 0 && resumen->tomadas >= muestras) break;
+        struct timespec objetivo = ns_timespec(proxima_ns);
+        while (!detener && clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &objetivo, NULL) == EINTR) {
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    resumen->transcurrido_s = (timespec_ns(&ts) - inicio_ns) / 1e9;
+    resumen->cpu_s = (cpu_propio_ns() - cpu_inicio_ns) / 1e9;
+
+    gpu_telemetry_detener();
+    status_sampler_cerrar(&sampler);
+    return error;
+}
+
+void watch_imprimir_resumen(const WatchResumen* resumen) {
+    printf("\033[36m%ld muestras en %.2f s", resumen->tomadas, resumen->transcurrido_s);
+    if (resumen->saltadas > 0) printf(", %ld plazos perdidos", resumen->saltadas);
+    if (resumen->transcurrido_s > 0) {
+        printf(", CPU de gx: %.3f%% de un núcleo (%.1f µs por muestra)",
+               100.0 * resumen->cpu_s / resumen->transcurrido_s,
+               resumen->tomadas > 0 ? resumen->cpu_s * 1e6 / resumen->tomadas : 0.0);
+    }
+    printf("\033[0m\n");
+}
+
+static int mostrar_muestra(long long t_ms, const SystemStatus* status, const GpuSample* gpu, void* ctx) {
+    long* filas = ctx;
+    if (*filas % FILAS_POR_ENCABEZADO == 0) imprimir_encabezado();
+    imprimir_fila(t_ms / 1000.0, status, gpu);
+    fflush(stdout);
+    (*filas)++;
+    return 0;
+}
+
+int watch_ejecutar(int hz, long muestras) {
+    printf("\033[36m👀 Muestreando a %d Hz (Ctrl+C para terminar)\033[0m\n", hz);
+
+    long filas = 0;
+    WatchResumen resumen;
+    if (watch_muestrear(hz, muestras, mostrar_muestra, &filas, &resumen) != 0 && resumen.tomadas == 0) {
+        return 1;
+    }
+    watch_imprimir_resumen(&resumen);
+    return 0;
+}
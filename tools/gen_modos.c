@@ -0,0 +1,137 @@
+// Generador de los modos integrados (lo corre make antes de compilar gx)
+// Lee modelo.txt con las mismas reglas que load_gpu_modes y escribe
+// build/modos_default.h por stdout: una tabla static const GPU_Mode que gx
+// usa sin abrir ni parsear archivos. A diferencia de load_gpu_modes, un
+// parámetro desconocido o un valor fuera de rango cortan el build.
+// Se enlaza con src/params.c para usar el mismo registro de parámetros.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/params.h"
+
+// Máximo de modos, el mismo límite que load_gpu_modes
+#define MODOS_MAX 10
+
+#define NOMBRE_CARACTERES "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-"
+
+static const char* colores_validos[] = { "blue", "white", "red" };
+
+typedef struct {
+    char nombre[50];
+    int definido[PARAM_COUNT];
+    int valores[PARAM_COUNT];
+    char color[20];
+} Modo;
+
+static int color_valido(const char* color) {
+    for (size_t i = 0; i < sizeof(colores_validos) / sizeof(colores_validos[0]); i++) {
+        if (strcmp(colores_validos[i], color) == 0) return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    const char* ruta = argc > 1 ? argv[1] : "modelo.txt";
+    FILE* archivo = fopen(ruta, "r");
+    if (!archivo) {
+        fprintf(stderr, "gen_modos: no se pudo abrir %s\n", ruta);
+        return 1;
+    }
+
+    static Modo modos[MODOS_MAX];
+    int num_modos = 0;
+    Modo* actual = NULL;
+    char linea[256];
+    int numero = 0;
+    int errores = 0;
+
+    while (fgets(linea, sizeof(linea), archivo)) {
+        numero++;
+        linea[strcspn(linea, "\n")] = '\0';
+        if (linea[0] == '\0' || linea[0] == '#') continue;
+
+        if (strncmp(linea, "mode:", 5) == 0) {
+            if (num_modos >= MODOS_MAX) {
+                fprintf(stderr, "%s:%d: más de %d modos\n", ruta, numero, MODOS_MAX);
+                errores++;
+                break;
+            }
+            actual = &modos[num_modos++];
+            const char* nombre = linea + 5;
+            while (*nombre == ' ') nombre++;
+            snprintf(actual->nombre, sizeof(actual->nombre), "%s", nombre);
+            // El nombre va entre comillas en el header generado
+            if (!actual->nombre[0] || strspn(actual->nombre, NOMBRE_CARACTERES) != strlen(actual->nombre)) {
+                fprintf(stderr, "%s:%d: nombre de modo inválido: '%s'\n", ruta, numero, actual->nombre);
+                errores++;
+            }
+            continue;
+        }
+
+        if (!actual || linea[0] != '-' || !strchr(linea, ':')) continue;
+        char* param = linea + 1;
+        while (*param == ' ') param++;
+        char* valor = strchr(param, ':');
+        *valor++ = '\0';
+        while (*valor == ' ') valor++;
+
+        int id = param_buscar(param);
+        const ParamInfo* info = id >= 0 ? &param_tabla[id] : NULL;
+        if (!info || info->tipo == PARAM_TIPO_MODO) {
+            fprintf(stderr, "%s:%d: parámetro desconocido en el modo '%s': %s\n", ruta, numero, actual->nombre, param);
+            errores++;
+        } else if (info->tipo == PARAM_TIPO_COLOR) {
+            if (!color_valido(valor)) {
+                fprintf(stderr, "%s:%d: color inválido en el modo '%s': %s\n", ruta, numero, actual->nombre, valor);
+                errores++;
+            }
+            snprintf(actual->color, sizeof(actual->color), "%s", valor);
+            actual->definido[id] = 1;
+        } else if (info->tipo == PARAM_TIPO_OPCION) {
+            int indice = param_opcion_buscar(info, valor);
+            if (indice < 0) {
+                fprintf(stderr, "%s:%d: valor inválido para '%s' en el modo '%s': %s\n", ruta, numero, param, actual->nombre, valor);
+                errores++;
+            }
+            actual->valores[id] = indice;
+            actual->definido[id] = 1;
+        } else {
+            char* fin;
+            long n = strtol(valor, &fin, 10);
+            if (fin == valor || *fin != '\0' || n < info->min || n > info->max) {
+                fprintf(stderr, "%s:%d: '%s' fuera de rango (%d-%d) en el modo '%s': %s\n",
+                        ruta, numero, param, info->min, info->max, actual->nombre, valor);
+                errores++;
+            }
+            actual->valores[id] = (int)n;
+            actual->definido[id] = 1;
+        }
+    }
+    fclose(archivo);
+
+    if (errores > 0) return 1;
+    if (num_modos == 0) {
+        fprintf(stderr, "gen_modos: %s no define ningún modo\n", ruta);
+        return 1;
+    }
+
+    printf("// Generado por tools/gen_modos.c desde %s. No editar.\n", ruta);
+    printf("#ifndef MODOS_DEFAULT_H\n#define MODOS_DEFAULT_H\n\n");
+    printf("#define NUM_MODOS_DEFAULT %d\n\n", num_modos);
+    printf("static const GPU_Mode modos_default[NUM_MODOS_DEFAULT] = {\n");
+    for (int m = 0; m < num_modos; m++) {
+        printf("    { \"%s\", {", modos[m].nombre);
+        int primero = 1;
+        unsigned long long definidos = 0;
+        for (int i = 0; i < PARAM_COUNT; i++) {
+            if (!modos[m].definido[i]) continue;
+            definidos |= 1ull << i;
+            if (param_tabla[i].tipo == PARAM_TIPO_COLOR) continue;
+            printf("%s\n        [PARAM_%s] = %d", primero ? "" : ",", param_tabla[i].nombre, modos[m].valores[i]);
+            primero = 0;
+        }
+        printf("\n    }, \"%s\", 0x%llxull },\n", modos[m].color, definidos);
+    }
+    printf("};\n\n#endif // MODOS_DEFAULT_H\n");
+    return 0;
+}
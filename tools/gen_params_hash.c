@@ -0,0 +1,68 @@
+// Generador del hash perfecto de params.def (lo corre make antes de compilar gx)
+// Busca el tamaño de tabla y la semilla más chicos sin colisiones y escribe
+// build/params_hash.h por stdout, junto con una huella de la tabla entera.
+#include <stdio.h>
+#include <string.h>
+#include "../include/params.h"
+
+static const char* nombres[PARAM_COUNT] = {
+#define PARAM(nombre, tipo, min, max, formato, etiqueta, knob) #nombre,
+#include "../include/params.def"
+#undef PARAM
+};
+
+// Cada fila tal cual, sin la etiqueta (que solo se muestra): de acá sale la
+// huella que guardan los archivos que dependen de los ParamId
+static const char* filas[PARAM_COUNT] = {
+#define PARAM(nombre, tipo, min, max, formato, etiqueta, knob) #nombre " " #tipo " " #min " " #max " " #formato " " #knob,
+#include "../include/params.def"
+#undef PARAM
+};
+
+// FNV-1a de 64 bits de todas las filas en orden
+static uint64_t huella_tabla(void) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        for (const char* p = filas[i]; ; p++) {
+            hash ^= (unsigned char)*p;
+            hash *= 0x100000001b3ull;
+            if (!*p) break;
+        }
+    }
+    return hash;
+}
+
+#define SEMILLAS_MAX 1000000u
+
+int main(void) {
+    int slots[1024];
+
+    for (uint32_t tam = 1; tam <= 1024; tam *= 2) {
+        if (tam < PARAM_COUNT) continue;
+        for (uint32_t semilla = 0; semilla < SEMILLAS_MAX; semilla++) {
+            memset(slots, -1, sizeof(slots));
+            int colision = 0;
+            for (int i = 0; i < PARAM_COUNT && !colision; i++) {
+                uint32_t slot = param_hash(nombres[i], semilla) & (tam - 1);
+                if (slots[slot] >= 0) colision = 1;
+                slots[slot] = i;
+            }
+            if (colision) continue;
+
+            printf("// Generado por tools/gen_params_hash.c desde include/params.def. No editar.\n");
+            printf("#ifndef PARAMS_HASH_H\n#define PARAMS_HASH_H\n\n");
+            printf("#define PARAM_HASH_SEMILLA %uu\n", semilla);
+            printf("#define PARAM_HASH_MASCARA %uu\n", tam - 1);
+            printf("#define PARAM_TABLA_HUELLA 0x%016llxull\n\n", (unsigned long long)huella_tabla());
+            printf("static const int16_t param_hash_slots[%u] = {", tam);
+            for (uint32_t s = 0; s < tam; s++) {
+                printf("%s%d", s == 0 ? "\n    " : s % 16 ? ", " : ",\n    ", slots[s]);
+            }
+            printf("\n};\n\n#endif // PARAMS_HASH_H\n");
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "gen_params_hash: no se encontró un hash sin colisiones\n");
+    return 1;
+}
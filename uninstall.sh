@@ -8,9 +8,18 @@ if [ ! -f "/usr/local/bin/gx" ]; then
     exit 0
 fi
 
+# Detener y remover el daemon glxd
+if command -v systemctl >/dev/null 2>&1 && [ -f "/etc/systemd/system/glxd.service" ]; then
+    echo "Deteniendo daemon glxd..."
+    sudo systemctl disable --now glxd 2>/dev/null
+    sudo rm -f /etc/systemd/system/glxd.service
+    sudo systemctl daemon-reload
+fi
+
 # Remover el ejecutable
 echo "Removiendo ejecutable..."
 sudo rm -f /usr/local/bin/gx
+sudo rm -f /usr/local/bin/glxd
 
 # Remover archivos de configuración
 echo "Removiendo archivos de configuración..."